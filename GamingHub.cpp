@@ -17,6 +17,7 @@
 ********************************************************************************************/
 
 #include "raylib.h"
+#include "rlgl.h"
 #include <string>
 #include <vector>
 #include <cstdlib>
@@ -24,6 +25,41 @@
 #include <cmath>
 #include <fstream>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <type_traits>
+#include <new>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+// Platform headers for memory-mapped files and UDP netplay. The NO* switches
+// keep windows.h from redeclaring raylib names (Rectangle, CloseWindow,
+// DrawText, ...); winsock2.h has to come before it.
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #define NOGDI
+    #define NOUSER
+    #include <winsock2.h>
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -61,954 +97,9282 @@ namespace Colors {
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
-// UTILITY FUNCTIONS
+// MEMORY-MAPPED FILES
 // ═══════════════════════════════════════════════════════════════════════════
 
-// Draw text centered horizontally
-void DrawTextCentered(const char* text, int y, int fontSize, Color color) {
-    int width = MeasureText(text, fontSize);
-    DrawText(text, (SCREEN_WIDTH - width) / 2, y, fontSize, color);
-}
-
-// Draw a rounded button and return true if clicked
-bool DrawButton(Rectangle rect, const char* text, Color bgColor, Color hoverColor, int fontSize = 24) {
-    Vector2 mouse = GetMousePosition();
-    bool hover = CheckCollisionPointRec(mouse, rect);
-    bool clicked = hover && IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
-    
-    Color color = hover ? hoverColor : bgColor;
-    DrawRectangleRounded(rect, 0.3f, 8, color);
-    DrawRectangleRoundedLines(rect, 0.3f, 8, 2, WHITE);
-    
-    int textWidth = MeasureText(text, fontSize);
-    DrawText(text, rect.x + (rect.width - textWidth) / 2, 
-             rect.y + (rect.height - fontSize) / 2, fontSize, WHITE);
-    
-    return clicked;
-}
+// Read-only view of a whole file, mapped instead of copied into the heap
+class MappedFile {
+private:
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int fd = -1;
+#endif
+    const unsigned char* bytes = nullptr;
+    size_t length = 0;
 
-// Draw decorative animated background
-void DrawAnimatedBackground(float time) {
-    ClearBackground(Colors::BACKGROUND);
-    
-    // Draw floating particles
-    for (int i = 0; i < 50; i++) {
-        float x = (float)((i * 73) % SCREEN_WIDTH);
-        float y = (float)(((int)(time * 20 + i * 50) % SCREEN_HEIGHT));
-        float size = 2 + (i % 3);
-        unsigned char alpha = 50 + (i % 100);
-        DrawCircle(x, y, size, (Color){100, 149, 237, alpha});
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { Close(); }
+
+    bool Open(const char* path) {
+        Close();
+#if defined(_WIN32)
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) { Close(); return false; }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) { Close(); return false; }
+        bytes = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        length = (size_t)fileSize.QuadPart;
+#else
+        fd = open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { Close(); return false; }
+        void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        bytes = (view == MAP_FAILED) ? nullptr : (const unsigned char*)view;
+        length = (size_t)st.st_size;
+#endif
+        if (bytes == nullptr) { Close(); return false; }
+        return true;
     }
-}
 
-// ═══════════════════════════════════════════════════════════════════════════
-// FORWARD DECLARATIONS
-// ═══════════════════════════════════════════════════════════════════════════
+    void Close() {
+#if defined(_WIN32)
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes) munmap((void*)bytes, length);
+        if (fd >= 0) close(fd);
+        fd = -1;
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
 
-class TicTacToeGame;
-class SpaceSurvivorGame;
-class BreakTheCodeGame;
-class ZombieLandGame;
-class SwapCardsGame;
+    const unsigned char* Data() const { return bytes; }
+    size_t Size() const { return length; }
+};
 
 // ═══════════════════════════════════════════════════════════════════════════
-// TIC-TAC-TOE GAME CLASS
+// JOB SYSTEM
 // ═══════════════════════════════════════════════════════════════════════════
 
-class TicTacToeGame {
+// Work-stealing scheduler shared by everything that wants more than one core.
+// Every thread that submits work gets its own Chase-Lev deque: the owner pushes
+// and pops at the bottom (newest first, still warm in its cache) and idle
+// threads steal the oldest job from the top of someone else's. Workers are
+// hardware threads minus one; the thread that waits for a job runs jobs itself
+// until it is done, so nested ParallelFor() calls and waits inside jobs never
+// deadlock, and with no workers everything simply runs inline.
+//
+// Jobs come from a per-thread ring that is allocated by the thread's first
+// Create(), so threads that only steal cost no memory and scheduling never
+// touches the heap after warm-up. A job counts as
+// finished once it and every child created under it have run; dependents
+// registered with AddDependency() are queued at that moment.
+
+const int JOB_DEQUE_SIZE = 4096;           // Power of two
+const int JOB_RING_SIZE = 4096;            // Jobs a thread may have in flight
+const int JOB_MAX_DEPENDENTS = 6;
+const int JOB_MAX_QUEUES = 64;             // Workers plus threads that submit
+const int JOB_MAX_SYSTEMS = 2;             // jobs and searchJobs
+
+struct Job {
+    void (*run)(const Job&);               // Null for pure grouping jobs
+    const void* data;                      // Usually the caller's lambda
+    int begin, end;                        // Range for ParallelFor()
+    Job* parent;
+    atomic<int> unfinished;                // Itself plus unfinished children
+    atomic<int> prerequisites;             // Plus one until Submit()
+    Job* dependents[JOB_MAX_DEPENDENTS];
+    int dependentCount;
+};
+
+class JobDeque {
 private:
-    char board[9];
-    char currentPlayer;
-    bool gameOver;
-    char winner;
-    float cellSize;
-    float offsetX, offsetY;
-    float animTime;
+    alignas(64) atomic<long long> top{0};
+    alignas(64) atomic<long long> bottom{0};
+    atomic<Job*> items[JOB_DEQUE_SIZE];
 
 public:
-    void Init() {
-        for (int i = 0; i < 9; i++) board[i] = ' ';
-        currentPlayer = 'X';
-        gameOver = false;
-        winner = ' ';
-        cellSize = 120;
-        offsetX = (SCREEN_WIDTH - cellSize * 3) / 2;
-        offsetY = 200;
-        animTime = 0;
+    // Owner only
+    bool Push(Job* job) {
+        long long b = bottom.load(memory_order_relaxed);
+        long long t = top.load(memory_order_acquire);
+        if (b - t >= JOB_DEQUE_SIZE) return false;
+        items[b & (JOB_DEQUE_SIZE - 1)].store(job, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        bottom.store(b + 1, memory_order_relaxed);
+        return true;
     }
 
-    bool CheckWin(char symbol) {
-        int wins[8][3] = {{0,1,2},{3,4,5},{6,7,8},{0,3,6},{1,4,7},{2,5,8},{0,4,8},{2,4,6}};
-        for (int i = 0; i < 8; i++) {
-            if (board[wins[i][0]] == symbol && board[wins[i][1]] == symbol && board[wins[i][2]] == symbol)
-                return true;
+    // Owner only
+    Job* Pop() {
+        long long b = bottom.load(memory_order_relaxed) - 1;
+        bottom.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        long long t = top.load(memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, memory_order_relaxed);
+            return nullptr;
         }
-        return false;
+        Job* job = items[b & (JOB_DEQUE_SIZE - 1)].load(memory_order_relaxed);
+        if (t == b) {
+            // Last item: race the thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) job = nullptr;
+            bottom.store(b + 1, memory_order_relaxed);
+        }
+        return job;
     }
 
-    bool IsBoardFull() {
-        for (int i = 0; i < 9; i++) if (board[i] == ' ') return false;
-        return true;
+    // Any thread
+    Job* Steal() {
+        long long t = top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        long long b = bottom.load(memory_order_acquire);
+        if (t >= b) return nullptr;
+        Job* job = items[t & (JOB_DEQUE_SIZE - 1)].load(memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) return nullptr;
+        return job;
     }
 
-    bool Update() {  // Returns true if should go back to menu
-        animTime += GetFrameTime();
+    bool Empty() const {
+        return bottom.load(memory_order_relaxed) <= top.load(memory_order_relaxed);
+    }
+};
 
-        if (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_M)) return true;
+class JobSystem {
+private:
+    JobDeque queues[JOB_MAX_QUEUES];
+    vector<thread> workers;
+    atomic<int> queueCount{0};
+    atomic<unsigned> generation{0};        // Bumped by Start() so threads re-register
+    atomic<bool> running{false};
+    atomic<int> sleeping{0};
+    mutex sleepLock;
+    condition_variable wake;
+
+    struct ThreadSlot {
+        int queue = -1;
+        unsigned generation = 0;
+        uint32_t rng = 0;
+        unsigned nextJob = 0;
+        unique_ptr<Job[]> ring;
+    };
 
-        if (!gameOver && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            Vector2 mouse = GetMousePosition();
-            int col = (int)((mouse.x - offsetX) / cellSize);
-            int row = (int)((mouse.y - offsetY) / cellSize);
-
-            if (col >= 0 && col < 3 && row >= 0 && row < 3) {
-                int idx = row * 3 + col;
-                if (board[idx] == ' ') {
-                    board[idx] = currentPlayer;
-
-                    if (CheckWin(currentPlayer)) {
-                        gameOver = true;
-                        winner = currentPlayer;
-                    } else if (IsBoardFull()) {
-                        gameOver = true;
-                        winner = 'D';  // Draw
-                    } else {
-                        currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
-                    }
-                }
-            }
+    int id;                                // This system's slot in every thread
+
+    ThreadSlot& Slot() const {
+        thread_local ThreadSlot slots[JOB_MAX_SYSTEMS];
+        return slots[id];
+    }
+
+    // Queue owned by the calling thread, or -1 when they have all been taken
+    int OwnQueue() {
+        ThreadSlot& slot = Slot();
+        unsigned gen = generation.load(memory_order_acquire);
+        if (slot.generation != gen) {
+            slot.generation = gen;
+            slot.queue = -1;
+            int index = queueCount.load(memory_order_relaxed);
+            while (index < JOB_MAX_QUEUES &&
+                   !queueCount.compare_exchange_weak(index, index + 1, memory_order_acq_rel)) {}
+            if (index < JOB_MAX_QUEUES) slot.queue = index;
+            slot.rng = 0x9E3779B9u ^ (uint32_t)(index * 2654435761u);
         }
+        return slot.queue;
+    }
 
-        if (gameOver && IsKeyPressed(KEY_SPACE)) Init();
+    Job* FindJob() {
+        int own = OwnQueue();
+        if (own >= 0) {
+            if (Job* job = queues[own].Pop()) return job;
+        }
+        int count = min(queueCount.load(memory_order_acquire), JOB_MAX_QUEUES);
+        if (count == 0) return nullptr;
+        uint32_t& rng = Slot().rng;
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        int start = (int)(rng % (uint32_t)count);
+        for (int i = 0; i < count; i++) {
+            int victim = (start + i) % count;
+            if (victim == own) continue;
+            if (Job* job = queues[victim].Steal()) return job;
+        }
+        return nullptr;
+    }
 
-        return false;
+    void Execute(Job* job) {
+        if (job->run) job->run(*job);
+        Finish(job);
     }
 
-    void Draw() {
-        DrawAnimatedBackground(animTime);
+    void Finish(Job* job) {
+        // Copy what is needed first: once the count reaches zero the owner may
+        // recycle the slot
+        Job* parent = job->parent;
+        Job* dependents[JOB_MAX_DEPENDENTS];
+        int dependentCount = job->dependentCount;
+        for (int i = 0; i < dependentCount; i++) dependents[i] = job->dependents[i];
+        if (job->unfinished.fetch_sub(1, memory_order_acq_rel) != 1) return;
+        for (int i = 0; i < dependentCount; i++) Release(dependents[i]);
+        if (parent) Finish(parent);
+    }
 
-        // Title
-        DrawTextCentered("TIC-TAC-TOE", 50, 50, Colors::ACCENT);
-        DrawTextCentered("2-Player Game", 110, 24, Colors::TEXT_DIM);
+    void Release(Job* job) {
+        if (job->prerequisites.fetch_sub(1, memory_order_acq_rel) != 1) return;
+        int own = OwnQueue();
+        if (own < 0 || !queues[own].Push(job)) {
+            Execute(job);
+            return;
+        }
+        if (sleeping.load(memory_order_acquire) > 0) wake.notify_one();
+    }
 
-        // Draw grid
-        for (int i = 0; i <= 3; i++) {
-            // Vertical lines
-            DrawLineEx({offsetX + i * cellSize, offsetY},
-                       {offsetX + i * cellSize, offsetY + 3 * cellSize}, 4, Colors::PRIMARY);
-            // Horizontal lines
-            DrawLineEx({offsetX, offsetY + i * cellSize},
-                       {offsetX + 3 * cellSize, offsetY + i * cellSize}, 4, Colors::PRIMARY);
+    void WorkerLoop() {
+        int idle = 0;
+        while (running.load(memory_order_acquire)) {
+            if (Job* job = FindJob()) {
+                Execute(job);
+                idle = 0;
+                continue;
+            }
+            if (++idle < 64) {
+                this_thread::yield();
+                continue;
+            }
+            // Timed so a wake-up that races with going to sleep costs at most 1 ms
+            unique_lock<mutex> lock(sleepLock);
+            sleeping++;
+            wake.wait_for(lock, chrono::milliseconds(1));
+            sleeping--;
+            idle = 0;
         }
+    }
+
+public:
+    // Every system needs its own id below JOB_MAX_SYSTEMS
+    explicit JobSystem(int systemId) : id(systemId) {}
+    ~JobSystem() { Stop(); }
+
+    // workerCount < 0 picks hardware threads minus one (the caller is the other)
+    void Start(int workerCount = -1) {
+        Stop();
+        if (workerCount < 0) workerCount = (int)thread::hardware_concurrency() - 1;
+        workerCount = min(max(workerCount, 0), JOB_MAX_QUEUES / 2);
+        queueCount = 0;
+        generation++;
+        running = true;
+        workers.reserve(workerCount);
+        for (int i = 0; i < workerCount; i++) workers.emplace_back(&JobSystem::WorkerLoop, this);
+    }
 
-        // Draw X's and O's
-        for (int i = 0; i < 9; i++) {
-            int row = i / 3, col = i % 3;
-            float cx = offsetX + col * cellSize + cellSize / 2;
-            float cy = offsetY + row * cellSize + cellSize / 2;
+    // Every submitted job must have been waited for
+    void Stop() {
+        running = false;
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+        workers.clear();
+    }
 
-            if (board[i] == 'X') {
-                float s = 35;
-                DrawLineEx({cx - s, cy - s}, {cx + s, cy + s}, 8, Colors::SUCCESS);
-                DrawLineEx({cx + s, cy - s}, {cx - s, cy + s}, 8, Colors::SUCCESS);
-            } else if (board[i] == 'O') {
-                DrawCircleLines(cx, cy, 40, Colors::DANGER);
-                DrawCircleLines(cx, cy, 38, Colors::DANGER);
-                DrawCircleLines(cx, cy, 36, Colors::DANGER);
+    // Threads that run jobs, counting the caller
+    int Threads() const { return (int)workers.size() + 1; }
+
+    // New job from the calling thread's ring. With a parent, the parent does
+    // not finish until this job has. data must outlive the job.
+    Job* Create(void (*run)(const Job&), const void* data = nullptr, Job* parent = nullptr) {
+        ThreadSlot& slot = Slot();
+        if (!slot.ring) slot.ring.reset(new Job[JOB_RING_SIZE]());
+        Job* job = &slot.ring[slot.nextJob++ & (JOB_RING_SIZE - 1)];
+        // Skip slots still in flight (a long-lived parent, say); if the whole
+        // ring is busy, help run jobs until one frees up
+        for (int tries = 1; job->unfinished.load(memory_order_acquire) > 0; tries++) {
+            if (tries % JOB_RING_SIZE == 0) {
+                if (Job* other = FindJob()) Execute(other);
+                else this_thread::yield();
             }
+            job = &slot.ring[slot.nextJob++ & (JOB_RING_SIZE - 1)];
         }
+        job->run = run;
+        job->data = data;
+        job->begin = job->end = 0;
+        job->parent = parent;
+        job->dependentCount = 0;
+        job->prerequisites.store(1, memory_order_relaxed);
+        job->unfinished.store(1, memory_order_release);
+        if (parent) parent->unfinished.fetch_add(1, memory_order_acq_rel);
+        return job;
+    }
 
-        // Current player or result
-        if (!gameOver) {
-            const char* playerText = (currentPlayer == 'X') ? "Player X's Turn" : "Player O's Turn";
-            Color playerColor = (currentPlayer == 'X') ? Colors::SUCCESS : Colors::DANGER;
-            DrawTextCentered(playerText, 580, 30, playerColor);
-        } else {
-            if (winner == 'D') {
-                DrawTextCentered("IT'S A DRAW!", 560, 40, Colors::ACCENT);
-            } else {
-                const char* winText = (winner == 'X') ? "PLAYER X WINS!" : "PLAYER O WINS!";
-                Color winColor = (winner == 'X') ? Colors::SUCCESS : Colors::DANGER;
-                DrawTextCentered(winText, 560, 40, winColor);
-            }
-            DrawTextCentered("Press SPACE to play again", 610, 20, Colors::TEXT_DIM);
+    // Job that calls fn(); fn must outlive it
+    template <typename Fn>
+    Job* CreateTask(const Fn& fn, Job* parent = nullptr) {
+        return Create([](const Job& job) { (*(const Fn*)job.data)(); }, &fn, parent);
+    }
+
+    // job runs only after prerequisite has finished. Both must be created and
+    // not yet submitted. False when prerequisite has no room for more.
+    bool AddDependency(Job* job, Job* prerequisite) {
+        if (prerequisite->dependentCount >= JOB_MAX_DEPENDENTS) return false;
+        prerequisite->dependents[prerequisite->dependentCount++] = job;
+        job->prerequisites.fetch_add(1, memory_order_relaxed);
+        return true;
+    }
+
+    // Hands the job to the scheduler; it runs once its prerequisites are done
+    void Submit(Job* job) {
+        if (workers.empty() && job->prerequisites.load(memory_order_relaxed) == 1) {
+            job->prerequisites.store(0, memory_order_relaxed);
+            Execute(job);
+            return;
+        }
+        Release(job);
+    }
+
+    bool Done(const Job* job) const { return job->unfinished.load(memory_order_acquire) == 0; }
+
+    // Runs other jobs until this one has finished
+    void Wait(const Job* job) {
+        while (!Done(job)) {
+            if (Job* other = FindJob()) Execute(other);
+            else this_thread::yield();
         }
+    }
 
-        // Instructions
-        DrawText("Press M or ESC to return to menu", 20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+    // Calls fn(begin, end) over [0, count) in ranges of at least grain items,
+    // spread over every thread, and returns when all have run. Ranges are
+    // contiguous and ascending, but which thread runs which is not fixed.
+    template <typename Fn>
+    void ParallelFor(int count, int grain, const Fn& fn) {
+        if (count <= 0) return;
+        grain = max(grain, 1);
+        int ranges = min((count + grain - 1) / grain, Threads() * 4);
+        if (ranges <= 1 || workers.empty()) {
+            fn(0, count);
+            return;
+        }
+        Job* root = Create(nullptr);
+        auto run = [](const Job& job) { (*(const Fn*)job.data)(job.begin, job.end); };
+        for (int r = 0; r < ranges; r++) {
+            Job* job = Create(run, &fn, root);
+            job->begin = (int)((long long)count * r / ranges);
+            job->end = (int)((long long)count * (r + 1) / ranges);
+            Submit(job);
+        }
+        Submit(root);
+        Wait(root);
     }
 };
 
+JobSystem jobs(0);
+
+// Computer player searches run for hundreds of milliseconds, so they get
+// their own workers and deques; a frame-critical Wait() on jobs can never
+// pick one up.
+JobSystem searchJobs(1);
+
 // ═══════════════════════════════════════════════════════════════════════════
-// SPACE SURVIVOR GAME CLASS
+// SOFTWARE RASTERIZER
 // ═══════════════════════════════════════════════════════════════════════════
 
-class SpaceSurvivorGame {
-private:
-    struct Asteroid {
-        float x, y;
-        float speed;
-        float size;
-    };
+// CPU implementation of the primitives the games draw, used when there is no
+// GPU (headless screenshots, golden images, replay rendering). Primitives are
+// recorded during the frame and rasterized tile by tile on the job system in
+// Finish(). Every tile replays the list in order, so the image is the same for
+// any thread count. Pixels are sampled at their centres without antialiasing,
+// except SDF text which gets the same one-pixel edge ramp as the GPU shader.
 
-    float playerX;
-    float playerY;
-    int score;
-    bool gameOver;
-    vector<Asteroid> asteroids;
-    float animTime;
-    vector<pair<float, float>> stars;
+const int SOFT_TILE_SIZE = 64;
 
-public:
-    void Init() {
-        playerX = SCREEN_WIDTH / 2;
-        playerY = SCREEN_HEIGHT - 80;
-        score = 0;
-        gameOver = false;
-        animTime = 0;
-        asteroids.clear();
+struct SoftImageView {
+    const unsigned char* pixels;   // Top row first
+    int width, height;
+    int channels;                  // 4 = RGBA8, 2 = GRAY_ALPHA (SDF atlas)
+};
 
-        // Create initial asteroids
-        for (int i = 0; i < 8; i++) {
-            Asteroid a;
-            a.x = rand() % SCREEN_WIDTH;
-            a.y = -(rand() % 300);
-            a.speed = 3 + (rand() % 4);
-            a.size = 15 + (rand() % 20);
-            asteroids.push_back(a);
-        }
+enum SoftCommandType : unsigned char {
+    SOFT_FILL_RECT,
+    SOFT_ROUNDED_RECT,
+    SOFT_ROUNDED_RING,
+    SOFT_CIRCLE,
+    SOFT_RING,
+    SOFT_POLYGON,
+    SOFT_IMAGE,
+    SOFT_SDF_GLYPH
+};
 
-        // Create stars
-        stars.clear();
-        for (int i = 0; i < 100; i++) {
-            stars.push_back({(float)(rand() % SCREEN_WIDTH), (float)(rand() % SCREEN_HEIGHT)});
-        }
+struct SoftCommand {
+    SoftCommandType type;
+    bool wrap;                     // SOFT_IMAGE: repeat the source instead of clamping
+    int vertexCount;               // SOFT_POLYGON
+    Color color;
+    int minX, minY, maxX, maxY;    // Pixel bounds, clipped to the canvas (max exclusive)
+    float p[8];                    // Shape parameters, see the recording functions
+    Rectangle source;
+    SoftImageView image;
+};
+
+// dst = (src * a + dst * (255 - a)) / 255, rounded. Used by both the scalar and
+// the SIMD paths so they produce identical bytes.
+inline unsigned char SoftBlend(int src, int dst, int a) {
+    int t = src * a + dst * (255 - a) + 128;
+    return (unsigned char)((t + (t >> 8)) >> 8);
+}
+
+inline void SoftBlendPixel(unsigned char* px, Color c, int a) {
+    if (a <= 0) return;
+    px[0] = SoftBlend(c.r, px[0], a);
+    px[1] = SoftBlend(c.g, px[1], a);
+    px[2] = SoftBlend(c.b, px[2], a);
+    px[3] = SoftBlend(255, px[3], a);
+}
+
+// Blend a constant colour over a run of pixels, four at a time with SSE2
+void SoftBlendSpan(unsigned char* row, int x0, int x1, Color c) {
+    if (x0 >= x1 || c.a == 0) return;
+    unsigned char* px = row + x0 * 4;
+    int n = x1 - x0;
+
+    if (c.a == 255) {
+        uint32_t packed;
+        unsigned char bytes[4] = {c.r, c.g, c.b, 255};
+        memcpy(&packed, bytes, 4);
+        int i = 0;
+#if defined(__SSE2__)
+        __m128i fill = _mm_set1_epi32((int)packed);
+        for (; i + 4 <= n; i += 4) _mm_storeu_si128((__m128i*)(px + i * 4), fill);
+#endif
+        for (; i < n; i++) memcpy(px + i * 4, &packed, 4);
+        return;
     }
 
-    bool Update() {
-        if (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_M)) return true;
+    int a = c.a;
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    __m128i srcTerm = _mm_set_epi16(255 * a, c.b * a, c.g * a, c.r * a, 255 * a, c.b * a, c.g * a, c.r * a);
+    __m128i invA = _mm_set1_epi16((short)(255 - a));
+    __m128i bias = _mm_set1_epi16(128);
+    for (; i + 4 <= n; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(px + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(d, zero);
+        __m128i hi = _mm_unpackhi_epi8(d, zero);
+        lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, invA), srcTerm), bias);
+        hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, invA), srcTerm), bias);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(px + i * 4), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < n; i++) SoftBlendPixel(px + i * 4, c, a);
+}
 
-        animTime += GetFrameTime();
+// Horizontal extent of a rounded rectangle at row centre yc
+bool SoftRoundedRectSpan(const float* p, float yc, float& xl, float& xr) {
+    float x = p[0], y = p[1], w = p[2], h = p[3], r = p[4];
+    if (yc < y || yc >= y + h) return false;
+    float dy = 0;
+    if (yc < y + r) dy = y + r - yc;
+    else if (yc > y + h - r) dy = yc - (y + h - r);
+    float inset = (dy > 0) ? r - sqrtf(max(0.0f, r * r - dy * dy)) : 0;
+    xl = x + inset;
+    xr = x + w - inset;
+    return xl < xr;
+}
 
-        if (gameOver) {
-            if (IsKeyPressed(KEY_SPACE)) Init();
-            return false;
+bool SoftCircleSpan(float cx, float cy, float r, float yc, float& xl, float& xr) {
+    float dy = yc - cy;
+    if (r <= 0 || dy <= -r || dy >= r) return false;
+    float half = sqrtf(r * r - dy * dy);
+    xl = cx - half;
+    xr = cx + half;
+    return true;
+}
+
+bool SoftPolygonSpan(const float* p, int count, float yc, float& xl, float& xr) {
+    xl = 1e30f;
+    xr = -1e30f;
+    for (int i = 0; i < count; i++) {
+        int j = (i + 1) % count;
+        float x0 = p[i * 2], y0 = p[i * 2 + 1];
+        float x1 = p[j * 2], y1 = p[j * 2 + 1];
+        if ((yc >= y0 && yc < y1) || (yc >= y1 && yc < y0)) {
+            float x = x0 + (yc - y0) * (x1 - x0) / (y1 - y0);
+            xl = min(xl, x);
+            xr = max(xr, x);
         }
+    }
+    return xl < xr;
+}
 
-        // Player movement
-        float speed = 8.0f;
-        if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) playerX -= speed;
-        if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) playerX += speed;
+// Bilinear sample of one channel, clamped or wrapped at the edges
+float SoftSample(const SoftImageView& img, float u, float v, int channel, bool wrap) {
+    u -= 0.5f;
+    v -= 0.5f;
+    int x0 = (int)floorf(u), y0 = (int)floorf(v);
+    float fx = u - x0, fy = v - y0;
+    int xs[2] = {x0, x0 + 1}, ys[2] = {y0, y0 + 1};
+    for (int k = 0; k < 2; k++) {
+        if (wrap) {
+            xs[k] = ((xs[k] % img.width) + img.width) % img.width;
+            ys[k] = ((ys[k] % img.height) + img.height) % img.height;
+        } else {
+            xs[k] = min(max(xs[k], 0), img.width - 1);
+            ys[k] = min(max(ys[k], 0), img.height - 1);
+        }
+    }
+    auto at = [&](int x, int y) { return (float)img.pixels[(y * img.width + x) * img.channels + channel]; };
+    float top = at(xs[0], ys[0]) + (at(xs[1], ys[0]) - at(xs[0], ys[0])) * fx;
+    float bottom = at(xs[0], ys[1]) + (at(xs[1], ys[1]) - at(xs[0], ys[1])) * fx;
+    return top + (bottom - top) * fy;
+}
 
-        if (playerX < 30) playerX = 30;
-        if (playerX > SCREEN_WIDTH - 30) playerX = SCREEN_WIDTH - 30;
+class SoftRasterizer {
+private:
+    int width = 0, height = 0;
+    vector<unsigned char> pixels;
+    vector<SoftCommand> commands;
+
+    void Push(SoftCommand& cmd, float x0, float y0, float x1, float y1) {
+        cmd.minX = max(0, (int)floorf(x0));
+        cmd.minY = max(0, (int)floorf(y0));
+        cmd.maxX = min(width, (int)ceilf(x1) + 1);
+        cmd.maxY = min(height, (int)ceilf(y1) + 1);
+        if (cmd.minX >= cmd.maxX || cmd.minY >= cmd.maxY || cmd.color.a == 0) return;
+        commands.push_back(cmd);
+    }
 
-        // Update asteroids
-        for (auto& a : asteroids) {
-            a.y += a.speed;
+    void FillSpan(unsigned char* row, float xl, float xr, int clipX0, int clipX1, Color c) {
+        int x0 = max(clipX0, (int)ceilf(xl - 0.5f));
+        int x1 = min(clipX1, (int)ceilf(xr - 0.5f));
+        SoftBlendSpan(row, x0, x1, c);
+    }
 
-            // Collision detection
-            float dx = a.x - playerX;
-            float dy = a.y - playerY;
-            if (dx * dx + dy * dy < (a.size + 20) * (a.size + 20)) {
-                gameOver = true;
-            }
+    void RasterizeCommand(const SoftCommand& cmd, int x0, int y0, int x1, int y1) {
+        for (int y = y0; y < y1; y++) {
+            unsigned char* row = &pixels[(size_t)y * width * 4];
+            float yc = y + 0.5f;
+            float xl, xr, il, ir;
 
-            // Respawn asteroid if off screen
-            if (a.y > SCREEN_HEIGHT + 50) {
-                a.y = -50;
-                a.x = rand() % SCREEN_WIDTH;
-                a.speed = 3 + (rand() % 4) + score / 500;
-                a.size = 15 + (rand() % 20);
-                score += 10;
+            switch (cmd.type) {
+                case SOFT_FILL_RECT:
+                    if (yc >= cmd.p[1] && yc < cmd.p[1] + cmd.p[3])
+                        FillSpan(row, cmd.p[0], cmd.p[0] + cmd.p[2], x0, x1, cmd.color);
+                    break;
+                case SOFT_ROUNDED_RECT:
+                    if (SoftRoundedRectSpan(cmd.p, yc, xl, xr)) FillSpan(row, xl, xr, x0, x1, cmd.color);
+                    break;
+                case SOFT_ROUNDED_RING: {
+                    if (!SoftRoundedRectSpan(cmd.p, yc, xl, xr)) break;
+                    float t = cmd.p[5];
+                    float inner[5] = {cmd.p[0] + t, cmd.p[1] + t, cmd.p[2] - 2 * t, cmd.p[3] - 2 * t, max(0.0f, cmd.p[4] - t)};
+                    if (SoftRoundedRectSpan(inner, yc, il, ir)) {
+                        FillSpan(row, xl, il, x0, x1, cmd.color);
+                        FillSpan(row, ir, xr, x0, x1, cmd.color);
+                    } else {
+                        FillSpan(row, xl, xr, x0, x1, cmd.color);
+                    }
+                    break;
+                }
+                case SOFT_CIRCLE:
+                    if (SoftCircleSpan(cmd.p[0], cmd.p[1], cmd.p[2], yc, xl, xr)) FillSpan(row, xl, xr, x0, x1, cmd.color);
+                    break;
+                case SOFT_RING:
+                    if (!SoftCircleSpan(cmd.p[0], cmd.p[1], cmd.p[2], yc, xl, xr)) break;
+                    if (SoftCircleSpan(cmd.p[0], cmd.p[1], cmd.p[3], yc, il, ir)) {
+                        FillSpan(row, xl, il, x0, x1, cmd.color);
+                        FillSpan(row, ir, xr, x0, x1, cmd.color);
+                    } else {
+                        FillSpan(row, xl, xr, x0, x1, cmd.color);
+                    }
+                    break;
+                case SOFT_POLYGON:
+                    if (SoftPolygonSpan(cmd.p, cmd.vertexCount, yc, xl, xr)) FillSpan(row, xl, xr, x0, x1, cmd.color);
+                    break;
+                case SOFT_IMAGE:
+                case SOFT_SDF_GLYPH: {
+                    float dx = cmd.p[0], dy = cmd.p[1], dw = cmd.p[2], dh = cmd.p[3];
+                    if (yc < dy || yc >= dy + dh) break;
+                    float v = cmd.source.y + (yc - dy) / dh * cmd.source.height;
+                    int px0 = max(x0, (int)ceilf(dx - 0.5f));
+                    int px1 = min(x1, (int)ceilf(dx + dw - 0.5f));
+                    for (int x = px0; x < px1; x++) {
+                        float u = cmd.source.x + (x + 0.5f - dx) / dw * cmd.source.width;
+                        unsigned char* px = row + x * 4;
+                        if (cmd.type == SOFT_SDF_GLYPH) {
+                            float dist = SoftSample(cmd.image, u, v, 1, false) / 255.0f;
+                            float alpha = min(1.0f, max(0.0f, (dist - 0.5f) / cmd.p[4] + 0.5f));
+                            SoftBlendPixel(px, cmd.color, (int)(cmd.color.a * alpha + 0.5f));
+                        } else {
+                            Color texel;
+                            texel.r = (unsigned char)(SoftSample(cmd.image, u, v, 0, cmd.wrap) * cmd.color.r / 255.0f + 0.5f);
+                            texel.g = (unsigned char)(SoftSample(cmd.image, u, v, 1, cmd.wrap) * cmd.color.g / 255.0f + 0.5f);
+                            texel.b = (unsigned char)(SoftSample(cmd.image, u, v, 2, cmd.wrap) * cmd.color.b / 255.0f + 0.5f);
+                            int a = (int)(SoftSample(cmd.image, u, v, 3, cmd.wrap) * cmd.color.a / 255.0f + 0.5f);
+                            SoftBlendPixel(px, texel, a);
+                        }
+                    }
+                    break;
+                }
             }
         }
+    }
 
-        // Add more asteroids as score increases
-        if (score > 0 && score % 200 == 0 && asteroids.size() < 20) {
-            Asteroid a;
-            a.x = rand() % SCREEN_WIDTH;
-            a.y = -50;
-            a.speed = 4 + (rand() % 5);
-            a.size = 15 + (rand() % 25);
-            asteroids.push_back(a);
-        }
+public:
+    void Begin(int w, int h) {
+        width = w;
+        height = h;
+        pixels.assign((size_t)w * h * 4, 0);
+        commands.clear();
+    }
 
-        return false;
+    void Clear(Color c) {
+        commands.clear();    // Everything recorded so far is covered
+        unsigned char bytes[4] = {c.r, c.g, c.b, c.a};
+        for (size_t i = 0; i < pixels.size(); i += 4) memcpy(&pixels[i], bytes, 4);
     }
 
-    void Draw() {
-        ClearBackground({5, 5, 20, 255});
+    void FillRect(float x, float y, float w, float h, Color c) {
+        SoftCommand cmd = {};
+        cmd.type = SOFT_FILL_RECT;
+        cmd.color = c;
+        cmd.p[0] = x; cmd.p[1] = y; cmd.p[2] = w; cmd.p[3] = h;
+        Push(cmd, x, y, x + w, y + h);
+    }
 
-        // Draw moving stars
-        for (auto& star : stars) {
-            float y = star.second + animTime * 30;
-            while (y > SCREEN_HEIGHT) y -= SCREEN_HEIGHT;
-            DrawCircle(star.first, y, 1, (Color){255, 255, 255, 150});
-        }
+    void FillRoundedRect(Rectangle rec, float radius, Color c) {
+        SoftCommand cmd = {};
+        cmd.type = SOFT_ROUNDED_RECT;
+        cmd.color = c;
+        cmd.p[0] = rec.x; cmd.p[1] = rec.y; cmd.p[2] = rec.width; cmd.p[3] = rec.height; cmd.p[4] = radius;
+        Push(cmd, rec.x, rec.y, rec.x + rec.width, rec.y + rec.height);
+    }
 
-        // Title and score
-        DrawTextCentered("SPACE SURVIVOR", 20, 36, Colors::ACCENT);
+    // Ring between an outer rounded rectangle and the same shape inset by thick
+    void RoundedRing(Rectangle outer, float radius, float thick, Color c) {
+        SoftCommand cmd = {};
+        cmd.type = SOFT_ROUNDED_RING;
+        cmd.color = c;
+        cmd.p[0] = outer.x; cmd.p[1] = outer.y; cmd.p[2] = outer.width; cmd.p[3] = outer.height;
+        cmd.p[4] = radius; cmd.p[5] = thick;
+        Push(cmd, outer.x, outer.y, outer.x + outer.width, outer.y + outer.height);
+    }
 
-        char scoreText[32];
-        sprintf(scoreText, "SCORE: %d", score);
-        DrawTextCentered(scoreText, 65, 28, Colors::TEXT_LIGHT);
+    void FillCircle(float cx, float cy, float r, Color c) {
+        SoftCommand cmd = {};
+        cmd.type = SOFT_CIRCLE;
+        cmd.color = c;
+        cmd.p[0] = cx; cmd.p[1] = cy; cmd.p[2] = r;
+        Push(cmd, cx - r, cy - r, cx + r, cy + r);
+    }
 
-        // Draw asteroids
-        for (auto& a : asteroids) {
-            DrawCircle(a.x, a.y, a.size, (Color){139, 69, 19, 255});
-            DrawCircle(a.x - a.size/4, a.y - a.size/4, a.size/4, (Color){100, 50, 10, 255});
-            DrawCircleLines(a.x, a.y, a.size, (Color){80, 40, 10, 255});
-        }
+    void Ring(float cx, float cy, float outerRadius, float innerRadius, Color c) {
+        SoftCommand cmd = {};
+        cmd.type = SOFT_RING;
+        cmd.color = c;
+        cmd.p[0] = cx; cmd.p[1] = cy; cmd.p[2] = outerRadius; cmd.p[3] = innerRadius;
+        Push(cmd, cx - outerRadius, cy - outerRadius, cx + outerRadius, cy + outerRadius);
+    }
 
-        // Draw player ship
-        if (!gameOver) {
-            // Ship body (triangle)
-            Vector2 v1 = {playerX, playerY - 25};
-            Vector2 v2 = {playerX - 20, playerY + 20};
-            Vector2 v3 = {playerX + 20, playerY + 20};
-            DrawTriangle(v1, v3, v2, Colors::PRIMARY);
-            DrawTriangleLines(v1, v3, v2, WHITE);
-
-            // Engine flame
-            float flameSize = 10 + sin(animTime * 20) * 5;
-            DrawTriangle({playerX, playerY + 20},
-                        {playerX + 8, playerY + 20 + flameSize},
-                        {playerX - 8, playerY + 20 + flameSize}, ORANGE);
+    // Convex polygon with up to four vertices
+    void FillPolygon(const Vector2* v, int count, Color c) {
+        SoftCommand cmd = {};
+        cmd.type = SOFT_POLYGON;
+        cmd.color = c;
+        cmd.vertexCount = count;
+        float x0 = v[0].x, y0 = v[0].y, x1 = v[0].x, y1 = v[0].y;
+        for (int i = 0; i < count; i++) {
+            cmd.p[i * 2] = v[i].x;
+            cmd.p[i * 2 + 1] = v[i].y;
+            x0 = min(x0, v[i].x); y0 = min(y0, v[i].y);
+            x1 = max(x1, v[i].x); y1 = max(y1, v[i].y);
         }
+        Push(cmd, x0, y0, x1, y1);
+    }
 
-        // Game over screen
-        if (gameOver) {
-            DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, 180});
-            DrawTextCentered("GAME OVER", SCREEN_HEIGHT/2 - 60, 60, Colors::DANGER);
+    void Line(Vector2 a, Vector2 b, float thick, Color c) {
+        float dx = b.x - a.x, dy = b.y - a.y;
+        float len = sqrtf(dx * dx + dy * dy);
+        if (len <= 0) return;
+        float nx = -dy / len * thick / 2, ny = dx / len * thick / 2;
+        Vector2 quad[4] = {{a.x + nx, a.y + ny}, {b.x + nx, b.y + ny}, {b.x - nx, b.y - ny}, {a.x - nx, a.y - ny}};
+        FillPolygon(quad, 4, c);
+    }
 
-            sprintf(scoreText, "Final Score: %d", score);
-            DrawTextCentered(scoreText, SCREEN_HEIGHT/2 + 10, 30, Colors::ACCENT);
-            DrawTextCentered("Press SPACE to play again", SCREEN_HEIGHT/2 + 60, 20, Colors::TEXT_DIM);
+    void Image(const SoftImageView& image, Rectangle source, Rectangle dest, Color tint, bool wrap = false) {
+        SoftCommand cmd = {};
+        cmd.type = SOFT_IMAGE;
+        cmd.color = tint;
+        cmd.wrap = wrap;
+        cmd.image = image;
+        cmd.source = source;
+        cmd.p[0] = dest.x; cmd.p[1] = dest.y; cmd.p[2] = dest.width; cmd.p[3] = dest.height;
+        Push(cmd, dest.x, dest.y, dest.x + dest.width, dest.y + dest.height);
+    }
+
+    // One glyph from the SDF atlas; edgeWidth is the distance change per pixel
+    void SdfGlyph(const SoftImageView& atlas, Rectangle source, Rectangle dest, float edgeWidth, Color c) {
+        SoftCommand cmd = {};
+        cmd.type = SOFT_SDF_GLYPH;
+        cmd.color = c;
+        cmd.image = atlas;
+        cmd.source = source;
+        cmd.p[0] = dest.x; cmd.p[1] = dest.y; cmd.p[2] = dest.width; cmd.p[3] = dest.height;
+        cmd.p[4] = max(edgeWidth, 0.0001f);
+        Push(cmd, dest.x, dest.y, dest.x + dest.width, dest.y + dest.height);
+    }
+
+    // Rasterize everything recorded since Begin(), split into screen tiles
+    void Finish() {
+        int tilesX = (width + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+        int tilesY = (height + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+        int tileCount = tilesX * tilesY;
+
+        jobs.ParallelFor(tileCount, 1, [&](int begin, int end) {
+            for (int t = begin; t < end; t++) {
+                int tx0 = (t % tilesX) * SOFT_TILE_SIZE, ty0 = (t / tilesX) * SOFT_TILE_SIZE;
+                int tx1 = min(width, tx0 + SOFT_TILE_SIZE), ty1 = min(height, ty0 + SOFT_TILE_SIZE);
+                for (const SoftCommand& cmd : commands) {
+                    int x0 = max(tx0, cmd.minX), x1 = min(tx1, cmd.maxX);
+                    int y0 = max(ty0, cmd.minY), y1 = min(ty1, cmd.maxY);
+                    if (x0 < x1 && y0 < y1) RasterizeCommand(cmd, x0, y0, x1, y1);
+                }
+            }
+        });
+        commands.clear();
+    }
+
+    SoftImageView View() const { return {pixels.data(), width, height, 4}; }
+
+    bool WritePPM(const char* path) const {
+        ofstream file(path, ios::binary);
+        if (!file.is_open()) return false;
+        file << "P6\n" << width << " " << height << "\n255\n";
+        vector<unsigned char> rgb((size_t)width * height * 3);
+        for (size_t i = 0, j = 0; i < pixels.size(); i += 4, j += 3) {
+            rgb[j] = pixels[i]; rgb[j + 1] = pixels[i + 1]; rgb[j + 2] = pixels[i + 2];
         }
+        file.write((const char*)rgb.data(), (streamsize)rgb.size());
+        return file.good();
+    }
 
-        // Controls hint
-        DrawText("Controls: A/D or Arrow Keys | Press M to return to menu",
-                 20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+    bool WritePNG(const char* path) const {
+        ::Image img = {(void*)pixels.data(), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+        return ExportImage(img, path);
+    }
+
+    bool Write(const char* path) const {
+        const char* ext = strrchr(path, '.');
+        if (ext && strcmp(ext, ".png") == 0) return WritePNG(path);
+        return WritePPM(path);
     }
 };
 
 // ═══════════════════════════════════════════════════════════════════════════
-// BREAK THE CODE GAME CLASS
+// RENDER STATISTICS
 // ═══════════════════════════════════════════════════════════════════════════
 
-class BreakTheCodeGame {
+// Per-frame counters for everything the drawing helpers submit. Draw calls
+// and batch flushes are read off rlgl itself: the stats install their own
+// rlRenderBatch (the size of raylib's default one) and look at it at every
+// submission. rlgl never fills the last draw slot, since it flushes first,
+// but resets it on every flush, so a marker left there shows whether the
+// batch went to the GPU since the last look, and the draws seen in it then
+// are the draw calls that flush made. The CPU rasterizer has no batch, so
+// both stay zero there.
+const int GAME_STATE_COUNT = SWAP_CARDS + 1;
+const char* GAME_STATE_NAMES[GAME_STATE_COUNT] = {
+    "menu", "tictactoe", "space", "code", "zombie", "cards"
+};
+
+struct FrameStats {
+    int primitives;      // Shape, sprite and text calls
+    int vertices;        // Vertices as raylib tessellates them
+    int drawCalls;       // Draws in the rlgl batches flushed this frame
+    int batchFlushes;
+    int textCalls;
+    int glyphs;
+    int sprites;
+    int buttons;         // Helper calls
+    int centeredTexts;
+    int backgrounds;
+    int gameDraws;
+    float drawMs;        // CPU time spent issuing the frame
+};
+
+class RenderStats {
 private:
-    int secretCode[4];
-    int guesses[10][4];
-    int feedback[10][2];  // [correctPos, correctDigit]
-    int currentGuess;
-    int inputDigits[4];
-    int inputIndex;
-    bool gameOver;
-    bool won;
-    float animTime;
+    static const int MARKER_SLOT = RL_DEFAULT_BATCH_DRAWCALLS - 1;
+
+    FrameStats current = {};
+    FrameStats last = {};
+    FrameStats totals[GAME_STATE_COUNT] = {};
+    int frames[GAME_STATE_COUNT] = {};
+    int frameIndex = 0;
+    rlRenderBatch* batch = nullptr;
+    int seenDraws = 0;           // Non-empty draws in the batch at the last look
+    int hiddenDraws = 0;         // How many of those were drawn while paused
+    int pausedDraws = 0;
+    int paused = 0;
+    ofstream stream;
+    bool json = false;
+
+    int BatchDraws() const {
+        int draws = 0;
+        for (int i = 0; i < batch->drawCounter; i++) draws += (batch->draws[i].vertexCount > 0);
+        return draws;
+    }
 
-public:
-    void Init() {
-        // Generate secret code with unique digits
-        vector<int> digits = {0,1,2,3,4,5,6,7,8,9};
-        for (int i = 9; i > 0; i--) {
-            int j = rand() % (i + 1);
-            swap(digits[i], digits[j]);
-        }
-        for (int i = 0; i < 4; i++) secretCode[i] = digits[i];
+    // Books the draws of a batch that has gone to the GPU
+    void Submitted(int draws) {
+        if (draws <= 0) return;
+        current.batchFlushes++;
+        current.drawCalls += draws;
+    }
 
-        for (int i = 0; i < 10; i++) {
-            for (int j = 0; j < 4; j++) guesses[i][j] = -1;
-            feedback[i][0] = feedback[i][1] = 0;
+    // Catch up with the batch; a cleared marker means rlgl flushed what was seen last time
+    void Look() {
+        if (!batch) return;
+        if (batch->draws[MARKER_SLOT].vertexCount != -1) {
+            Submitted(seenDraws - hiddenDraws);
+            seenDraws = hiddenDraws = pausedDraws = 0;
+            batch->draws[MARKER_SLOT].vertexCount = -1;
         }
+        seenDraws = BatchDraws();
+    }
 
-        currentGuess = 0;
-        inputIndex = 0;
-        for (int i = 0; i < 4; i++) inputDigits[i] = -1;
-        gameOver = false;
-        won = false;
-        animTime = 0;
+    static void Add(FrameStats& into, const FrameStats& f) {
+        into.primitives += f.primitives;       into.vertices += f.vertices;
+        into.drawCalls += f.drawCalls;         into.batchFlushes += f.batchFlushes;
+        into.textCalls += f.textCalls;         into.glyphs += f.glyphs;
+        into.sprites += f.sprites;             into.buttons += f.buttons;
+        into.centeredTexts += f.centeredTexts; into.backgrounds += f.backgrounds;
+        into.gameDraws += f.gameDraws;         into.drawMs += f.drawMs;
     }
 
-    void CheckGuess() {
-        int correctPos = 0, correctDigit = 0;
-        bool secretUsed[4] = {false}, guessUsed[4] = {false};
+public:
+    bool overlayVisible = false;
+
+    // Makes batch rlgl's active one and measures through it; null detaches
+    void Attach(rlRenderBatch* active) {
+        rlSetRenderBatchActive(active);
+        batch = active;
+        seenDraws = hiddenDraws = pausedDraws = 0;
+        if (batch) batch->draws[MARKER_SLOT].vertexCount = -1;
+    }
 
-        for (int i = 0; i < 4; i++) {
-            if (inputDigits[i] == secretCode[i]) {
-                correctPos++;
-                secretUsed[i] = guessUsed[i] = true;
-            }
+    // Start writing one record per frame; .json gives JSON Lines, anything else CSV
+    bool OpenStream(const char* path) {
+        stream.open(path);
+        if (!stream.is_open()) return false;
+        const char* ext = strrchr(path, '.');
+        json = ext && strcmp(ext, ".json") == 0;
+        if (!json) {
+            stream << "frame,state,primitives,vertices,draw_calls,batch_flushes,text_calls,glyphs,"
+                      "sprites,buttons,centered_texts,backgrounds,game_draws,draw_ms\n";
+        }
+        return true;
+    }
+
+    // Draws between Pause and Resume stay out of every count
+    void Pause() {
+        if (paused++ == 0 && batch) {
+            Look();
+            pausedDraws = seenDraws;
         }
+    }
 
-        for (int i = 0; i < 4; i++) {
-            if (!guessUsed[i]) {
-                for (int j = 0; j < 4; j++) {
-                    if (!secretUsed[j] && inputDigits[i] == secretCode[j]) {
-                        correctDigit++;
-                        secretUsed[j] = true;
-                        break;
-                    }
-                }
+    void Resume() {
+        if (--paused == 0 && batch) {
+            if (batch->draws[MARKER_SLOT].vertexCount != -1) {
+                Submitted(pausedDraws - hiddenDraws);         // Flushed while paused: book what came before
+                seenDraws = hiddenDraws = pausedDraws = 0;
+                batch->draws[MARKER_SLOT].vertexCount = -1;
             }
+            int draws = BatchDraws();
+            hiddenDraws += draws - max(seenDraws, pausedDraws);
+            seenDraws = draws;
         }
+    }
 
-        for (int i = 0; i < 4; i++) guesses[currentGuess][i] = inputDigits[i];
-        feedback[currentGuess][0] = correctPos;
-        feedback[currentGuess][1] = correctDigit;
+    void Primitive(int vertices) {
+        if (paused) return;
+        Look();
+        current.primitives++;
+        current.vertices += vertices;
+    }
 
-        if (correctPos == 4) {
-            won = gameOver = true;
-            // Save score
-            ofstream file("codebreaker_leaderboard.txt", ios::app);
-            if (file.is_open()) {
-                file << "Cracked in " << (currentGuess + 1) << " attempts\n";
-                file.close();
+    // Call next to anything that makes rlgl flush (shader and target switches)
+    void Flush() {
+        if (!paused) Look();
+    }
+
+    void Text(int glyphCount) { if (!paused) { current.textCalls++; current.glyphs += glyphCount; } }
+    void Sprite() { if (!paused) current.sprites++; }
+    void Button() { if (!paused) current.buttons++; }
+    void CenteredText() { if (!paused) current.centeredTexts++; }
+    void Background() { if (!paused) current.backgrounds++; }
+    void GameDraw() { if (!paused) current.gameDraws++; }
+
+    // Call right before EndDrawing, which flushes whatever the batch still holds
+    void EndFrame(GameState state, float drawMs) {
+        if (batch) {
+            Look();
+            Submitted(seenDraws - hiddenDraws);
+            seenDraws = hiddenDraws = pausedDraws = 0;
+        }
+        current.drawMs = drawMs;
+        last = current;
+        Add(totals[state], current);
+        frames[state]++;
+
+        if (stream.is_open()) {
+            const FrameStats& f = current;
+            char line[512];
+            if (json) {
+                snprintf(line, sizeof(line),
+                         "{\"frame\":%d,\"state\":\"%s\",\"primitives\":%d,\"vertices\":%d,\"draw_calls\":%d,"
+                         "\"batch_flushes\":%d,\"text_calls\":%d,\"glyphs\":%d,\"sprites\":%d,\"buttons\":%d,"
+                         "\"centered_texts\":%d,\"backgrounds\":%d,\"game_draws\":%d,\"draw_ms\":%.3f}\n",
+                         frameIndex, GAME_STATE_NAMES[state], f.primitives, f.vertices, f.drawCalls,
+                         f.batchFlushes, f.textCalls, f.glyphs, f.sprites, f.buttons, f.centeredTexts,
+                         f.backgrounds, f.gameDraws, f.drawMs);
+            } else {
+                snprintf(line, sizeof(line), "%d,%s,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%.3f\n",
+                         frameIndex, GAME_STATE_NAMES[state], f.primitives, f.vertices, f.drawCalls,
+                         f.batchFlushes, f.textCalls, f.glyphs, f.sprites, f.buttons, f.centeredTexts,
+                         f.backgrounds, f.gameDraws, f.drawMs);
             }
-        } else {
-            currentGuess++;
-            if (currentGuess >= 10) gameOver = true;
+            stream << line;
         }
 
-        inputIndex = 0;
-        for (int i = 0; i < 4; i++) inputDigits[i] = -1;
+        frameIndex++;
+        current = {};
     }
 
-    bool Update() {
-        if (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_M)) return true;
+    const FrameStats& Last() const { return last; }
+
+    // Average of every frame recorded so far in a state
+    FrameStats Average(GameState state) const {
+        FrameStats avg = {};
+        int n = frames[state];
+        if (n == 0) return avg;
+        const FrameStats& t = totals[state];
+        avg.primitives = t.primitives / n;       avg.vertices = t.vertices / n;
+        avg.drawCalls = t.drawCalls / n;         avg.batchFlushes = t.batchFlushes / n;
+        avg.textCalls = t.textCalls / n;         avg.glyphs = t.glyphs / n;
+        avg.sprites = t.sprites / n;             avg.buttons = t.buttons / n;
+        avg.centeredTexts = t.centeredTexts / n; avg.backgrounds = t.backgrounds / n;
+        avg.gameDraws = t.gameDraws / n;         avg.drawMs = t.drawMs / n;
+        return avg;
+    }
+};
 
-        animTime += GetFrameTime();
+RenderStats renderStats;
 
-        if (gameOver) {
-            if (IsKeyPressed(KEY_SPACE)) Init();
-            return false;
-        }
+// ═══════════════════════════════════════════════════════════════════════════
+// RENDER BACKEND
+// ═══════════════════════════════════════════════════════════════════════════
 
-        // Number input
-        for (int key = KEY_ZERO; key <= KEY_NINE; key++) {
-            if (IsKeyPressed(key) && inputIndex < 4) {
-                inputDigits[inputIndex++] = key - KEY_ZERO;
-            }
-        }
+// Shapes go through Gfx:: so the same Draw() code can target raylib or the
+// software rasterizer. softTarget is null on the normal GPU path.
+bool headless = false;
+const float HEADLESS_FRAME_TIME = 1.0f / 60.0f;
+SoftRasterizer* softTarget = nullptr;
 
-        // Backspace
-        if (IsKeyPressed(KEY_BACKSPACE) && inputIndex > 0) {
-            inputDigits[--inputIndex] = -1;
-        }
+// Set on the simulation thread, which always steps at a fixed rate
+thread_local float simulationStep = 0;
 
-        // Submit guess
-        if (IsKeyPressed(KEY_ENTER) && inputIndex == 4) {
-            CheckGuess();
-        }
+// Frame time for game updates; headless runs step at a fixed 60 Hz
+float FrameDelta() {
+    if (simulationStep > 0) return simulationStep;
+    return headless ? HEADLESS_FRAME_TIME : GetFrameTime();
+}
 
-        return false;
+void CoverDeferredText(float x, float y, float width, float height);
+
+namespace Gfx {
+    // Corner radius raylib derives from the roundness factor
+    inline float CornerRadius(Rectangle rec, float roundness) {
+        return (rec.width > rec.height) ? rec.height * roundness / 2 : rec.width * roundness / 2;
     }
 
-    void Draw() {
-        DrawAnimatedBackground(animTime);
+    inline void CoverTriangle(Vector2 v1, Vector2 v2, Vector2 v3) {
+        float x0 = min(v1.x, min(v2.x, v3.x)), y0 = min(v1.y, min(v2.y, v3.y));
+        CoverDeferredText(x0 - 1, y0 - 1, max(v1.x, max(v2.x, v3.x)) - x0 + 2, max(v1.y, max(v2.y, v3.y)) - y0 + 2);
+    }
 
-        DrawTextCentered("BREAK THE CODE", 30, 40, Colors::ACCENT);
-        DrawTextCentered("Guess the 4-digit code (unique digits 0-9)", 80, 20, Colors::TEXT_DIM);
+    void Clear(Color color) {
+        if (softTarget) softTarget->Clear(color);
+        else ClearBackground(color);
+    }
 
-        // Draw previous guesses
-        float startY = 120;
-        for (int g = 0; g < 10; g++) {
-            float y = startY + g * 45;
+    void FillRect(float x, float y, float width, float height, Color color) {
+        renderStats.Primitive(4);
+        CoverDeferredText(x, y, width, height);
+        if (softTarget) softTarget->FillRect(x, y, width, height, color);
+        else DrawRectangleRec({x, y, width, height}, color);
+    }
 
-            // Attempt number
-            char numText[8];
-            sprintf(numText, "%2d.", g + 1);
-            DrawText(numText, 250, y + 8, 20, g < currentGuess ? Colors::TEXT_DIM : Colors::TEXT_LIGHT);
+    void FillRoundedRect(Rectangle rec, float roundness, int segments, Color color) {
+        renderStats.Primitive((4 * max(segments, 4) + 5) * 4);
+        CoverDeferredText(rec.x, rec.y, rec.width, rec.height);
+        if (softTarget) softTarget->FillRoundedRect(rec, CornerRadius(rec, roundness), color);
+        else DrawRectangleRounded(rec, roundness, segments, color);
+    }
 
-            // Digit boxes
-            for (int d = 0; d < 4; d++) {
-                Rectangle box = {300 + d * 60.0f, y, 50, 40};
-                Color boxColor = (g == currentGuess) ? Colors::CARD_HOVER : Colors::CARD_BG;
-                DrawRectangleRounded(box, 0.2f, 4, boxColor);
-                DrawRectangleRoundedLines(box, 0.2f, 4, 2, Colors::PRIMARY);
+    // Outline drawn outside rec, like DrawRectangleRoundedLines
+    void StrokeRoundedRect(Rectangle rec, float roundness, int segments, float thick, Color color) {
+        int pieces = 4 * max(segments, 4) + 4;
+        if (thick > 1) renderStats.Primitive(pieces * 4);
+        else renderStats.Primitive(pieces * 2);
+        CoverDeferredText(rec.x - thick, rec.y - thick, rec.width + 2 * thick, rec.height + 2 * thick);
+        if (softTarget) {
+            Rectangle outer = {rec.x - thick, rec.y - thick, rec.width + 2 * thick, rec.height + 2 * thick};
+            softTarget->RoundedRing(outer, CornerRadius(rec, roundness) + thick, thick, color);
+        } else {
+            DrawRectangleRoundedLines(rec, roundness, segments, thick, color);
+        }
+    }
 
-                if (guesses[g][d] >= 0) {
-                    char digit[2] = {(char)('0' + guesses[g][d]), 0};
-                    DrawText(digit, box.x + 18, box.y + 8, 24, Colors::TEXT_LIGHT);
-                } else if (g == currentGuess && d < inputIndex) {
-                    char digit[2] = {(char)('0' + inputDigits[d]), 0};
-                    DrawText(digit, box.x + 18, box.y + 8, 24, Colors::ACCENT);
-                }
-            }
+    void FillCircle(float cx, float cy, float radius, Color color) {
+        renderStats.Primitive(72);
+        CoverDeferredText(cx - radius, cy - radius, 2 * radius, 2 * radius);
+        if (softTarget) softTarget->FillCircle(cx, cy, radius, color);
+        else DrawCircleV({cx, cy}, radius, color);
+    }
 
-            // Feedback
-            if (g < currentGuess) {
-                char fb[32];
-                sprintf(fb, "%d correct, %d misplaced", feedback[g][0], feedback[g][1]);
-                DrawText(fb, 560, y + 10, 18,
-                         feedback[g][0] == 4 ? Colors::SUCCESS : Colors::TEXT_DIM);
-            }
-        }
+    void StrokeCircle(float cx, float cy, float radius, Color color) {
+        renderStats.Primitive(72);
+        CoverDeferredText(cx - radius - 1, cy - radius - 1, 2 * radius + 2, 2 * radius + 2);
+        if (softTarget) softTarget->Ring(cx, cy, radius + 0.5f, radius - 0.5f, color);
+        else DrawCircleLines((int)cx, (int)cy, radius, color);
+    }
 
-        // Current input instruction
-        if (!gameOver) {
-            DrawTextCentered("Type 4 digits and press ENTER to guess",
-                           SCREEN_HEIGHT - 80, 20, Colors::TEXT_LIGHT);
+    void Line(Vector2 start, Vector2 end, float thick, Color color) {
+        renderStats.Primitive(6);
+        CoverDeferredText(min(start.x, end.x) - thick, min(start.y, end.y) - thick,
+                          fabsf(end.x - start.x) + 2 * thick, fabsf(end.y - start.y) + 2 * thick);
+        if (softTarget) softTarget->Line(start, end, thick, color);
+        else DrawLineEx(start, end, thick, color);
+    }
+
+    // Vertices in counter-clockwise order, as raylib expects
+    void FillTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+        renderStats.Primitive(4);
+        CoverTriangle(v1, v2, v3);
+        if (softTarget) {
+            Vector2 v[3] = {v1, v2, v3};
+            softTarget->FillPolygon(v, 3, color);
         } else {
-            if (won) {
-                char winText[64];
-                sprintf(winText, "YOU WON in %d attempts!", currentGuess);
-                DrawTextCentered(winText, SCREEN_HEIGHT - 100, 30, Colors::SUCCESS);
-            } else {
-                char loseText[64];
-                sprintf(loseText, "Game Over! Code was: %d%d%d%d",
-                        secretCode[0], secretCode[1], secretCode[2], secretCode[3]);
-                DrawTextCentered(loseText, SCREEN_HEIGHT - 100, 26, Colors::DANGER);
-            }
-            DrawTextCentered("Press SPACE to play again", SCREEN_HEIGHT - 60, 18, Colors::TEXT_DIM);
+            DrawTriangle(v1, v2, v3, color);
         }
+    }
 
-        DrawText("Press M or ESC to return to menu", 20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+    void StrokeTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+        renderStats.Primitive(6);
+        CoverTriangle(v1, v2, v3);
+        if (softTarget) {
+            softTarget->Line(v1, v2, 1, color);
+            softTarget->Line(v2, v3, 1, color);
+            softTarget->Line(v3, v1, 1, color);
+        } else {
+            DrawTriangleLines(v1, v2, v3, color);
+        }
     }
-};
+}
 
 // ═══════════════════════════════════════════════════════════════════════════
-// ESCAPE ZOMBIE LAND GAME CLASS
+// SDF UI FONT
 // ═══════════════════════════════════════════════════════════════════════════
 
-class ZombieLandGame {
-private:
-    static const int GRID_SIZE = 10;
-    int playerX, playerY;
-    int zombieX, zombieY;
-    int safeX, safeY;
-    bool gameOver;
-    bool won;
-    float animTime;
-    float cellSize;
-    float offsetX, offsetY;
+// All UI text goes through one signed-distance-field atlas. The atlas is built
+// from a TTF on first run, cached in FONT_CACHE_FILE, and memory-mapped on later
+// starts. When no TTF can be found the default raylib font is used instead.
+const char* FONT_CACHE_FILE = "gamehub_font.sdf";
+const int FONT_SDF_BASE_SIZE = 48;
+const int FONT_GLYPH_COUNT = 95;             // ASCII 32..126
+const uint32_t FONT_CACHE_VERSION = 1;
+
+const char* FONT_TTF_CANDIDATES[] = {
+    "resources/ui_font.ttf",
+    "C:/Windows/Fonts/arialbd.ttf",
+    "C:/Windows/Fonts/segoeuib.ttf",
+    "/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf",
+    "/System/Library/Fonts/Supplemental/Arial Bold.ttf"
+};
 
-public:
-    void Init() {
-        playerX = playerY = 0;
-        zombieX = zombieY = GRID_SIZE / 2;
-        safeX = safeY = GRID_SIZE - 1;
-        gameOver = false;
-        won = false;
-        animTime = 0;
-        cellSize = 50;
-        offsetX = (SCREEN_WIDTH - GRID_SIZE * cellSize) / 2;
-        offsetY = 150;
-    }
+// Alpha holds the distance to the glyph edge (0.5 = on the edge). fwidth()
+// keeps the antialiasing band one screen pixel wide at every size. Untextured
+// shapes sample raylib's white texel (alpha 1) and pass through unchanged, so
+// shapes and text share this shader and batch together.
+const char* SDF_FRAGMENT_SHADER = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+out vec4 finalColor;
+void main() {
+    float dist = texture(texture0, fragTexCoord).a;
+    float width = max(fwidth(dist), 0.0001);
+    float alpha = clamp((dist - 0.5) / width + 0.5, 0.0, 1.0);
+    finalColor = vec4(fragColor.rgb * colDiffuse.rgb, fragColor.a * colDiffuse.a * alpha);
+}
+)";
+
+// On-disk layout: header, glyph table, then the raw GRAY_ALPHA atlas pixels
+struct FontCacheHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t baseSize;
+    int32_t glyphCount;
+    int32_t atlasWidth;
+    int32_t atlasHeight;
+    int32_t atlasFormat;
+};
 
-    void MoveZombie() {
-        int dir = rand() % 4;
-        int newX = zombieX, newY = zombieY;
-        if (dir == 0) newY--;
-        else if (dir == 1) newY++;
-        else if (dir == 2) newX--;
-        else newX++;
+struct FontCacheGlyph {
+    int32_t value, offsetX, offsetY, advanceX;
+    float recX, recY, recWidth, recHeight;
+};
 
-        if (newX >= 0 && newX < GRID_SIZE) zombieX = newX;
-        if (newY >= 0 && newY < GRID_SIZE) zombieY = newY;
-    }
+class UIFont {
+private:
+    Font font;
+    Shader sdfShader;
+    vector<GlyphInfo> glyphs;
+    vector<Rectangle> recs;
+    MappedFile cacheFile;          // Stays mapped in headless mode for CPU text
+    SoftImageView cpuAtlas;
+    bool sdf = false;
+    bool shaderActive = false;
+
+    // Text held back while the scene renders at reduced resolution
+    struct DeferredText {
+        string text;
+        float x, y, fontSize;
+        Color color;
+        float width;                 // Measured when queued, for Cover()
+    };
+    vector<DeferredText> deferred;
+    bool deferring = false;
+
+    bool LoadCache() {
+        MappedFile& file = cacheFile;
+        if (!file.Open(FONT_CACHE_FILE)) return false;
+        // A stale cache must not stay mapped, or BuildCache can't overwrite it on Windows
+        auto reject = [&file]() {
+            file.Close();
+            return false;
+        };
+
+        const unsigned char* data = file.Data();
+        if (file.Size() < sizeof(FontCacheHeader)) return reject();
+        FontCacheHeader header;
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, "GHSF", 4) != 0 || header.version != FONT_CACHE_VERSION) return reject();
+        if (header.atlasFormat != PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA || header.glyphCount <= 0) return reject();
+
+        size_t tableSize = sizeof(FontCacheGlyph) * header.glyphCount;
+        size_t pixelSize = (size_t)header.atlasWidth * header.atlasHeight * 2;
+        if (file.Size() < sizeof(header) + tableSize + pixelSize) return reject();
+
+        glyphs.assign(header.glyphCount, GlyphInfo{});
+        recs.resize(header.glyphCount);
+        const unsigned char* table = data + sizeof(header);
+        for (int i = 0; i < header.glyphCount; i++) {
+            FontCacheGlyph g;
+            memcpy(&g, table + i * sizeof(g), sizeof(g));
+            glyphs[i].value = g.value;
+            glyphs[i].offsetX = g.offsetX;
+            glyphs[i].offsetY = g.offsetY;
+            glyphs[i].advanceX = g.advanceX;
+            recs[i] = {g.recX, g.recY, g.recWidth, g.recHeight};
+        }
 
-    bool Update() {
-        if (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_M)) return true;
+        font.baseSize = header.baseSize;
+        font.glyphCount = header.glyphCount;
+        cpuAtlas = {table + tableSize, header.atlasWidth, header.atlasHeight, 2};
+        if (headless) return true;
 
-        animTime += GetFrameTime();
+        // Upload straight from the mapping, no intermediate heap copy
+        Image atlas = {(void*)(table + tableSize), header.atlasWidth, header.atlasHeight, 1, header.atlasFormat};
+        font.texture = LoadTextureFromImage(atlas);
+        file.Close();
+        return font.texture.id != 0;
+    }
 
-        if (gameOver) {
-            if (IsKeyPressed(KEY_SPACE)) Init();
+    bool BuildCache() {
+        const char* ttfPath = nullptr;
+        for (const char* candidate : FONT_TTF_CANDIDATES) {
+            if (FileExists(candidate)) { ttfPath = candidate; break; }
+        }
+        if (ttfPath == nullptr) {
+            TraceLog(LOG_WARNING, "UIFONT: No TTF found");
             return false;
         }
 
-        bool moved = false;
-        if (IsKeyPressed(KEY_W) || IsKeyPressed(KEY_UP)) { if (playerY > 0) playerY--; moved = true; }
-        if (IsKeyPressed(KEY_S) || IsKeyPressed(KEY_DOWN)) { if (playerY < GRID_SIZE-1) playerY++; moved = true; }
-        if (IsKeyPressed(KEY_A) || IsKeyPressed(KEY_LEFT)) { if (playerX > 0) playerX--; moved = true; }
-        if (IsKeyPressed(KEY_D) || IsKeyPressed(KEY_RIGHT)) { if (playerX < GRID_SIZE-1) playerX++; moved = true; }
-
-        if (moved) {
-            MoveZombie();
-
-            // Check win
-            if (playerX == safeX && playerY == safeY) {
-                won = gameOver = true;
-                ofstream file("zombie_escape_results.txt", ios::app);
-                if (file.is_open()) { file << "Survived!\n"; file.close(); }
+        int dataSize = 0;
+        unsigned char* ttf = LoadFileData(ttfPath, &dataSize);
+        if (ttf == nullptr) return false;
+        // Glyph distance fields are generated in parallel ranges and gathered
+        // into one array that UnloadFontData() can free. MemAlloc() zeroes, so
+        // a range that fails leaves null images behind.
+        int codepoints[FONT_GLYPH_COUNT];
+        for (int i = 0; i < FONT_GLYPH_COUNT; i++) codepoints[i] = 32 + i;
+        GlyphInfo* sdfGlyphs = (GlyphInfo*)MemAlloc(FONT_GLYPH_COUNT * sizeof(GlyphInfo));
+        atomic<bool> failed(false);
+        jobs.ParallelFor(FONT_GLYPH_COUNT, 8, [&](int begin, int end) {
+            GlyphInfo* part = LoadFontData(ttf, dataSize, FONT_SDF_BASE_SIZE, codepoints + begin, end - begin, FONT_SDF);
+            if (part == nullptr) {
+                failed.store(true, memory_order_relaxed);
+                return;
             }
-            // Check lose
-            else if (playerX == zombieX && playerY == zombieY) {
-                gameOver = true;
-                ofstream file("zombie_escape_results.txt", ios::app);
-                if (file.is_open()) { file << "Caught by zombie!\n"; file.close(); }
+            for (int i = begin; i < end; i++) sdfGlyphs[i] = part[i - begin];
+            MemFree(part);                       // The images now belong to sdfGlyphs
+        });
+        UnloadFileData(ttf);
+        if (failed.load()) {
+            UnloadFontData(sdfGlyphs, FONT_GLYPH_COUNT);
+            return false;
+        }
+
+        Rectangle* atlasRecs = nullptr;
+        Image atlas = GenImageFontAtlas(sdfGlyphs, &atlasRecs, FONT_GLYPH_COUNT, FONT_SDF_BASE_SIZE, 0, 1);
+
+        FontCacheHeader header = {{'G', 'H', 'S', 'F'}, FONT_CACHE_VERSION, FONT_SDF_BASE_SIZE,
+                                  FONT_GLYPH_COUNT, atlas.width, atlas.height, atlas.format};
+        ofstream file(FONT_CACHE_FILE, ios::binary);
+        bool written = file.is_open();
+        if (written) {
+            file.write((const char*)&header, sizeof(header));
+            for (int i = 0; i < FONT_GLYPH_COUNT; i++) {
+                FontCacheGlyph g = {sdfGlyphs[i].value, sdfGlyphs[i].offsetX, sdfGlyphs[i].offsetY,
+                                    sdfGlyphs[i].advanceX, atlasRecs[i].x, atlasRecs[i].y,
+                                    atlasRecs[i].width, atlasRecs[i].height};
+                file.write((const char*)&g, sizeof(g));
             }
+            file.write((const char*)atlas.data, (streamsize)atlas.width * atlas.height * 2);
+            file.close();
+            written = file.good();
         }
+        if (!written) TraceLog(LOG_WARNING, "UIFONT: Could not write %s", FONT_CACHE_FILE);
 
-        return false;
+        UnloadImage(atlas);
+        MemFree(atlasRecs);
+        UnloadFontData(sdfGlyphs, FONT_GLYPH_COUNT);
+        return written;
     }
 
-    void Draw() {
-        DrawAnimatedBackground(animTime);
-
-        DrawTextCentered("ESCAPE ZOMBIE LAND", 30, 40, Colors::ACCENT);
-        DrawTextCentered("Reach the Safe Zone! Avoid the Zombie!", 80, 20, Colors::TEXT_DIM);
+public:
+    void Load() {
+        font = GetFontDefault();
+        sdf = false;
+
+        if (LoadCache() || (BuildCache() && LoadCache())) {
+            font.glyphPadding = 0;
+            font.recs = recs.data();
+            font.glyphs = glyphs.data();
+            sdf = true;
+            if (headless) return;
+            SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+            sdfShader = LoadShaderFromMemory(NULL, SDF_FRAGMENT_SHADER);
+        } else {
+            TraceLog(LOG_WARNING, "UIFONT: Falling back to the default font");
+        }
+    }
 
-        // Legend
-        DrawText("You", 100, 120, 18, Colors::SUCCESS);
-        DrawText("Zombie", 200, 120, 18, Colors::DANGER);
-        DrawText("Safe Zone", 320, 120, 18, Colors::ACCENT);
+    void Unload() {
+        EndBatch();
+        if (!sdf) return;
+        if (!headless) {
+            UnloadShader(sdfShader);
+            UnloadTexture(font.texture);
+        }
+        cacheFile.Close();
+        glyphs.clear();
+        recs.clear();
+        sdf = false;
+    }
 
-        // Draw grid
-        for (int y = 0; y < GRID_SIZE; y++) {
-            for (int x = 0; x < GRID_SIZE; x++) {
-                Rectangle cell = {offsetX + x * cellSize, offsetY + y * cellSize, cellSize - 2, cellSize - 2};
+    // False when only raylib's bitmap font is available, which the CPU rasterizer can't draw
+    bool Loaded() const { return sdf; }
 
-                Color cellColor = Colors::CARD_BG;
-                if (x == safeX && y == safeY) cellColor = (Color){255, 215, 0, 100};
+    float Spacing(float fontSize) const {
+        return sdf ? fontSize / 20.0f : fontSize / 10.0f;
+    }
 
-                DrawRectangleRounded(cell, 0.1f, 4, cellColor);
-                DrawRectangleRoundedLines(cell, 0.1f, 4, 1, Colors::PRIMARY);
+    // Mirrors DrawTextEx's layout so both backends place glyphs identically
+    void DrawSoft(const char* text, Vector2 pos, float fontSize, Color color) {
+        if (!sdf) return;
+        float scale = fontSize / font.baseSize;
+        // Atlas distance changes by 64/255 per atlas pixel (raylib's SDF scale)
+        float edgeWidth = (64.0f / 255.0f) / scale;
+        float offsetX = 0;
+        for (const char* c = text; *c; c++) {
+            int index = GetGlyphIndex(font, (unsigned char)*c);
+            const GlyphInfo& g = font.glyphs[index];
+            const Rectangle& r = font.recs[index];
+            if (*c != ' ' && *c != '\t') {
+                Rectangle dest = {pos.x + offsetX + g.offsetX * scale, pos.y + g.offsetY * scale,
+                                  r.width * scale, r.height * scale};
+                softTarget->SdfGlyph(cpuAtlas, r, dest, edgeWidth, color);
             }
+            offsetX += ((g.advanceX == 0) ? r.width : (float)g.advanceX) * scale + Spacing(fontSize);
         }
+    }
 
-        // Draw zombie
-        float zx = offsetX + zombieX * cellSize + cellSize/2;
-        float zy = offsetY + zombieY * cellSize + cellSize/2;
-        float pulse = sin(animTime * 5) * 3;
-        DrawCircle(zx, zy, 18 + pulse, Colors::DANGER);
-        DrawText("Z", zx - 7, zy - 10, 24, WHITE);
+    void Draw(const char* text, float x, float y, float fontSize, Color color) {
+        if (deferring) {
+            deferred.push_back({text, x, y, fontSize, color, (float)Measure(text, fontSize)});
+            return;
+        }
+        int glyphCount = 0;
+        for (const char* c = text; *c; c++) if (*c != ' ') glyphCount++;
+        renderStats.Text(glyphCount);
+        if (sdf && !shaderActive && !softTarget) renderStats.Flush();
+        renderStats.Primitive(glyphCount * 4);
+        if (softTarget) {
+            DrawSoft(text, {floorf(x + 0.5f), floorf(y + 0.5f)}, fontSize, color);
+            return;
+        }
+        if (sdf && !shaderActive) {
+            BeginShaderMode(sdfShader);
+            shaderActive = true;
+        }
+        Vector2 pos = {floorf(x + 0.5f), floorf(y + 0.5f)};
+        DrawTextEx(font, text, pos, fontSize, Spacing(fontSize), color);
+    }
 
-        // Draw safe zone marker
-        float sx = offsetX + safeX * cellSize + cellSize/2;
-        float sy = offsetY + safeY * cellSize + cellSize/2;
-        DrawCircle(sx, sy, 20, Colors::ACCENT);
-        DrawText("S", sx - 7, sy - 10, 24, BLACK);
+    // Same result as MeasureTextEx, but does not need the GPU texture
+    int Measure(const char* text, float fontSize) const {
+        if (font.glyphs == nullptr || *text == 0) return 0;
+        float width = 0;
+        int count = 0;
+        for (const char* c = text; *c; c++, count++) {
+            int index = GetGlyphIndex(font, (unsigned char)*c);
+            const GlyphInfo& g = font.glyphs[index];
+            width += (g.advanceX != 0) ? g.advanceX : font.recs[index].width + g.offsetX;
+        }
+        return (int)(width * fontSize / font.baseSize + (count - 1) * Spacing(fontSize));
+    }
 
-        // Draw player
-        float px = offsetX + playerX * cellSize + cellSize/2;
-        float py = offsetY + playerY * cellSize + cellSize/2;
-        DrawCircle(px, py, 18, Colors::SUCCESS);
-        DrawText("P", px - 7, py - 10, 24, WHITE);
+    // Queue text instead of drawing it, until EndDeferral() replays it
+    void BeginDeferral() {
+        deferring = true;
+        deferred.clear();
+    }
 
-        // Result
-        if (gameOver) {
-            DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, 180});
-            if (won) {
-                DrawTextCentered("YOU ESCAPED!", SCREEN_HEIGHT/2 - 40, 50, Colors::SUCCESS);
-            } else {
-                DrawTextCentered("CAUGHT BY ZOMBIE!", SCREEN_HEIGHT/2 - 40, 50, Colors::DANGER);
-            }
-            DrawTextCentered("Press SPACE to play again", SCREEN_HEIGHT/2 + 30, 20, Colors::TEXT_DIM);
+    void EndDeferral() {
+        deferring = false;
+        for (const DeferredText& t : deferred) Draw(t.text.c_str(), t.x, t.y, t.fontSize, t.color);
+        deferred.clear();
+    }
+
+    // Something is about to be drawn over the area. Queued text under it has
+    // to go into the scene first, at scene resolution, or it would end up on
+    // top; everything queued before that goes too, so the order holds.
+    void Cover(float x, float y, float width, float height) {
+        if (!deferring || deferred.empty()) return;
+        int last = -1;
+        for (int i = 0; i < (int)deferred.size(); i++) {
+            const DeferredText& t = deferred[i];
+            if (x < t.x + t.width && t.x < x + width && y < t.y + t.fontSize && t.y < y + height) last = i;
         }
+        if (last < 0) return;
+        deferring = false;
+        for (int i = 0; i <= last; i++) {
+            const DeferredText& t = deferred[i];
+            Draw(t.text.c_str(), t.x, t.y, t.fontSize, t.color);
+        }
+        deferring = true;
+        deferred.erase(deferred.begin(), deferred.begin() + last + 1);
+    }
 
-        DrawText("Move: WASD or Arrow Keys | Press M to return to menu",
-                 20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+    // Textured sprites must not go through the SDF shader; anything that draws
+    // one calls this first. Shapes and text keep batching until then.
+    void EndBatch() {
+        if (!shaderActive || softTarget) return;
+        renderStats.Flush();
+        EndShaderMode();
+        shaderActive = false;
     }
 };
 
+UIFont uiFont;
+
+void DrawUIText(const char* text, float x, float y, float fontSize, Color color) {
+    uiFont.Draw(text, x, y, fontSize, color);
+}
+
+int MeasureUIText(const char* text, float fontSize) {
+    return uiFont.Measure(text, fontSize);
+}
+
+void CoverDeferredText(float x, float y, float width, float height) {
+    uiFont.Cover(x, y, width, height);
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
-// SWAP CARDS GAME CLASS
+// DYNAMIC RESOLUTION
 // ═══════════════════════════════════════════════════════════════════════════
 
-class SwapCardsGame {
+// The scene is drawn into the corner of a full-size render texture through a
+// smaller viewport, then stretched over the window. The projection stays at
+// SCREEN_WIDTH x SCREEN_HEIGHT, so game code and mouse coordinates are
+// unchanged. Text is deferred and drawn afterwards at native resolution,
+// unless something in the scene is drawn over it. The scale follows the GPU
+// time of the scene pass, not the frame interval: on a display slower than
+// the target rate every interval is long, however light the frame.
+const float DRS_MIN_SCALE = 0.5f;
+const float DRS_MAX_SCALE = 1.0f;
+const float DRS_STEP_DOWN = 0.1f;
+const float DRS_STEP_UP = 0.05f;
+const float DRS_HIGH = 0.75f;            // Scene GPU time, as a share of the frame budget, that
+const float DRS_LOW = 0.6f;              // drops the scale, and that a step up must stay under
+const int DRS_COOLDOWN_FRAMES = 30;      // Frames to settle after a change
+
+// GL_TIME_ELAPSED queries, read a few frames late so the CPU never waits on
+// the GPU. raylib doesn't expose its GL loader, so the entry points come from
+// GLFW, which it links in. Without timer queries (GL ES 2) it stays unloaded.
+typedef void (*GlProc)(void);
+extern "C" GlProc glfwGetProcAddress(const char* name);
+#if defined(_WIN32)
+#define GPU_TIMER_CALL __stdcall
+#else
+#define GPU_TIMER_CALL
+#endif
+
+class GpuTimer {
 private:
-    char cards[16];
-    bool revealed[16];
-    bool matched[16];
-    int firstCard, secondCard;
-    int matches, moves;
-    bool gameOver;
-    float animTime;
-    float revealTimer;
-    float cardWidth, cardHeight;
-    float offsetX, offsetY;
+    static const int FRAMES = 4;
+    static const unsigned int TIME_ELAPSED = 0x88BF, QUERY_RESULT = 0x8866, QUERY_RESULT_AVAILABLE = 0x8867;
+    typedef void (GPU_TIMER_CALL* GenQueries)(int, unsigned int*);
+    typedef void (GPU_TIMER_CALL* BeginQuery)(unsigned int, unsigned int);
+    typedef void (GPU_TIMER_CALL* EndQuery)(unsigned int);
+    typedef void (GPU_TIMER_CALL* GetQueryObjectiv)(unsigned int, unsigned int, int*);
+    typedef void (GPU_TIMER_CALL* GetQueryObjectui64v)(unsigned int, unsigned int, uint64_t*);
+
+    GenQueries genQueries = nullptr, deleteQueries = nullptr;
+    BeginQuery beginQuery = nullptr;
+    EndQuery endQuery = nullptr;
+    GetQueryObjectiv getQueryObjectiv = nullptr;
+    GetQueryObjectui64v getQueryObjectui64v = nullptr;
+    unsigned int queries[FRAMES] = {};
+    bool pending[FRAMES] = {};
+    int next = 0;                    // Oldest query, and the one to issue next
+    bool running = false;
+    float latest = -1;
 
 public:
-    void Init() {
-        char symbols[8] = {'A','B','C','D','E','F','G','H'};
-        int idx = 0;
+    bool Load() {
+        genQueries = (GenQueries)glfwGetProcAddress("glGenQueries");
+        deleteQueries = (GenQueries)glfwGetProcAddress("glDeleteQueries");
+        beginQuery = (BeginQuery)glfwGetProcAddress("glBeginQuery");
+        endQuery = (EndQuery)glfwGetProcAddress("glEndQuery");
+        getQueryObjectiv = (GetQueryObjectiv)glfwGetProcAddress("glGetQueryObjectiv");
+        getQueryObjectui64v = (GetQueryObjectui64v)glfwGetProcAddress("glGetQueryObjectui64v");
+        if (!genQueries || !deleteQueries || !beginQuery || !endQuery || !getQueryObjectiv || !getQueryObjectui64v) {
+            genQueries = nullptr;
+            return false;
+        }
+        genQueries(FRAMES, queries);
+        return true;
+    }
+
+    void Unload() {
+        if (genQueries) deleteQueries(FRAMES, queries);
+        genQueries = nullptr;
+    }
+
+    // Collect finished queries oldest first, then start timing unless every query is still in flight
+    void Begin() {
+        if (!genQueries) return;
+        for (int i = 0; i < FRAMES; i++) {
+            int q = (next + i) % FRAMES;
+            if (!pending[q]) continue;
+            int ready = 0;
+            getQueryObjectiv(queries[q], QUERY_RESULT_AVAILABLE, &ready);
+            if (!ready) break;
+            uint64_t ns = 0;
+            getQueryObjectui64v(queries[q], QUERY_RESULT, &ns);
+            latest = (float)(ns * 1e-9);
+            pending[q] = false;
+        }
+        if (pending[next]) return;
+        beginQuery(TIME_ELAPSED, queries[next]);
+        running = true;
+    }
+
+    void End() {
+        if (!running) return;
+        endQuery(TIME_ELAPSED);
+        pending[next] = true;
+        next = (next + 1) % FRAMES;
+        running = false;
+    }
+
+    // Seconds of the newest finished measurement, or negative before the first
+    float Latest() const { return latest; }
+};
+
+class DynamicResolution {
+private:
+    RenderTexture2D target;
+    GpuTimer sceneTimer;
+    bool loaded = false;
+    bool timed = false;              // Timer queries work; otherwise the scale stays at full
+    float scale = DRS_MAX_SCALE;
+    float sceneAvg = 0;
+    int cooldown = 0;
+
+    int ScaledWidth() const { return max(1, (int)(SCREEN_WIDTH * scale + 0.5f)); }
+    int ScaledHeight() const { return max(1, (int)(SCREEN_HEIGHT * scale + 0.5f)); }
+
+public:
+    bool enabled = true;
+
+    void Load() {
+        if (loaded || headless) return;
+        target = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
+        SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+        timed = sceneTimer.Load();
+        if (!timed) TraceLog(LOG_WARNING, "DRS: No GPU timer queries, rendering at full resolution");
+        loaded = true;
+    }
+
+    void Unload() {
+        if (!loaded) return;
+        sceneTimer.Unload();
+        UnloadRenderTexture(target);
+        loaded = false;
+    }
+
+    float Scale() const { return enabled ? scale : 1.0f; }
+
+    // Once a frame, with the frame budget in seconds. Drops resolution when
+    // the scene takes most of the budget on the GPU, and raises it again only
+    // when the scene would still fit at the next step up (cost goes with the
+    // pixel count), waiting a moment after each change.
+    void Update(float budget) {
+        if (!timed || !enabled || sceneTimer.Latest() < 0) return;
+        sceneAvg = sceneAvg * 0.9f + sceneTimer.Latest() * 0.1f;
+        if (cooldown > 0) { cooldown--; return; }
+
+        float up = min(DRS_MAX_SCALE, scale + DRS_STEP_UP);
+        if (sceneAvg > budget * DRS_HIGH && scale > DRS_MIN_SCALE) {
+            scale = max(DRS_MIN_SCALE, scale - DRS_STEP_DOWN);
+            cooldown = DRS_COOLDOWN_FRAMES;
+        } else if (scale < DRS_MAX_SCALE && sceneAvg * (up * up) / (scale * scale) < budget * DRS_LOW) {
+            scale = up;
+            cooldown = DRS_COOLDOWN_FRAMES;
+        }
+    }
+
+    void BeginScene() {
+        if (!loaded || !enabled) return;
+        BeginTextureMode(target);
+        renderStats.Flush();
+        sceneTimer.Begin();
+        rlViewport(0, 0, ScaledWidth(), ScaledHeight());
+        uiFont.BeginDeferral();
+    }
+
+    // Upscale the scene to the window, then draw the deferred text on top
+    void EndScene() {
+        if (!loaded || !enabled) return;
+        uiFont.EndBatch();
+        EndTextureMode();            // Submits the scene batch, inside the query
+        sceneTimer.End();
+        renderStats.Flush();
+
+        // Render textures are bottom-up: the viewport sits in the first rows
+        Rectangle source = {0, 0, (float)ScaledWidth(), -(float)ScaledHeight()};
+        Rectangle dest = {0, 0, (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT};
+        renderStats.Primitive(4);
+        DrawTexturePro(target.texture, source, dest, {0, 0}, 0, WHITE);
+        uiFont.EndDeferral();
+    }
+};
+
+DynamicResolution dynamicResolution;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME PACING
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Replaces SetTargetFPS. Frames are scheduled against absolute deadlines on the
+// monotonic clock: the pacer sleeps while the deadline is far away and spins
+// for the last stretch, so OS sleep granularity never shows up as jitter. The
+// spin margin adapts to how late sleeps actually wake up on this machine.
+//
+// In low-latency mode main() does EndDrawing()'s work itself: it presents,
+// waits for the deadline and only then polls input, so the next Update() sees
+// input that is as fresh as possible.
+const int PACING_HISTOGRAM_BINS = 500;          // 0.1 ms bins up to 50 ms
+const float PACING_BIN_MS = 0.1f;
+
+class FramePacer {
+private:
+    using Clock = chrono::steady_clock;
+    Clock::time_point deadline;
+    Clock::time_point lastFrame;
+    Clock::duration period;
+    double spinMarginMs = 2.0;
+    bool started = false;
+    int histogram[PACING_HISTOGRAM_BINS + 1] = {};   // Last bin collects overflow
+    int samples = 0;
+    double intervalSumMs = 0;
+    double lastIntervalMs = 0;
+
+    void Record(double ms) {
+        int bin = (int)(ms / PACING_BIN_MS);
+        histogram[min(max(bin, 0), PACING_HISTOGRAM_BINS)]++;
+        samples++;
+        intervalSumMs += ms;
+        lastIntervalMs = ms;
+    }
+
+public:
+    int targetHz = 60;
+    bool lowLatency = false;
+
+    void SetTarget(int hz) {
+        targetHz = max(1, hz);
+        period = chrono::duration_cast<Clock::duration>(chrono::duration<double>(1.0 / targetHz));
+        started = false;
+    }
+
+    float Budget() const { return 1.0f / targetHz; }
+
+    // Seconds between the last two deadlines; stands in for GetFrameTime(),
+    // which only EndDrawing() advances
+    float FrameTime() const { return (float)(lastIntervalMs / 1000.0); }
+
+    // Block until the next frame deadline
+    void Wait() {
+        Clock::time_point now = Clock::now();
+        if (!started) {
+            SetTarget(targetHz);
+            deadline = now + period;
+            lastFrame = now;
+            started = true;
+            return;
+        }
+
+        // Sleep in short slices until close to the deadline, learning how far
+        // past the requested time each sleep actually returns
+        while (true) {
+            double remainingMs = chrono::duration<double, milli>(deadline - Clock::now()).count();
+            if (remainingMs <= spinMarginMs) break;
+            Clock::time_point sleepStart = Clock::now();
+            double requestMs = min(remainingMs - spinMarginMs, 4.0);
+            this_thread::sleep_for(chrono::duration<double, milli>(requestMs));
+            double overshootMs = chrono::duration<double, milli>(Clock::now() - sleepStart).count() - requestMs;
+            spinMarginMs = max(0.5, min(4.0, spinMarginMs * 0.95 + max(overshootMs, 0.0) * 1.5 * 0.05));
+        }
+        while (Clock::now() < deadline) {
+            // Spin for the final fraction of a millisecond
+        }
+
+        now = Clock::now();
+        Record(chrono::duration<double, milli>(now - lastFrame).count());
+        lastFrame = now;
+
+        // Keep a fixed cadence; after a long stall restart from now instead of
+        // rushing several frames to catch up
+        deadline += period;
+        if (now - deadline > period) deadline = now + period;
+    }
+
+    // Frame interval below which the given fraction (0..1) of frames fall
+    float PercentileMs(float fraction) const {
+        if (samples == 0) return 0;
+        int wanted = (int)ceilf(fraction * samples);
+        int seen = 0;
+        for (int i = 0; i <= PACING_HISTOGRAM_BINS; i++) {
+            seen += histogram[i];
+            if (seen >= wanted) return (i + 1) * PACING_BIN_MS;
+        }
+        return PACING_HISTOGRAM_BINS * PACING_BIN_MS;
+    }
+
+    float MeanMs() const { return samples ? (float)(intervalSumMs / samples) : 0; }
+    int Samples() const { return samples; }
+    const int* Histogram() const { return histogram; }
+
+    void ResetHistogram() {
+        for (int& h : histogram) h = 0;
+        samples = 0;
+        intervalSumMs = 0;
+    }
+};
+
+FramePacer framePacer;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INPUT EVENTS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Game Update() code reads gameInput instead of raylib, so it can run on a
+// thread other than the one that owns the window. The window thread turns
+// raylib's polled state into edge events and pushes them through a
+// single-producer/single-consumer queue; the simulation drains them once per
+// tick.
+const int INPUT_KEY_COUNT = KEY_KB_MENU + 1;
+const int INPUT_MOUSE_BUTTONS = 3;
+const int INPUT_QUEUE_SIZE = 256;               // Must be a power of two
+
+enum InputEventType : uint8_t {
+    INPUT_KEY_DOWN,
+    INPUT_KEY_UP,
+    INPUT_MOUSE_MOVE,
+    INPUT_MOUSE_DOWN,
+    INPUT_MOUSE_UP
+};
+
+struct InputEvent {
+    InputEventType type;
+    int code;               // Key or mouse button
+    float x, y;             // Mouse position for INPUT_MOUSE_MOVE
+};
+
+// Lock-free ring buffer for exactly one producer thread and one consumer thread
+template <typename T, int N>
+class SpscQueue {
+private:
+    static_assert((N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+    T items[N];
+    alignas(64) atomic<uint32_t> head{0};       // Next slot to read (consumer)
+    alignas(64) atomic<uint32_t> tail{0};       // Next slot to write (producer)
+
+public:
+    bool Push(const T& item) {
+        uint32_t t = tail.load(memory_order_relaxed);
+        if (t - head.load(memory_order_acquire) == (uint32_t)N) return false;
+        items[t & (N - 1)] = item;
+        tail.store(t + 1, memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& item) {
+        uint32_t h = head.load(memory_order_relaxed);
+        if (h == tail.load(memory_order_acquire)) return false;
+        item = items[h & (N - 1)];
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+};
+
+// Keyboard and mouse state as seen by one simulation tick
+class InputState {
+private:
+    bool down[INPUT_KEY_COUNT] = {};
+    bool pressed[INPUT_KEY_COUNT] = {};
+    bool mouseDown[INPUT_MOUSE_BUTTONS] = {};
+    bool mousePressed[INPUT_MOUSE_BUTTONS] = {};
+    Vector2 mouse = {0, 0};
+
+public:
+    // Pressed flags only last for the tick that received the event
+    void BeginTick() {
+        memset(pressed, 0, sizeof(pressed));
+        memset(mousePressed, 0, sizeof(mousePressed));
+    }
+
+    void Apply(const InputEvent& e) {
+        bool key = e.code >= 0 && e.code < INPUT_KEY_COUNT;
+        bool button = e.code >= 0 && e.code < INPUT_MOUSE_BUTTONS;
+        switch (e.type) {
+            case INPUT_KEY_DOWN: if (key) down[e.code] = pressed[e.code] = true; break;
+            case INPUT_KEY_UP: if (key) down[e.code] = false; break;
+            case INPUT_MOUSE_MOVE: mouse = {e.x, e.y}; break;
+            case INPUT_MOUSE_DOWN: if (button) mouseDown[e.code] = mousePressed[e.code] = true; break;
+            case INPUT_MOUSE_UP: if (button) mouseDown[e.code] = false; break;
+        }
+    }
+
+    bool KeyPressed(int key) const { return key > 0 && key < INPUT_KEY_COUNT && pressed[key]; }
+    bool KeyDown(int key) const { return key > 0 && key < INPUT_KEY_COUNT && down[key]; }
+    bool MousePressed(int button) const { return button >= 0 && button < INPUT_MOUSE_BUTTONS && mousePressed[button]; }
+    Vector2 MousePosition() const { return mouse; }
+};
+
+// Only ever touched by the thread running the simulation
+InputState gameInput;
+
+// Carries input from the window thread to the simulation
+class InputBridge {
+private:
+    SpscQueue<InputEvent, INPUT_QUEUE_SIZE> queue;
+    Vector2 lastMouse = {-1, -1};
+    atomic<int> dropped{0};
+
+    void Send(InputEventType type, int code, float x = 0, float y = 0) {
+        if (!queue.Push({type, code, x, y})) dropped.fetch_add(1, memory_order_relaxed);
+    }
+
+public:
+    // Window thread, after raylib has polled events (in EndDrawing(), or in
+    // main() itself in low-latency mode)
+    void Collect() {
+        for (int key = 1; key < INPUT_KEY_COUNT; key++) {
+            if (IsKeyPressed(key)) Send(INPUT_KEY_DOWN, key);
+            else if (IsKeyReleased(key)) Send(INPUT_KEY_UP, key);
+        }
+
+        // The move goes first so a click in the same frame lands where it happened
+        Vector2 m = GetMousePosition();
+        if (m.x != lastMouse.x || m.y != lastMouse.y) {
+            Send(INPUT_MOUSE_MOVE, 0, m.x, m.y);
+            lastMouse = m;
+        }
+        for (int b = 0; b < INPUT_MOUSE_BUTTONS; b++) {
+            if (IsMouseButtonPressed(b)) Send(INPUT_MOUSE_DOWN, b);
+            else if (IsMouseButtonReleased(b)) Send(INPUT_MOUSE_UP, b);
+        }
+    }
+
+    // Simulation thread, at the start of each tick
+    void Drain(InputState& state) {
+        state.BeginTick();
+        InputEvent e;
+        while (queue.Pop(e)) state.Apply(e);
+    }
+
+    int Dropped() const { return dropped.load(memory_order_relaxed); }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TWEENS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Animated values for UI transitions. A TweenPool owns a fixed set of float
+// channels (card flip angles, overlay fades, hover growth) and a fixed pool of
+// tweens that drive them. Active tweens are packed into parallel arrays and
+// advanced in a single pass per frame; nothing is heap-allocated after
+// construction and nothing points into the owner, so a pool can be copied
+// into a render snapshot along with its game.
+//
+// Completion callbacks are plain function pointers that receive the owner
+// passed to Update() plus an integer tag, so no closure is ever stored.
+enum Easing : unsigned char {
+    EASE_LINEAR,
+    EASE_IN_QUAD,
+    EASE_OUT_QUAD,
+    EASE_IN_OUT_QUAD,
+    EASE_OUT_CUBIC,
+    EASE_IN_OUT_SINE,
+    EASE_OUT_BACK
+};
+
+inline float Ease(Easing easing, float u) {
+    switch (easing) {
+        case EASE_LINEAR: return u;
+        case EASE_IN_QUAD: return u * u;
+        case EASE_OUT_QUAD: return u * (2 - u);
+        case EASE_IN_OUT_QUAD: return (u < 0.5f) ? 2 * u * u : 1 - 2 * (1 - u) * (1 - u);
+        case EASE_OUT_CUBIC: { float v = 1 - u; return 1 - v * v * v; }
+        case EASE_IN_OUT_SINE: return 0.5f - 0.5f * cosf(PI * u);
+        case EASE_OUT_BACK: { float v = u - 1; return 1 + v * v * (2.70158f * v + 1.70158f); }
+    }
+    return u;
+}
+
+typedef void (*TweenCallback)(void* owner, int tag);
+
+const unsigned char TWEEN_STARTED = 1;      // 'from' has been captured
+const unsigned char TWEEN_PINGPONG = 2;     // Runs back and forth until cancelled
+const unsigned char TWEEN_DONE = 4;
+const int TWEEN_NO_CHANNEL = -1;            // Timer that only fires its callback
+
+template <int MaxTweens, int Channels>
+class TweenPool {
+private:
+    // Active tweens, packed at the front of every array
+    float elapsed[MaxTweens];               // Negative while still delayed
+    float invDuration[MaxTweens];
+    float from[MaxTweens];
+    float to[MaxTweens];
+    Easing easing[MaxTweens];
+    unsigned char flags[MaxTweens];
+    short channel[MaxTweens];
+    TweenCallback callback[MaxTweens];
+    int tag[MaxTweens];
+    int count = 0;
+
+    float values[Channels] = {};
+
+    struct Finished { TweenCallback callback; int tag; };
+    Finished finished[MaxTweens];
+
+    void Move(int dst, int src) {
+        elapsed[dst] = elapsed[src]; invDuration[dst] = invDuration[src];
+        from[dst] = from[src]; to[dst] = to[src];
+        easing[dst] = easing[src]; flags[dst] = flags[src]; channel[dst] = channel[src];
+        callback[dst] = callback[src]; tag[dst] = tag[src];
+    }
+
+    bool Add(int ch, float target, float duration, Easing e, float delay, TweenCallback cb, int cbTag,
+             unsigned char extraFlags) {
+        if (count >= MaxTweens) return false;
+        int i = count++;
+        elapsed[i] = -delay;
+        invDuration[i] = 1.0f / max(duration, 0.0001f);
+        from[i] = (ch >= 0) ? values[ch] : 0;
+        to[i] = target;
+        easing[i] = e;
+        flags[i] = extraFlags;
+        channel[i] = (short)ch;
+        callback[i] = cb;
+        tag[i] = cbTag;
+        return true;
+    }
+
+public:
+    // Steps on one timeline, each starting where the previous one ended
+    class Sequence {
+    private:
+        TweenPool* pool;
+        float at = 0;           // End of the timeline so far
+        float stepStart = 0;    // Start of the last To() step
+
+    public:
+        explicit Sequence(TweenPool* owner) : pool(owner) {}
+
+        Sequence& To(int ch, float target, float duration, Easing e = EASE_IN_OUT_QUAD) {
+            pool->Add(ch, target, duration, e, at, nullptr, 0, 0);
+            stepStart = at;
+            at += duration;
+            return *this;
+        }
+
+        // Starts together with the previous To() instead of after it
+        Sequence& With(int ch, float target, float duration, Easing e = EASE_IN_OUT_QUAD) {
+            pool->Add(ch, target, duration, e, stepStart, nullptr, 0, 0);
+            at = max(at, stepStart + duration);
+            return *this;
+        }
+
+        Sequence& Wait(float seconds) {
+            at += seconds;
+            return *this;
+        }
+
+        Sequence& Call(TweenCallback cb, int cbTag = 0) {
+            pool->Add(TWEEN_NO_CHANNEL, 0, 0, EASE_LINEAR, at, cb, cbTag, 0);
+            return *this;
+        }
+    };
+
+    Sequence Begin() { return Sequence(this); }
+
+    // Animate a channel from its current value, replacing whatever drove it.
+    // A negative delay starts the tween part of the way through.
+    bool To(int ch, float target, float duration, Easing e = EASE_IN_OUT_QUAD, float delay = 0,
+            TweenCallback cb = nullptr, int cbTag = 0) {
+        Cancel(ch);
+        return Add(ch, target, duration, e, delay, cb, cbTag, 0);
+    }
+
+    // Swing a channel between two values until cancelled
+    bool PingPong(int ch, float a, float b, float halfPeriod, Easing e = EASE_IN_OUT_SINE, float delay = 0) {
+        Cancel(ch);
+        values[ch] = a;
+        return Add(ch, b, halfPeriod, e, delay, nullptr, 0, TWEEN_PINGPONG);
+    }
+
+    // Stop every tween on a channel, leaving the value where it is
+    void Cancel(int ch) {
+        int write = 0;
+        for (int i = 0; i < count; i++) {
+            if (channel[i] == ch) continue;
+            if (write != i) Move(write, i);
+            write++;
+        }
+        count = write;
+    }
+
+    void Set(int ch, float value) {
+        Cancel(ch);
+        values[ch] = value;
+    }
+
+    void Clear() {
+        count = 0;
+        for (int c = 0; c < Channels; c++) values[c] = 0;
+    }
+
+    float Value(int ch) const { return values[ch]; }
+
+    bool Animating(int ch) const {
+        for (int i = 0; i < count; i++) if (channel[i] == ch) return true;
+        return false;
+    }
+
+    int Active() const { return count; }
+
+    void Update(float dt, void* owner) {
+        // Advance everything in one pass over the packed arrays
+        bool anyDone = false;
+        for (int i = 0; i < count; i++) {
+            float t = elapsed[i] + dt;
+            elapsed[i] = t;
+            if (t < 0) continue;
+            int ch = channel[i];
+            if (!(flags[i] & TWEEN_STARTED)) {
+                flags[i] |= TWEEN_STARTED;
+                if (ch >= 0) from[i] = values[ch];
+            }
+            float u = t * invDuration[i];
+            if (u >= 1) {
+                if (flags[i] & TWEEN_PINGPONG) {
+                    float a = from[i];
+                    from[i] = to[i];
+                    to[i] = a;
+                    elapsed[i] = t - 1 / invDuration[i];
+                    u = min(elapsed[i] * invDuration[i], 1.0f);
+                } else {
+                    u = 1;
+                    flags[i] |= TWEEN_DONE;
+                    anyDone = true;
+                }
+            }
+            if (ch >= 0) values[ch] = from[i] + (to[i] - from[i]) * Ease(easing[i], u);
+        }
+        if (!anyDone) return;
+
+        // Remove finished tweens in order, then run their callbacks; a
+        // callback may start new tweens
+        int finishedCount = 0;
+        int write = 0;
+        for (int i = 0; i < count; i++) {
+            if (flags[i] & TWEEN_DONE) {
+                if (callback[i]) finished[finishedCount++] = {callback[i], tag[i]};
+                continue;
+            }
+            if (write != i) Move(write, i);
+            write++;
+        }
+        count = write;
+        for (int i = 0; i < finishedCount; i++) finished[i].callback(owner, finished[i].tag);
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// OBJECT POOLS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Fixed-capacity storage for short-lived game objects (projectiles, asteroid
+// fragments, debris). Free slots form an intrusive list, so Acquire() and
+// Release() are O(1) and never touch the heap. A handle packs the slot with a
+// generation count that changes on every release, so a handle kept after its
+// object died resolves to nullptr rather than to whatever reused the slot.
+typedef int PoolHandle;
+const PoolHandle POOL_NO_HANDLE = -1;
+
+template <typename T, int Capacity>
+class Pool {
+private:
+    static_assert(Capacity > 0 && Capacity <= 0x10000, "Pool slots must fit in 16 bits");
+    static const int LIVE = -2;                  // nextFree value of a slot in use
+
+    T items[Capacity];
+    uint16_t generation[Capacity] = {};
+    int nextFree[Capacity] = {};
+    int freeHead;
+    int live;
+    int peak = 0;                                // The counters cover the pool's whole life
+    int acquired = 0;
+    int refused = 0;                             // Acquire() calls made while full
+
+    static PoolHandle MakeHandle(int slot, int gen) { return ((gen & 0x7FFF) << 16) | slot; }
+
+    bool Valid(PoolHandle handle) const {
+        int slot = handle & 0xFFFF;
+        return handle >= 0 && slot < Capacity && nextFree[slot] == LIVE && (generation[slot] & 0x7FFF) == (handle >> 16);
+    }
+
+public:
+    Pool() { Clear(); }
+
+    // Free every slot. Handles to the old objects go stale.
+    void Clear() {
+        for (int i = 0; i < Capacity; i++) {
+            if (nextFree[i] == LIVE) generation[i]++;
+            nextFree[i] = i + 1;
+        }
+        nextFree[Capacity - 1] = -1;
+        freeHead = 0;
+        live = 0;
+    }
+
+    // New value-initialised object, or POOL_NO_HANDLE when the pool is full
+    PoolHandle Acquire() {
+        if (freeHead < 0) {
+            refused++;
+            return POOL_NO_HANDLE;
+        }
+        int slot = freeHead;
+        freeHead = nextFree[slot];
+        nextFree[slot] = LIVE;
+        items[slot] = T{};
+        live++;
+        acquired++;
+        peak = max(peak, live);
+        return MakeHandle(slot, generation[slot]);
+    }
+
+    void Release(PoolHandle handle) {
+        if (!Valid(handle)) return;
+        int slot = handle & 0xFFFF;
+        generation[slot]++;
+        nextFree[slot] = freeHead;
+        freeHead = slot;
+        live--;
+    }
+
+    T* Get(PoolHandle handle) { return Valid(handle) ? &items[handle & 0xFFFF] : nullptr; }
+    const T* Get(PoolHandle handle) const { return Valid(handle) ? &items[handle & 0xFFFF] : nullptr; }
+
+    // Object in a slot, or nullptr if the slot is free; for splitting work by slot range
+    const T* AtSlot(int slot) const { return (nextFree[slot] == LIVE) ? &items[slot] : nullptr; }
+
+    // Call fn(handle, object) for every live object in slot order. fn may
+    // release the object it is given; objects acquired during the walk may or
+    // may not be visited.
+    template <typename Fn>
+    void ForEach(Fn fn) {
+        for (int slot = 0; slot < Capacity; slot++) {
+            if (nextFree[slot] == LIVE) fn(MakeHandle(slot, generation[slot]), items[slot]);
+        }
+    }
+
+    int Count() const { return live; }
+    int Peak() const { return peak; }
+    int Acquired() const { return acquired; }
+    int Refused() const { return refused; }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UTILITY FUNCTIONS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Scale a colour's alpha, for fading elements in and out
+inline Color Faded(Color c, float alpha) {
+    return {c.r, c.g, c.b, (unsigned char)(c.a * min(max(alpha, 0.0f), 1.0f))};
+}
+
+// Draw text centered horizontally
+void DrawTextCentered(const char* text, int y, int fontSize, Color color) {
+    renderStats.CenteredText();
+    int width = MeasureUIText(text, fontSize);
+    DrawUIText(text, (SCREEN_WIDTH - width) / 2, y, fontSize, color);
+}
+
+// Draw a rounded button and return true if clicked
+bool DrawButton(Rectangle rect, const char* text, Color bgColor, Color hoverColor, int fontSize = 24) {
+    renderStats.Button();
+    Vector2 mouse = GetMousePosition();
+    bool hover = CheckCollisionPointRec(mouse, rect);
+    bool clicked = hover && IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+    
+    Color color = hover ? hoverColor : bgColor;
+    Gfx::FillRoundedRect(rect, 0.3f, 8, color);
+    Gfx::StrokeRoundedRect(rect, 0.3f, 8, 2, WHITE);
+    
+    int textWidth = MeasureUIText(text, fontSize);
+    DrawUIText(text, rect.x + (rect.width - textWidth) / 2, 
+             rect.y + (rect.height - fontSize) / 2, fontSize, WHITE);
+    
+    return clicked;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BACKGROUND PARTICLES
+// ═══════════════════════════════════════════════════════════════════════════
+
+const int BACKGROUND_PARTICLES = 50;           // Default; --bg-particles picks another
+const int MAX_BACKGROUND_PARTICLES = 8192;   // One rlgl batch worth of quads
+
+// Floating dots shared by the menu and the games. State is kept as parallel
+// arrays and advanced by dt, and the whole field is submitted as a single quad
+// batch from one small sprite texture.
+class BackgroundParticles {
+private:
+    vector<float> x, y;
+    vector<float> speed;
+    vector<float> radius;
+    vector<unsigned char> alpha;
+    int count = 0;
+    Texture2D sprite;
+    bool loaded = false;
+
+public:
+    void Init(int particleCount) {
+        count = min(max(particleCount, 0), MAX_BACKGROUND_PARTICLES);
+        x.resize(count); y.resize(count);
+        speed.resize(count); radius.resize(count); alpha.resize(count);
+
+        // Same spread as the original fixed pattern, extended to any count
+        for (int i = 0; i < count; i++) {
+            x[i] = (float)((i * 73) % SCREEN_WIDTH);
+            y[i] = (float)((i * 50) % SCREEN_HEIGHT);
+            speed[i] = 20;
+            radius[i] = 2 + (i % 3);
+            alpha[i] = 50 + (i % 100);
+        }
+    }
+
+    void Load() {
+        if (loaded || headless) return;
+        Image img = GenImageColor(16, 16, BLANK);
+        ImageDrawCircle(&img, 8, 8, 7, WHITE);
+        sprite = LoadTextureFromImage(img);
+        UnloadImage(img);
+        SetTextureFilter(sprite, TEXTURE_FILTER_BILINEAR);
+        loaded = true;
+    }
+
+    void Unload() {
+        if (!loaded) return;
+        UnloadTexture(sprite);
+        loaded = false;
+    }
+
+    void Update(float dt) {
+        float h = (float)SCREEN_HEIGHT;
+        float* py = y.data();
+        const float* ps = speed.data();
+        for (int i = 0; i < count; i++) {
+            float v = py[i] + ps[i] * dt;
+            py[i] = (v >= h) ? v - h : v;
+        }
+    }
+
+    void Draw() const {
+        if (softTarget) {
+            for (int i = 0; i < count; i++) Gfx::FillCircle(x[i], y[i], radius[i], (Color){100, 149, 237, alpha[i]});
+            return;
+        }
+        if (!loaded || count == 0) return;
+        uiFont.EndBatch();
+        uiFont.Cover(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);       // Dots all over the screen
+        renderStats.Primitive(count * 4);
+        rlCheckRenderBatchLimit(count * 4);
+        rlSetTexture(sprite.id);
+        rlBegin(RL_QUADS);
+        rlNormal3f(0, 0, 1);
+        for (int i = 0; i < count; i++) {
+            float r = radius[i];
+            float x0 = x[i] - r, y0 = y[i] - r;
+            float x1 = x[i] + r, y1 = y[i] + r;
+            rlColor4ub(100, 149, 237, alpha[i]);
+            rlTexCoord2f(0, 0); rlVertex2f(x0, y0);
+            rlTexCoord2f(0, 1); rlVertex2f(x0, y1);
+            rlTexCoord2f(1, 1); rlVertex2f(x1, y1);
+            rlTexCoord2f(1, 0); rlVertex2f(x1, y0);
+        }
+        rlEnd();
+        rlSetTexture(0);
+    }
+};
+
+BackgroundParticles backgroundParticles;
+
+// Draw decorative animated background
+void DrawAnimatedBackground() {
+    renderStats.Background();
+    Gfx::Clear(Colors::BACKGROUND);
+    backgroundParticles.Draw();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PARTICLE EFFECTS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Explosions, engine exhaust and the win/lose bursts. Particles are purely
+// visual, so like the background particles they live on the render thread
+// and step with the frame time. The simulation asks for bursts through
+// EmitEffect(), which goes through a lock-free queue, and so do the
+// continuous emitters it owns.
+//
+// Every field is its own array. The update kernel integrates four particles
+// per SSE2 instruction, a dead particle is removed by moving the last live
+// one into its slot, and Draw() submits all of them as textured quads in one
+// pass, only splitting where an rlgl batch fills up.
+
+const int MAX_PARTICLES = 65536;
+const int PARTICLE_BATCH = 4096;                 // Quads per rlgl batch, well inside its 8192 limit
+
+enum EffectType : uint8_t {
+    EFFECT_EXPLOSION,       // Ship destroyed
+    EFFECT_SPARKS,          // Rock shot apart
+    EFFECT_EXHAUST,         // Engine trail, emitted continuously
+    EFFECT_CONFETTI,        // Win screens
+    EFFECT_EMBERS,          // Lose screens
+    EFFECT_COUNT
+};
+
+struct EffectPreset {
+    int count;              // Particles per burst, or per second for emitters
+    float speedMin, speedMax;
+    float angle, spread;    // Launch direction and half-width in radians (y points down)
+    float lifeMin, lifeMax; // Seconds
+    float sizeMin, sizeMax;
+    float gravity;          // Pixels per second squared, downwards
+    float drag;             // Fraction of velocity lost per second
+    Color start, end;       // Colour at birth and at death
+    bool confetti;          // Start colour picked from the UI palette instead
+};
+
+const EffectPreset EFFECT_PRESETS[EFFECT_COUNT] = {
+    {700, 60, 420, 0, PI, 0.5f, 1.4f, 2, 6, 40, 1.6f, {255, 230, 120, 255}, {200, 40, 20, 0}, false},
+    {48, 40, 220, 0, PI, 0.2f, 0.6f, 1.5f, 3, 0, 2.5f, {255, 220, 150, 255}, {140, 70, 20, 0}, false},
+    {240, 80, 160, PI / 2, 0.25f, 0.15f, 0.45f, 2, 4, 0, 1.0f, {255, 200, 80, 230}, {120, 120, 140, 0}, false},
+    {900, 150, 520, -PI / 2, 0.9f, 1.5f, 3.0f, 3, 6, 260, 0.8f, WHITE, WHITE, true},
+    {300, 20, 90, -PI / 2, 0.6f, 1.2f, 2.6f, 2, 5, -30, 0.5f, {255, 120, 40, 255}, {60, 60, 60, 0}, false},
+};
+
+struct EffectBurst {
+    EffectType type;
+    float x, y;
+    float scale;            // Multiplies the preset's particle count
+};
+
+// Filled by the simulation, drained by the render thread. A full queue drops
+// the burst rather than block the simulation.
+SpscQueue<EffectBurst, 256> effectRequests;
+
+void EmitEffect(EffectType type, float x, float y, float scale = 1.0f) {
+    effectRequests.Push({type, x, y, scale});
+}
+
+class ParticleSystem {
+private:
+    // Sized to MAX_PARTICLES, a multiple of 4, so the kernel never needs a tail loop
+    vector<float> x, y, vx, vy;
+    vector<float> gravity, drag;
+    vector<float> life, invLife;
+    vector<float> fade;                          // life / lifetime, written by the kernel
+    vector<float> size;
+    vector<Color> start, end;
+    int count = 0;
+    uint32_t rng = 0x9E3779B9u;                  // Own generator: rand() belongs to the simulation
+    Texture2D sprite;
+    bool loaded = false;
+
+    float Random(float lo, float hi) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return lo + (hi - lo) * ((rng & 0xFFFFFF) / 16777216.0f);
+    }
+
+    void Kill(int i) {
+        int last = --count;
+        x[i] = x[last]; y[i] = y[last];
+        vx[i] = vx[last]; vy[i] = vy[last];
+        gravity[i] = gravity[last]; drag[i] = drag[last];
+        life[i] = life[last]; invLife[i] = invLife[last];
+        fade[i] = fade[last]; size[i] = size[last];
+        start[i] = start[last]; end[i] = end[last];
+    }
+
+public:
+    ParticleSystem() {
+        for (vector<float>* field : {&x, &y, &vx, &vy, &gravity, &drag, &life, &invLife, &fade, &size}) {
+            field->resize(MAX_PARTICLES);
+        }
+        start.resize(MAX_PARTICLES);
+        end.resize(MAX_PARTICLES);
+    }
+
+    void Load() {
+        if (loaded || headless) return;
+        Image img = GenImageColor(16, 16, BLANK);
+        ImageDrawCircle(&img, 8, 8, 7, WHITE);
+        sprite = LoadTextureFromImage(img);
+        UnloadImage(img);
+        SetTextureFilter(sprite, TEXTURE_FILTER_BILINEAR);
+        loaded = true;
+    }
+
+    void Unload() {
+        if (!loaded) return;
+        UnloadTexture(sprite);
+        loaded = false;
+    }
+
+    void Clear() { count = 0; }
+    int Count() const { return count; }
+
+    // Spawn n particles of a preset at (px, py). Returns how many fit.
+    int Spawn(EffectType type, float px, float py, int n) {
+        static const Color palette[] = {Colors::PRIMARY, Colors::SECONDARY, Colors::ACCENT, Colors::SUCCESS,
+                                        Colors::DANGER};
+        const EffectPreset& p = EFFECT_PRESETS[type];
+        n = min(n, MAX_PARTICLES - count);
+        for (int k = 0; k < n; k++) {
+            int i = count++;
+            float angle = p.angle + Random(-p.spread, p.spread);
+            float speed = Random(p.speedMin, p.speedMax);
+            float lifetime = Random(p.lifeMin, p.lifeMax);
+            x[i] = px;
+            y[i] = py;
+            vx[i] = cosf(angle) * speed;
+            vy[i] = sinf(angle) * speed;
+            gravity[i] = p.gravity;
+            drag[i] = p.drag;
+            life[i] = lifetime;
+            invLife[i] = 1 / lifetime;
+            fade[i] = 1;
+            size[i] = Random(p.sizeMin, p.sizeMax);
+            start[i] = p.confetti ? palette[(rng >> 8) % 5] : p.start;
+            end[i] = p.confetti ? Faded(start[i], 0) : p.end;
+        }
+        return n;
+    }
+
+    // Integrate every particle by dt, then drop the dead ones
+    void Integrate(float dt) {
+#if defined(__SSE2__)
+        int i = 0;
+        __m128 step = _mm_set1_ps(dt), one = _mm_set1_ps(1), zero = _mm_setzero_ps();
+        for (; i < count; i += 4) {
+            __m128 damp = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(_mm_loadu_ps(&drag[i]), step)));
+            __m128 velX = _mm_mul_ps(_mm_loadu_ps(&vx[i]), damp);
+            __m128 velY = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&vy[i]), _mm_mul_ps(_mm_loadu_ps(&gravity[i]), step)), damp);
+            _mm_storeu_ps(&vx[i], velX);
+            _mm_storeu_ps(&vy[i], velY);
+            _mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(velX, step)));
+            _mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(velY, step)));
+            __m128 left = _mm_sub_ps(_mm_loadu_ps(&life[i]), step);
+            _mm_storeu_ps(&life[i], left);
+            _mm_storeu_ps(&fade[i], _mm_max_ps(zero, _mm_mul_ps(left, _mm_loadu_ps(&invLife[i]))));
+        }
+        Compact();
+#else
+        IntegrateScalar(dt);
+#endif
+    }
+
+    // Same arithmetic as the SSE2 kernel, one particle at a time
+    void IntegrateScalar(float dt) {
+        for (int i = 0; i < count; i++) {
+            float damp = max(0.0f, 1 - drag[i] * dt);
+            vx[i] = vx[i] * damp;
+            vy[i] = (vy[i] + gravity[i] * dt) * damp;
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            life[i] -= dt;
+            fade[i] = max(0.0f, life[i] * invLife[i]);
+        }
+        Compact();
+    }
+
+    void Compact() {
+        for (int i = 0; i < count;) {
+            if (life[i] > 0) i++;
+            else Kill(i);
+        }
+    }
+
+    // Sum of positions, for checking two runs against each other
+    double Checksum() const {
+        double sum = 0;
+        for (int i = 0; i < count; i++) sum += x[i] + y[i] * 0.5 + fade[i];
+        return sum;
+    }
+
+    // Start queued bursts, then advance everything
+    void Update(float dt) {
+        EffectBurst burst;
+        while (effectRequests.Pop(burst)) {
+            Spawn(burst.type, burst.x, burst.y, (int)(EFFECT_PRESETS[burst.type].count * burst.scale));
+        }
+        Integrate(dt);
+    }
+
+    void Draw() const {
+        auto colorAt = [this](int i) {
+            float t = fade[i];
+            const Color& a = start[i];
+            const Color& b = end[i];
+            return (Color){(unsigned char)(b.r + (a.r - b.r) * t), (unsigned char)(b.g + (a.g - b.g) * t),
+                           (unsigned char)(b.b + (a.b - b.b) * t), (unsigned char)(b.a + (a.a - b.a) * t)};
+        };
+        if (softTarget) {
+            for (int i = 0; i < count; i++) Gfx::FillCircle(x[i], y[i], size[i] / 2, colorAt(i));
+            return;
+        }
+        if (!loaded || count == 0) return;
+        uiFont.EndBatch();
+        uiFont.Cover(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);       // Particles can be anywhere
+        rlSetTexture(sprite.id);
+        for (int first = 0; first < count; first += PARTICLE_BATCH) {
+            int last = min(count, first + PARTICLE_BATCH);
+            renderStats.Primitive((last - first) * 4);
+            rlCheckRenderBatchLimit((last - first) * 4);
+            rlBegin(RL_QUADS);
+            rlNormal3f(0, 0, 1);
+            for (int i = first; i < last; i++) {
+                float r = size[i] / 2;
+                Color c = colorAt(i);
+                rlColor4ub(c.r, c.g, c.b, c.a);
+                rlTexCoord2f(0, 0); rlVertex2f(x[i] - r, y[i] - r);
+                rlTexCoord2f(0, 1); rlVertex2f(x[i] - r, y[i] + r);
+                rlTexCoord2f(1, 1); rlVertex2f(x[i] + r, y[i] + r);
+                rlTexCoord2f(1, 0); rlVertex2f(x[i] + r, y[i] - r);
+            }
+            rlEnd();
+        }
+        rlSetTexture(0);
+    }
+};
+
+ParticleSystem particles;
+
+// Continuous source, such as the engine trail, owned by a game and fed from
+// its Update(). Keeps the fraction of a particle left over each tick so the
+// rate holds at any tick rate, and sends whole particles through EmitEffect().
+class ParticleEmitter {
+private:
+    float carry = 0;
+
+public:
+    void Emit(EffectType type, float px, float py, float dt) {
+        carry += EFFECT_PRESETS[type].count * dt;
+        int n = (int)carry;
+        if (n == 0) return;
+        carry -= n;
+        // Half a particle of headroom keeps n through the float round trip
+        EmitEffect(type, px, py, (n + 0.5f) / EFFECT_PRESETS[type].count);
+    }
+};
+
+// Shared effect for every game's result screen: confetti for a win, embers
+// rising from the bottom for a loss
+void EmitResultEffect(bool won) {
+    if (won) {
+        EmitEffect(EFFECT_CONFETTI, SCREEN_WIDTH * 0.25f, SCREEN_HEIGHT);
+        EmitEffect(EFFECT_CONFETTI, SCREEN_WIDTH * 0.75f, SCREEN_HEIGHT);
+    } else {
+        for (int i = 0; i < 4; i++) EmitEffect(EFFECT_EMBERS, SCREEN_WIDTH * (i + 0.5f) / 4, SCREEN_HEIGHT, 0.5f);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PARALLAX STARFIELD
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Each layer is a tileable star texture baked once at startup. Scrolling only
+// moves the texture coordinates, so a layer costs one quad however many stars
+// it holds. Positions are drawn from rand() in a fixed order and the layers are
+// then stamped in parallel, so the result does not depend on the thread count.
+struct StarLayerDesc {
+    int starCount;
+    int radius;          // 0 = single pixel
+    unsigned char alpha;
+    float speed;         // Pixels per second
+};
+
+const int STAR_TILE_SIZE = 512;
+const int STAR_LAYER_COUNT = 3;
+
+const StarLayerDesc STAR_LAYERS[STAR_LAYER_COUNT] = {
+    {220, 0, 90, 12.0f},     // Far: many dim, slow stars
+    {90, 1, 150, 30.0f},     // Middle: same pace as the old single layer
+    {25, 1, 230, 70.0f}      // Near: few bright, fast stars
+};
+
+class Starfield {
+private:
+    Texture2D layers[STAR_LAYER_COUNT];
+    Image images[STAR_LAYER_COUNT];    // Kept on the CPU in headless mode
+    bool loaded = false;
+
+public:
+    void Load() {
+        if (loaded) return;
+        Image baked[STAR_LAYER_COUNT];
+        vector<int> positions[STAR_LAYER_COUNT];
+        for (int l = 0; l < STAR_LAYER_COUNT; l++) {
+            for (int i = 0; i < STAR_LAYERS[l].starCount * 2; i++) positions[l].push_back(rand() % STAR_TILE_SIZE);
+        }
+
+        jobs.ParallelFor(STAR_LAYER_COUNT, 1, [&](int begin, int end) {
+            for (int l = begin; l < end; l++) {
+                const StarLayerDesc& desc = STAR_LAYERS[l];
+                Image img = GenImageColor(STAR_TILE_SIZE, STAR_TILE_SIZE, BLANK);
+                Color color = {255, 255, 255, desc.alpha};
+
+                for (int i = 0; i < desc.starCount; i++) {
+                    int x = positions[l][2 * i];
+                    int y = positions[l][2 * i + 1];
+                    // Stamp the wrapped copies too so the tile repeats seamlessly
+                    for (int oy = -1; oy <= 1; oy++) {
+                        for (int ox = -1; ox <= 1; ox++) {
+                            int sx = x + ox * STAR_TILE_SIZE;
+                            int sy = y + oy * STAR_TILE_SIZE;
+                            if (desc.radius == 0) ImageDrawPixel(&img, sx, sy, color);
+                            else ImageDrawCircle(&img, sx, sy, desc.radius, color);
+                        }
+                    }
+                }
+                baked[l] = img;
+            }
+        });
+
+        // Uploads stay on this thread, which owns the GL context
+        for (int l = 0; l < STAR_LAYER_COUNT; l++) {
+            Image img = baked[l];
+            if (headless) {
+                images[l] = img;
+                continue;
+            }
+            layers[l] = LoadTextureFromImage(img);
+            UnloadImage(img);
+            SetTextureWrap(layers[l], TEXTURE_WRAP_REPEAT);
+            SetTextureFilter(layers[l], TEXTURE_FILTER_BILINEAR);
+        }
+        loaded = true;
+    }
+
+    void Unload() {
+        if (!loaded) return;
+        for (int l = 0; l < STAR_LAYER_COUNT; l++) {
+            if (headless) UnloadImage(images[l]);
+            else UnloadTexture(layers[l]);
+        }
+        loaded = false;
+    }
+
+    // offsets[] and offsetsX[] come from StarScroll and are always inside
+    // [0, STAR_TILE_SIZE); offsetsX[] pans the layers sideways for the open field.
+    void Draw(const float* offsets, const float* offsetsX = nullptr) const {
+        if (!loaded) return;
+        uiFont.EndBatch();
+        uiFont.Cover(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+        for (int l = 0; l < STAR_LAYER_COUNT; l++) {
+            float sx = offsetsX ? offsetsX[l] : 0;
+            Rectangle source = {sx, -offsets[l], (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT};
+            renderStats.Primitive(4);
+            if (softTarget) {
+                SoftImageView view = {(const unsigned char*)images[l].data, STAR_TILE_SIZE, STAR_TILE_SIZE, 4};
+                softTarget->Image(view, source, {0, 0, (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT}, WHITE, true);
+            } else {
+                DrawTextureRec(layers[l], source, {0, 0}, WHITE);
+            }
+        }
+    }
+};
+
+Starfield starfield;
+
+// Per-game scroll state. Offsets wrap by a single subtraction each step, so they
+// never grow with play time and keep full float precision in long sessions.
+struct StarScroll {
+    float offsets[STAR_LAYER_COUNT];
+    float offsetsX[STAR_LAYER_COUNT];
+
+    // step must stay below one tile either way
+    static float Wrap(float offset, float step) {
+        offset += step;
+        if (offset >= STAR_TILE_SIZE) offset -= STAR_TILE_SIZE;
+        else if (offset < 0) offset += STAR_TILE_SIZE;
+        return offset;
+    }
+
+    void Reset() {
+        for (int l = 0; l < STAR_LAYER_COUNT; l++) offsets[l] = offsetsX[l] = 0;
+    }
+
+    void Advance(float dt) {
+        if (dt > 0.25f) dt = 0.25f;  // Keeps one step below one tile
+        for (int l = 0; l < STAR_LAYER_COUNT; l++) offsets[l] = Wrap(offsets[l], STAR_LAYERS[l].speed * dt);
+    }
+
+    // Follows a camera that moved by (dx, dy) world units; nearer layers move more
+    void Pan(float dx, float dy) {
+        for (int l = 0; l < STAR_LAYER_COUNT; l++) {
+            float factor = STAR_LAYERS[l].speed / 100.0f;
+            offsetsX[l] = Wrap(offsetsX[l], dx * factor);
+            offsets[l] = Wrap(offsets[l], -dy * factor);
+        }
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SPRITE ATLAS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Every procedural glyph the games draw (X/O marks, zombie-land tokens, card
+// faces, ship, asteroid) is rendered once at startup into a single render
+// texture. Games then draw textured quads from it, which batch together instead
+// of re-tessellating lines, circles and text every frame.
+enum SpriteId {
+    SPRITE_MARK_X,
+    SPRITE_MARK_O,
+    SPRITE_TOKEN_PLAYER,
+    SPRITE_TOKEN_ZOMBIE,
+    SPRITE_TOKEN_SAFE,
+    SPRITE_SHIP,
+    SPRITE_ASTEROID,
+    SPRITE_CARD_HIDDEN,
+    SPRITE_CARD_HIDDEN_HOVER,
+    SPRITE_CARD_REVEALED,                        // 8 faces, 'A'..'H'
+    SPRITE_CARD_MATCHED = SPRITE_CARD_REVEALED + 8,
+    SPRITE_COUNT = SPRITE_CARD_MATCHED + 8
+};
+
+const int SPRITE_ATLAS_SIZE = 1024;
+const int SPRITE_PADDING = 2;
+const float SPRITE_BAKE_BUDGET_MS = 20.0f;
+const float TOKEN_RADIUS = 18;                   // Player/zombie token radius
+const float ASTEROID_SPRITE_RADIUS = 40;         // Asteroids are scaled from this
+
+// Ship outline relative to the ship position. The sprite and the collision
+// test both use it, so the hitbox is exactly what is drawn.
+const Vector2 SHIP_HULL[3] = {{0, -25}, {20, 20}, {-20, 20}};
+
+class SpriteAtlas {
+private:
+    RenderTexture2D target;
+    SoftRasterizer softAtlas;          // Headless copy of the atlas
+    Rectangle rects[SPRITE_COUNT];
+    bool loaded = false;
+
+    static Vector2 SpriteSize(int id) {
+        if (id == SPRITE_MARK_X || id == SPRITE_MARK_O) return {90, 90};
+        if (id == SPRITE_TOKEN_SAFE) return {44, 44};
+        if (id == SPRITE_TOKEN_PLAYER || id == SPRITE_TOKEN_ZOMBIE) return {2 * TOKEN_RADIUS + 4, 2 * TOKEN_RADIUS + 4};
+        if (id == SPRITE_SHIP) return {44, 49};
+        if (id == SPRITE_ASTEROID) return {2 * ASTEROID_SPRITE_RADIUS + 4, 2 * ASTEROID_SPRITE_RADIUS + 4};
+        return {120, 150};                       // Cards
+    }
+
+    // Draw one glyph into its cell, using the same primitives the games used
+    static void DrawSpriteContent(int id, Rectangle cell) {
+        float cx = cell.x + cell.width / 2;
+        float cy = cell.y + cell.height / 2;
+
+        if (id == SPRITE_MARK_X) {
+            float s = 35;
+            Gfx::Line({cx - s, cy - s}, {cx + s, cy + s}, 8, Colors::SUCCESS);
+            Gfx::Line({cx + s, cy - s}, {cx - s, cy + s}, 8, Colors::SUCCESS);
+        } else if (id == SPRITE_MARK_O) {
+            Gfx::StrokeCircle(cx, cy, 40, Colors::DANGER);
+            Gfx::StrokeCircle(cx, cy, 38, Colors::DANGER);
+            Gfx::StrokeCircle(cx, cy, 36, Colors::DANGER);
+        } else if (id == SPRITE_TOKEN_PLAYER || id == SPRITE_TOKEN_ZOMBIE || id == SPRITE_TOKEN_SAFE) {
+            float radius = (id == SPRITE_TOKEN_SAFE) ? 20 : TOKEN_RADIUS;
+            Color color = (id == SPRITE_TOKEN_PLAYER) ? Colors::SUCCESS :
+                          (id == SPRITE_TOKEN_ZOMBIE) ? Colors::DANGER : Colors::ACCENT;
+            const char* letter = (id == SPRITE_TOKEN_PLAYER) ? "P" : (id == SPRITE_TOKEN_ZOMBIE) ? "Z" : "S";
+            Gfx::FillCircle(cx, cy, radius, color);
+            DrawUIText(letter, cx - 7, cy - 10, 24, (id == SPRITE_TOKEN_SAFE) ? BLACK : WHITE);
+        } else if (id == SPRITE_SHIP) {
+            // The cell centre sits 2.5 px above the ship position
+            Vector2 hull[3];
+            for (int i = 0; i < 3; i++) hull[i] = {cx + SHIP_HULL[i].x, cy + 2.5f + SHIP_HULL[i].y};
+            Gfx::FillTriangle(hull[0], hull[1], hull[2], Colors::PRIMARY);
+            Gfx::StrokeTriangle(hull[0], hull[1], hull[2], WHITE);
+        } else if (id == SPRITE_ASTEROID) {
+            float r = ASTEROID_SPRITE_RADIUS;
+            Gfx::FillCircle(cx, cy, r, (Color){139, 69, 19, 255});
+            Gfx::FillCircle(cx - r/4, cy - r/4, r/4, (Color){100, 50, 10, 255});
+            Gfx::StrokeCircle(cx, cy, r, (Color){80, 40, 10, 255});
+        } else if (id == SPRITE_CARD_HIDDEN || id == SPRITE_CARD_HIDDEN_HOVER) {
+            // The outline is drawn outside the body, so inset the body to keep it in the cell
+            Rectangle body = {cell.x + 2, cell.y + 2, cell.width - 4, cell.height - 4};
+            Gfx::FillRoundedRect(body, 0.1f, 8, (id == SPRITE_CARD_HIDDEN_HOVER) ? Colors::CARD_HOVER : Colors::CARD_BG);
+            Gfx::StrokeRoundedRect(body, 0.1f, 8, 2, Colors::PRIMARY);
+            DrawUIText("?", cx - 12, cy - 20, 50, Colors::PRIMARY);
+        } else {
+            bool matched = id >= SPRITE_CARD_MATCHED;
+            char symbol[2] = {(char)('A' + id - (matched ? SPRITE_CARD_MATCHED : SPRITE_CARD_REVEALED)), 0};
+            Gfx::FillRoundedRect(cell, 0.1f, 8, matched ? Colors::SUCCESS : Colors::ACCENT);
+            DrawUIText(symbol, cx - 15, cy - 20, 50, matched ? WHITE : BLACK);
+        }
+    }
+
+public:
+    void Bake() {
+        if (loaded) return;
+        auto start = chrono::steady_clock::now();
+        renderStats.Pause();
+
+        // Shelf-pack the cells left to right
+        float x = SPRITE_PADDING, y = SPRITE_PADDING, shelfHeight = 0;
+        for (int id = 0; id < SPRITE_COUNT; id++) {
+            Vector2 size = SpriteSize(id);
+            if (x + size.x + SPRITE_PADDING > SPRITE_ATLAS_SIZE) {
+                x = SPRITE_PADDING;
+                y += shelfHeight + SPRITE_PADDING;
+                shelfHeight = 0;
+            }
+            rects[id] = {x, y, size.x, size.y};
+            x += size.x + SPRITE_PADDING;
+            shelfHeight = max(shelfHeight, size.y);
+        }
+
+        if (headless) {
+            SoftRasterizer* screen = softTarget;
+            softTarget = &softAtlas;
+            softAtlas.Begin(SPRITE_ATLAS_SIZE, SPRITE_ATLAS_SIZE);
+            for (int id = 0; id < SPRITE_COUNT; id++) DrawSpriteContent(id, rects[id]);
+            softAtlas.Finish();
+            softTarget = screen;
+        } else {
+            target = LoadRenderTexture(SPRITE_ATLAS_SIZE, SPRITE_ATLAS_SIZE);
+            BeginTextureMode(target);
+            ClearBackground(BLANK);
+            for (int id = 0; id < SPRITE_COUNT; id++) DrawSpriteContent(id, rects[id]);
+            uiFont.EndBatch();
+            EndTextureMode();
+            SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+        }
+        loaded = true;
+        renderStats.Resume();
+
+        float ms = chrono::duration<float, milli>(chrono::steady_clock::now() - start).count();
+        TraceLog(ms > SPRITE_BAKE_BUDGET_MS ? LOG_WARNING : LOG_INFO,
+                 "ATLAS: Baked %d sprites in %.2f ms (budget %.0f ms)", SPRITE_COUNT, ms, SPRITE_BAKE_BUDGET_MS);
+    }
+
+    void Unload() {
+        if (!loaded) return;
+        if (!headless) UnloadRenderTexture(target);
+        loaded = false;
+    }
+
+    // Draw a sprite centred on (cx, cy), scaled per axis relative to its baked size
+    void DrawScaled(int id, float cx, float cy, float scaleX, float scaleY, Color tint = WHITE) const {
+        if (!loaded) return;
+        Rectangle r = rects[id];
+        renderStats.Sprite();
+        renderStats.Primitive(4);
+        if (softTarget) {
+            float w = r.width * scaleX, h = r.height * scaleY;
+            softTarget->Image(softAtlas.View(), r, {cx - w / 2, cy - h / 2, w, h}, tint);
+            return;
+        }
+        uiFont.EndBatch();
+        // Render textures are stored bottom-up, so flip the source rectangle
+        Rectangle source = {r.x, SPRITE_ATLAS_SIZE - r.y - r.height, r.width, -r.height};
+        Rectangle dest = {cx, cy, r.width * scaleX, r.height * scaleY};
+        CoverDeferredText(cx - dest.width / 2, cy - dest.height / 2, dest.width, dest.height);
+        DrawTexturePro(target.texture, source, dest, {dest.width / 2, dest.height / 2}, 0, tint);
+    }
+
+    void Draw(int id, float cx, float cy, float scale = 1.0f, Color tint = WHITE) const {
+        DrawScaled(id, cx, cy, scale, scale, tint);
+    }
+
+    // Draw a sprite stretched over a rectangle (cards)
+    void DrawRect(int id, Rectangle dest, Color tint = WHITE) const {
+        Rectangle r = rects[id];
+        DrawScaled(id, dest.x + dest.width / 2, dest.y + dest.height / 2, dest.width / r.width,
+                   dest.height / r.height, tint);
+    }
+};
+
+SpriteAtlas spriteAtlas;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DRAW COMMAND LISTS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Draw() code can record into a DrawList instead of drawing immediately.
+// Commands are plain structs kept in per-list arenas that are reused frame to
+// frame. Submit() sorts everything by layer, then by material (the rlgl state a
+// primitive needs), then by recording order, so each layer issues its quads,
+// lines, sprites and text as long runs instead of switching batch state on
+// every call. Only the layer expresses overlap: two things that overlap must go
+// on different layers if their materials differ.
+//
+// Large scenes can be recorded on several threads with ParallelRecord(); every
+// worker fills its own list and the sort key makes the result identical to a
+// serial recording.
+enum DrawLayer : unsigned char {
+    LAYER_BACKGROUND,
+    LAYER_WORLD,
+    LAYER_ACTORS,
+    LAYER_HUD,
+    LAYER_OVERLAY
+};
+
+// Ordered so text, which binds the SDF shader, comes last in each layer
+enum DrawMaterial : unsigned char {
+    MATERIAL_QUADS,
+    MATERIAL_TRIANGLES,
+    MATERIAL_LINES,
+    MATERIAL_SPRITES,
+    MATERIAL_TEXT
+};
+
+enum DrawCommandType : unsigned char {
+    DRAW_RECT,
+    DRAW_ROUNDED_RECT,
+    DRAW_ROUNDED_OUTLINE,
+    DRAW_CIRCLE,
+    DRAW_CIRCLE_OUTLINE,
+    DRAW_LINE,
+    DRAW_TRIANGLE,
+    DRAW_SPRITE,
+    DRAW_TEXT
+};
+
+// Sort key: layer (4 bits) | material (4) | phase (16) | list (8) | index (32)
+struct DrawCommand {
+    uint64_t key;
+    DrawCommandType type;
+    short index;                   // Sprite id, or segments for rounded shapes
+    Color color;
+    float p[7];                    // Shape parameters, see the recording functions
+    uint32_t textOffset;           // DRAW_TEXT: start of the string in the list's text arena
+};
+
+const int MAX_DRAW_LISTS = 32;
+
+class DrawList {
+private:
+    vector<DrawCommand> commands;
+    vector<char> text;
+    uint64_t phase = 0;
+    uint64_t listId = 0;
+
+    DrawCommand& Push(DrawCommandType type, DrawMaterial material, Color color) {
+        DrawCommand cmd = {};
+        cmd.key = ((uint64_t)layer << 60) | ((uint64_t)material << 56) | (phase << 40) | (listId << 32) |
+                  (uint64_t)commands.size();
+        cmd.type = type;
+        cmd.color = color;
+        commands.push_back(cmd);
+        return commands.back();
+    }
+
+    friend class DrawQueue;
+
+public:
+    DrawLayer layer = LAYER_WORLD;
+
+    void Clear() {
+        commands.clear();
+        text.clear();
+    }
+
+    void Rect(float x, float y, float width, float height, Color color) {
+        DrawCommand& c = Push(DRAW_RECT, MATERIAL_QUADS, color);
+        c.p[0] = x; c.p[1] = y; c.p[2] = width; c.p[3] = height;
+    }
+
+    void RoundedRect(Rectangle rec, float roundness, int segments, Color color) {
+        DrawCommand& c = Push(DRAW_ROUNDED_RECT, MATERIAL_QUADS, color);
+        c.p[0] = rec.x; c.p[1] = rec.y; c.p[2] = rec.width; c.p[3] = rec.height; c.p[4] = roundness;
+        c.index = (short)segments;
+    }
+
+    void RoundedOutline(Rectangle rec, float roundness, int segments, float thick, Color color) {
+        DrawCommand& c = Push(DRAW_ROUNDED_OUTLINE, thick > 1 ? MATERIAL_QUADS : MATERIAL_LINES, color);
+        c.p[0] = rec.x; c.p[1] = rec.y; c.p[2] = rec.width; c.p[3] = rec.height; c.p[4] = roundness; c.p[5] = thick;
+        c.index = (short)segments;
+    }
+
+    void Circle(float cx, float cy, float radius, Color color) {
+        DrawCommand& c = Push(DRAW_CIRCLE, MATERIAL_QUADS, color);
+        c.p[0] = cx; c.p[1] = cy; c.p[2] = radius;
+    }
+
+    void CircleOutline(float cx, float cy, float radius, Color color) {
+        DrawCommand& c = Push(DRAW_CIRCLE_OUTLINE, MATERIAL_LINES, color);
+        c.p[0] = cx; c.p[1] = cy; c.p[2] = radius;
+    }
+
+    void Line(Vector2 start, Vector2 end, float thick, Color color) {
+        DrawCommand& c = Push(DRAW_LINE, MATERIAL_TRIANGLES, color);
+        c.p[0] = start.x; c.p[1] = start.y; c.p[2] = end.x; c.p[3] = end.y; c.p[4] = thick;
+    }
+
+    // Vertices in counter-clockwise order, as raylib expects
+    void Triangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+        DrawCommand& c = Push(DRAW_TRIANGLE, MATERIAL_QUADS, color);
+        c.p[0] = v1.x; c.p[1] = v1.y; c.p[2] = v2.x; c.p[3] = v2.y; c.p[4] = v3.x; c.p[5] = v3.y;
+    }
+
+    // Convex polygon in the same winding as Triangle(), recorded as a fan
+    void Polygon(const Vector2* points, int count, Color color) {
+        for (int i = 1; i + 1 < count; i++) Triangle(points[0], points[i], points[i + 1], color);
+    }
+
+    void Sprite(int id, float cx, float cy, float scale = 1.0f, Color tint = WHITE) {
+        DrawCommand& c = Push(DRAW_SPRITE, MATERIAL_SPRITES, tint);
+        c.p[0] = cx; c.p[1] = cy; c.p[2] = scale;
+        c.index = (short)id;
+    }
+
+    void Text(const char* str, float x, float y, float fontSize, Color color) {
+        DrawCommand& c = Push(DRAW_TEXT, MATERIAL_TEXT, color);
+        c.p[0] = x; c.p[1] = y; c.p[2] = fontSize;
+        c.textOffset = (uint32_t)text.size();
+        text.insert(text.end(), str, str + strlen(str) + 1);
+    }
+
+    void TextCentered(const char* str, float y, float fontSize, Color color) {
+        Text(str, (SCREEN_WIDTH - MeasureUIText(str, fontSize)) / 2, y, fontSize, color);
+    }
+
+    int Size() const { return (int)commands.size(); }
+};
+
+class DrawQueue {
+private:
+    DrawList lists[MAX_DRAW_LISTS];
+    int usedLists = 1;
+    uint64_t phase = 0;
+    vector<pair<uint64_t, const DrawCommand*>> order;
+
+    void Execute(const DrawCommand& c, const DrawList& owner) {
+        const float* p = c.p;
+        switch (c.type) {
+            case DRAW_RECT: Gfx::FillRect(p[0], p[1], p[2], p[3], c.color); break;
+            case DRAW_ROUNDED_RECT: Gfx::FillRoundedRect({p[0], p[1], p[2], p[3]}, p[4], c.index, c.color); break;
+            case DRAW_ROUNDED_OUTLINE:
+                Gfx::StrokeRoundedRect({p[0], p[1], p[2], p[3]}, p[4], c.index, p[5], c.color);
+                break;
+            case DRAW_CIRCLE: Gfx::FillCircle(p[0], p[1], p[2], c.color); break;
+            case DRAW_CIRCLE_OUTLINE: Gfx::StrokeCircle(p[0], p[1], p[2], c.color); break;
+            case DRAW_LINE: Gfx::Line({p[0], p[1]}, {p[2], p[3]}, p[4], c.color); break;
+            case DRAW_TRIANGLE: Gfx::FillTriangle({p[0], p[1]}, {p[2], p[3]}, {p[4], p[5]}, c.color); break;
+            case DRAW_SPRITE: spriteAtlas.Draw(c.index, p[0], p[1], p[2], c.color); break;
+            case DRAW_TEXT: DrawUIText(&owner.text[c.textOffset], p[0], p[1], p[2], c.color); break;
+        }
+    }
+
+public:
+    // Main-thread list for the current frame
+    DrawList& Begin() {
+        for (int i = 0; i < usedLists; i++) lists[i].Clear();
+        usedLists = 1;
+        phase = 0;
+        lists[0].phase = 0;
+        lists[0].listId = 0;
+        lists[0].layer = LAYER_WORLD;
+        return lists[0];
+    }
+
+    // Record count items split into contiguous ranges over the job system.
+    // record(list, begin, end) must only touch the list it is given. Runs
+    // serially when there are fewer than minPerThread items per thread.
+    template <typename Fn>
+    void ParallelRecord(int count, int minPerThread, Fn record) {
+        DrawList& main = lists[0];
+        int workers = min({MAX_DRAW_LISTS - 1, jobs.Threads(), count / max(1, minPerThread)});
+        phase++;
+        if (workers <= 1) {
+            main.phase = phase;
+            record(main, 0, count);
+        } else {
+            for (int w = 0; w < workers; w++) {
+                DrawList& list = lists[1 + w];
+                list.Clear();
+                list.phase = phase;
+                list.listId = 1 + w;
+                list.layer = main.layer;
+            }
+            usedLists = max(usedLists, 1 + workers);
+            // One range per list keeps the split independent of who runs it
+            jobs.ParallelFor(workers, 1, [&](int begin, int end) {
+                for (int w = begin; w < end; w++) {
+                    record(lists[1 + w], (int)((long long)count * w / workers),
+                           (int)((long long)count * (w + 1) / workers));
+                }
+            });
+        }
+        main.phase = ++phase;
+    }
+
+    // Sort every recorded command and draw it
+    void Submit() {
+        order.clear();
+        for (int i = 0; i < usedLists; i++) {
+            for (const DrawCommand& c : lists[i].commands) order.push_back({c.key, &c});
+        }
+        sort(order.begin(), order.end(),
+             [](const pair<uint64_t, const DrawCommand*>& a, const pair<uint64_t, const DrawCommand*>& b) {
+                 return a.first < b.first;
+             });
+        for (const auto& entry : order) Execute(*entry.second, lists[(entry.first >> 32) & 0xFF]);
+        for (int i = 0; i < usedLists; i++) lists[i].Clear();
+    }
+};
+
+DrawQueue drawQueue;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FORWARD DECLARATIONS
+// ═══════════════════════════════════════════════════════════════════════════
+
+class TicTacToeGame;
+class SpaceSurvivorGame;
+class BreakTheCodeGame;
+class ZombieLandGame;
+class SwapCardsGame;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// M,N,K BOARD
+// ═══════════════════════════════════════════════════════════════════════════
+
+// An m x n board where k in a row wins, from 3x3 Tic-Tac-Toe up to 19x19
+// Gomoku. Each player's stones are kept in four bitboards, one per line
+// direction, each laid out so its lines run along consecutive bits:
+//   rows            r * (cols + 1) + c
+//   columns         c * (rows + 1) + r
+//   diagonals       (c - r + rows - 1) * (rows + 1) + r      (down-right)
+//   anti-diagonals  (r + c) * (rows + 1) + r                 (down-left)
+// Every line is followed by at least one slot no cell maps to, so runs never
+// join across lines. After a move only its four lines are checked: the
+// 2k - 1 bits centred on it are read from each layout and ANDed with
+// themselves shifted until only runs of k are left, so the cost does not
+// depend on the board size.
+enum MnkLayout { MNK_ROWS, MNK_COLUMNS, MNK_DIAGONALS, MNK_ANTI_DIAGONALS, MNK_LAYOUTS };
+
+const int MNK_MAX_SIDE = 19;
+
+struct MnkRules {
+    int rows, cols, k;
+    const char* name;
+};
+
+const MnkRules MNK_PRESETS[] = {
+    {3, 3, 3, "Tic-Tac-Toe"}, {4, 4, 4, "4 x 4"}, {5, 5, 4, "5 x 5, 4 in a row"}, {7, 7, 5, "7 x 7, 5 in a row"},
+    {9, 9, 5, "9 x 9, 5 in a row"}, {15, 15, 5, "Gomoku 15 x 15"}, {19, 19, 5, "Gomoku 19 x 19"},
+};
+const int MNK_PRESET_COUNT = sizeof(MNK_PRESETS) / sizeof(MNK_PRESETS[0]);
+
+// MAX_SIDE only sets the storage; the rules are picked at Reset and may be
+// anything up to MAX_SIDE x MAX_SIDE with 1 < k <= the longer side
+template <int MAX_SIDE>
+class MnkBoard {
+public:
+    static const int LAYOUT_BITS = (2 * MAX_SIDE - 1) * (MAX_SIDE + 1);
+    static const int WORDS = (LAYOUT_BITS + 63) / 64;
+
+private:
+    uint64_t bits[2][MNK_LAYOUTS][WORDS];
+    int rows, cols, k;
+    int moves;
+
+    // Where (r, c) sits in each layout
+    void Indices(int r, int c, int* out) const {
+        out[MNK_ROWS] = r * (cols + 1) + c;
+        out[MNK_COLUMNS] = c * (rows + 1) + r;
+        out[MNK_DIAGONALS] = (c - r + rows - 1) * (rows + 1) + r;
+        out[MNK_ANTI_DIAGONALS] = (r + c) * (rows + 1) + r;
+    }
+
+    // Bits [start, start + len) of one layout, lowest first. Bits before
+    // the start of the board read as empty. len must stay below 64.
+    static uint64_t Window(const uint64_t* words, int start, int len) {
+        int lead = max(-start, 0);               // Bits that fall before bit 0
+        start += lead;
+        int word = start >> 6, shift = start & 63;
+        uint64_t v = words[word] >> shift;
+        if (shift && word + 1 < WORDS) v |= words[word + 1] << (64 - shift);
+        return (v << lead) & ((1ULL << len) - 1);
+    }
+
+    bool WinsAt(int player, const int* index) const {
+        uint64_t any = 0;
+        for (int layout = 0; layout < MNK_LAYOUTS; layout++) {
+            uint64_t run = Window(bits[player][layout], index[layout] - (k - 1), 2 * k - 1);
+            // After each step, bit i means bits i .. i + span - 1 are all set
+            int span = 1;
+            for (; span * 2 <= k; span *= 2) run &= run >> span;
+            if (span < k) run &= run >> (k - span);
+            any |= run;
+        }
+        return any != 0;
+    }
+
+public:
+    void Reset(int boardRows, int boardCols, int inARow) {
+        rows = min(max(boardRows, 1), MAX_SIDE);
+        cols = min(max(boardCols, 1), MAX_SIDE);
+        k = min(max(inARow, 2), max(rows, cols));
+        moves = 0;
+        memset(bits, 0, sizeof(bits));
+    }
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+    int K() const { return k; }
+    int Moves() const { return moves; }
+    bool Full() const { return moves == rows * cols; }
+
+    // 0 or 1 for a player's stone, -1 for an empty cell
+    int At(int r, int c) const {
+        int i = r * (cols + 1) + c;
+        for (int p = 0; p < 2; p++) {
+            if (bits[p][MNK_ROWS][i >> 6] >> (i & 63) & 1) return p;
+        }
+        return -1;
+    }
+
+    // Whether the stone at (r, c) completes k in a row for its player
+    bool Wins(int player, int r, int c) const {
+        int index[MNK_LAYOUTS];
+        Indices(r, c, index);
+        return WinsAt(player, index);
+    }
+
+    // Put a stone on an empty cell; returns true if it wins
+    bool Place(int player, int r, int c) {
+        int index[MNK_LAYOUTS];
+        Indices(r, c, index);
+        for (int layout = 0; layout < MNK_LAYOUTS; layout++) {
+            bits[player][layout][index[layout] >> 6] |= 1ULL << (index[layout] & 63);
+        }
+        moves++;
+        return WinsAt(player, index);
+    }
+
+    void Remove(int player, int r, int c) {
+        int index[MNK_LAYOUTS];
+        Indices(r, c, index);
+        for (int layout = 0; layout < MNK_LAYOUTS; layout++) {
+            bits[player][layout][index[layout] >> 6] &= ~(1ULL << (index[layout] & 63));
+        }
+        moves--;
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// M,N,K SEARCH
+// ═══════════════════════════════════════════════════════════════════════════
+
+// The computer player: iterative-deepening negamax with alpha-beta, a
+// Zobrist-hashed transposition table, and killer and history move ordering,
+// cut off by a wall-clock budget. It runs as Lazy SMP: every thread searches
+// the same root on its own copy of the board and the threads share nothing
+// but the table, so one thread's results steer the others. The deepest
+// iteration any thread finished gives the move.
+const int MNK_CELLS = MNK_MAX_SIDE * MNK_MAX_SIDE;
+const int MNK_MAX_PLY = 64;
+const int MNK_WIN = 1000000000;                  // Less the ply it happens at, so quick wins rank first
+const int MNK_WIN_BOUND = MNK_WIN - 1000;        // Anything beyond is a forced result
+const long long MNK_EVAL_CAP = 100000000;
+const int MNK_TABLE_BITS = 20;                   // 1M slots, 16 MB
+const int MNK_TIME_CHECK = 1023;                 // Look at the clock every 1024 nodes
+const int MNK_THINK_MS = 250;
+
+int mnkThinkMs = MNK_THINK_MS;                   // --ai-ms
+
+struct MnkZobrist {
+    uint64_t keys[2][MNK_CELLS];
+    MnkZobrist() {
+        uint64_t x = 0x9E3779B97F4A7C15ULL;      // splitmix64
+        for (int p = 0; p < 2; p++) {
+            for (int i = 0; i < MNK_CELLS; i++) {
+                uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                keys[p][i] = z ^ (z >> 31);
+            }
+        }
+    }
+};
+
+const MnkZobrist mnkZobrist;
+
+enum MnkBound { MNK_EXACT, MNK_LOWER, MNK_UPPER };
+
+// Shared by every search thread without locks. A slot holds the key XORed
+// with its data, so a slot torn by two threads writing at once fails the key
+// check and reads as a miss instead of as another position's data.
+class MnkTable {
+private:
+    struct Slot {
+        atomic<uint64_t> check{0};
+        atomic<uint64_t> data{0};
+    };
+    unique_ptr<Slot[]> slots;
+    uint64_t mask = 0;
+
+public:
+    void Resize(int bits) {
+        slots.reset(new Slot[1ULL << bits]);
+        mask = (1ULL << bits) - 1;
+    }
+
+    bool Empty() const { return !slots; }
+
+    void Clear() {
+        for (uint64_t i = 0; i <= mask && slots; i++) {
+            slots[i].check.store(0, memory_order_relaxed);
+            slots[i].data.store(0, memory_order_relaxed);
+        }
+    }
+
+    bool Probe(uint64_t key, int& score, int& move, int& depth, int& bound) const {
+        const Slot& slot = slots[key & mask];
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        if ((slot.check.load(memory_order_relaxed) ^ data) != key) return false;
+        score = (int32_t)(uint32_t)data;
+        move = (int)((data >> 32) & 0xFFFF);
+        depth = (int)((data >> 48) & 0xFF);
+        bound = (int)(data >> 56);
+        return true;
+    }
+
+    // Keeps a deeper result for the same position unless the new one is exact
+    void Store(uint64_t key, int score, int move, int depth, int bound) {
+        Slot& slot = slots[key & mask];
+        uint64_t old = slot.data.load(memory_order_relaxed);
+        if ((slot.check.load(memory_order_relaxed) ^ old) == key && (int)((old >> 48) & 0xFF) > depth &&
+            bound != MNK_EXACT) return;
+        uint64_t data = (uint32_t)score | (uint64_t)(uint16_t)move << 32 | (uint64_t)(uint8_t)depth << 48 |
+                        (uint64_t)bound << 56;
+        slot.check.store(key ^ data, memory_order_relaxed);
+        slot.data.store(data, memory_order_relaxed);
+    }
+};
+
+MnkTable mnkTable;
+
+// Everything about the rules the searchers share read-only: which k-long
+// windows each cell belongs to, and what a window is worth
+struct MnkGeometry {
+    int rows, cols, k, cells;
+    bool allMoves;                   // Small boards consider every empty cell
+    vector<uint16_t> windowStart;    // Per cell, into windowList; cells + 1 entries
+    vector<uint16_t> windowList;
+    int windows;
+    long long value[MNK_MAX_SIDE + 1];
+
+    void Build(int boardRows, int boardCols, int inARow) {
+        rows = boardRows;
+        cols = boardCols;
+        k = inARow;
+        cells = rows * cols;
+        allMoves = cells <= 25;
+        const int steps[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        vector<vector<uint16_t>> perCell(cells);
+        windows = 0;
+        for (const auto& d : steps) {
+            for (int r = 0; r < rows; r++) {
+                for (int c = 0; c < cols; c++) {
+                    int er = r + d[0] * (k - 1), ec = c + d[1] * (k - 1);
+                    if (er >= rows || ec < 0 || ec >= cols) continue;
+                    for (int n = 0; n < k; n++) perCell[(r + d[0] * n) * cols + c + d[1] * n].push_back(windows);
+                    windows++;
+                }
+            }
+        }
+        windowStart.assign(1, 0);
+        windowList.clear();
+        for (const auto& list : perCell) {
+            windowList.insert(windowList.end(), list.begin(), list.end());
+            windowStart.push_back((uint16_t)windowList.size());
+        }
+        // Each stone in an open window is worth eight times the last
+        value[0] = 0;
+        for (int n = 1; n <= MNK_MAX_SIDE; n++) value[n] = min(value[n - 1] * 8 + (n == 1), 1LL << 40);
+    }
+};
+
+struct MnkSearchResult {
+    int move;            // Row * cols + col, or -1 when the board is full
+    int score;           // For the side that moved; beyond MNK_WIN_BOUND is a forced result
+    int depth;           // Deepest finished iteration
+    long long nodes;     // Over all threads
+    int threads;
+    double ms;
+};
+
+class MnkSearcher {
+private:
+    const MnkGeometry* geo;
+    MnkBoard<MNK_MAX_SIDE> board;
+    int8_t cell[MNK_CELLS];
+    uint8_t near[MNK_CELLS];             // Stones within one step, for move generation
+    vector<uint8_t> counts;              // Two per window: player 0 and player 1 stones
+    long long eval;                      // Sum of window values from player 0's side
+    uint64_t hash;
+    int stones;
+    int killers[MNK_MAX_PLY][2];
+    int history[2][MNK_CELLS];
+    uint32_t noise;                      // Helper threads break ordering ties differently
+    bool mustFinish;                     // Set for the main thread's first iteration
+    int rootMove;
+    atomic<bool>* stop;
+    chrono::steady_clock::time_point deadline;
+
+    long long WindowValue(int w) const {
+        int a = counts[2 * w], b = counts[2 * w + 1];
+        return b == 0 ? geo->value[a] : a == 0 ? -geo->value[b] : 0;
+    }
+
+    void Touch(int i, int delta) {
+        int r = i / geo->cols, c = i % geo->cols;
+        for (int y = max(r - 1, 0); y <= min(r + 1, geo->rows - 1); y++) {
+            for (int x = max(c - 1, 0); x <= min(c + 1, geo->cols - 1); x++) near[y * geo->cols + x] += delta;
+        }
+    }
+
+    bool Place(int player, int i) {
+        for (int n = geo->windowStart[i]; n < geo->windowStart[i + 1]; n++) {
+            int w = geo->windowList[n];
+            eval -= WindowValue(w);
+            counts[2 * w + player]++;
+            eval += WindowValue(w);
+        }
+        cell[i] = (int8_t)player;
+        hash ^= mnkZobrist.keys[player][i];
+        stones++;
+        Touch(i, 1);
+        return board.Place(player, i / geo->cols, i % geo->cols);
+    }
+
+    void Unplace(int player, int i) {
+        for (int n = geo->windowStart[i]; n < geo->windowStart[i + 1]; n++) {
+            int w = geo->windowList[n];
+            eval -= WindowValue(w);
+            counts[2 * w + player]--;
+            eval += WindowValue(w);
+        }
+        cell[i] = -1;
+        hash ^= mnkZobrist.keys[player][i];
+        stones--;
+        Touch(i, -1);
+        board.Remove(player, i / geo->cols, i % geo->cols);
+    }
+
+    int Evaluate(int player) const {
+        long long e = min(max(eval, -MNK_EVAL_CAP), MNK_EVAL_CAP);
+        return (int)(player == 0 ? e : -e);
+    }
+
+    // Empty cells next to a stone (every empty cell on small boards or an
+    // empty board), scored for ordering: table move, killers, then history
+    int Generate(int player, int ply, int tableMove, int16_t* moves, int* scores) const {
+        int count = 0;
+        bool all = geo->allMoves || stones == 0;
+        // Cells next to a stone first; if those are all taken, any empty cell
+        for (int pass = all ? 1 : 0; pass < 2 && count == 0; pass++) {
+            for (int i = 0; i < geo->cells; i++) {
+                if (cell[i] >= 0 || (pass == 0 && !near[i])) continue;
+                int score = history[player][i];
+                if (i == tableMove) score = 1 << 30;
+                else if (i == killers[ply][0]) score = 1 << 29;
+                else if (i == killers[ply][1]) score = 1 << 28;
+                else if (noise) score += (int)(((uint32_t)i * 2654435761u ^ noise) >> 28);
+                moves[count] = (int16_t)i;
+                scores[count++] = score;
+            }
+        }
+        if (stones == 0 && !geo->allMoves) {           // Open in the middle
+            moves[0] = (int16_t)(geo->rows / 2 * geo->cols + geo->cols / 2);
+            count = 1;
+        }
+        return count;
+    }
+
+    static int ToTable(int score, int ply) {
+        return score > MNK_WIN_BOUND ? score + ply : score < -MNK_WIN_BOUND ? score - ply : score;
+    }
+
+    static int FromTable(int score, int ply) {
+        return score > MNK_WIN_BOUND ? score - ply : score < -MNK_WIN_BOUND ? score + ply : score;
+    }
+
+    bool Stopped() const { return !mustFinish && stop->load(memory_order_relaxed); }
+
+    int Negamax(int player, int depth, int alpha, int beta, int ply) {
+        if ((++nodes & MNK_TIME_CHECK) == 0 && chrono::steady_clock::now() >= deadline) {
+            stop->store(true, memory_order_relaxed);
+        }
+        if (Stopped()) return 0;
+        if (depth <= 0 || ply >= MNK_MAX_PLY - 1) return Evaluate(player);
+
+        int tableMove = -1, score, move, storedDepth, bound;
+        if (mnkTable.Probe(hash, score, move, storedDepth, bound)) {
+            if (move < geo->cells && cell[move] < 0) tableMove = move;
+            score = FromTable(score, ply);
+            if (storedDepth >= depth && ply > 0 &&
+                (bound == MNK_EXACT || (bound == MNK_LOWER && score >= beta) || (bound == MNK_UPPER && score <= alpha))) {
+                return score;
+            }
+        }
+
+        int16_t moves[MNK_CELLS];
+        int scores[MNK_CELLS];
+        int count = Generate(player, ply, tableMove, moves, scores);
+        if (count == 0) return 0;                      // Full board
+
+        int alphaIn = alpha, best = -MNK_WIN - 1, bestMove = moves[0];
+        for (int n = 0; n < count; n++) {
+            int pick = n;                              // Selection sort, since most nodes cut early
+            for (int m = n + 1; m < count; m++) {
+                if (scores[m] > scores[pick]) pick = m;
+            }
+            swap(moves[n], moves[pick]);
+            swap(scores[n], scores[pick]);
+            int i = moves[n];
+
+            if (Place(player, i)) score = MNK_WIN - ply - 1;
+            else if (board.Full()) score = 0;
+            else score = -Negamax(1 - player, depth - 1, -beta, -alpha, ply + 1);
+            Unplace(player, i);
+            if (Stopped()) return 0;
+
+            if (score > best) {
+                best = score;
+                bestMove = i;
+                if (ply == 0) rootMove = i;
+            }
+            if (score > alpha) alpha = score;
+            if (alpha >= beta) {
+                if (i != killers[ply][0]) {
+                    killers[ply][1] = killers[ply][0];
+                    killers[ply][0] = i;
+                }
+                history[player][i] = min(history[player][i] + depth * depth, 1 << 27);
+                break;
+            }
+        }
+
+        int storeBound = best <= alphaIn ? MNK_UPPER : best >= beta ? MNK_LOWER : MNK_EXACT;
+        mnkTable.Store(hash, ToTable(best, ply), bestMove, depth, storeBound);
+        return best;
+    }
+
+public:
+    long long nodes;
+    int bestMove, bestScore, completedDepth;
+
+    void Setup(const MnkGeometry& geometry, const MnkBoard<MNK_MAX_SIDE>& position, int id) {
+        geo = &geometry;
+        board.Reset(geo->rows, geo->cols, geo->k);
+        counts.assign(2 * geo->windows, 0);
+        memset(near, 0, sizeof(near));
+        memset(killers, -1, sizeof(killers));
+        memset(history, 0, sizeof(history));
+        eval = 0;
+        hash = 0x6A09E667F3BCC909ULL;                  // Not 0, which an empty slot would match
+        stones = 0;
+        noise = id ? (uint32_t)id * 0x9E3779B9u : 0;
+        for (int i = 0; i < geo->cells; i++) cell[i] = -1;
+        for (int i = 0; i < geo->cells; i++) {
+            int owner = position.At(i / geo->cols, i % geo->cols);
+            if (owner >= 0) Place(owner, i);
+        }
+        nodes = 0;
+        bestMove = -1;
+        bestScore = 0;
+        completedDepth = 0;
+    }
+
+    // Iterative deepening until the deadline, a forced result, or the end of
+    // the game. The main thread (id 0) always finishes depth 1 so there is a
+    // move to play; helpers on odd ids start a ply deeper.
+    void Run(int player, int id, atomic<bool>& stopFlag, chrono::steady_clock::time_point until) {
+        stop = &stopFlag;
+        deadline = until;
+        int empties = geo->cells - stones;
+        for (int depth = 1 + (id & 1); depth <= min(empties, MNK_MAX_PLY - 1); depth++) {
+            mustFinish = (id == 0 && depth == 1);
+            rootMove = -1;
+            int score = Negamax(player, depth, -MNK_WIN - 1, MNK_WIN + 1, 0);
+            if (Stopped()) break;
+            if (rootMove >= 0) {
+                bestMove = rootMove;
+                bestScore = score;
+                completedDepth = depth;
+            }
+            if (abs(score) > MNK_WIN_BOUND) break;     // Decided
+        }
+    }
+};
+
+// Best move for player on board within budgetMs, on up to threads threads.
+// stopFlag tells the threads to finish: the search raises it when the time is
+// up, and the caller may raise it to give up early.
+MnkSearchResult MnkSearch(const MnkBoard<MNK_MAX_SIDE>& board, int player, int budgetMs, int threads,
+                          atomic<bool>& stopFlag) {
+    static MnkGeometry geometry;
+    static int lastRules = -1;
+    auto start = chrono::steady_clock::now();
+    int rules = (board.Rows() * 32 + board.Cols()) * 32 + board.K();
+    if (rules != lastRules) {
+        geometry.Build(board.Rows(), board.Cols(), board.K());
+        if (mnkTable.Empty()) mnkTable.Resize(MNK_TABLE_BITS);
+        mnkTable.Clear();                              // Cell numbers mean something else now
+        lastRules = rules;
+    }
+
+    MnkSearchResult result = {-1, 0, 0, 0, max(threads, 1), 0};
+    if (!board.Full()) {
+        vector<MnkSearcher> searchers(result.threads);
+        for (int t = 0; t < result.threads; t++) searchers[t].Setup(geometry, board, t);
+        auto deadline = start + chrono::milliseconds(max(budgetMs, 1));
+        searchJobs.ParallelFor(result.threads, 1, [&](int begin, int end) {
+            for (int t = begin; t < end; t++) searchers[t].Run(player, t, stopFlag, deadline);
+        });
+        for (const MnkSearcher& s : searchers) {
+            result.nodes += s.nodes;
+            if (s.bestMove >= 0 && s.completedDepth > result.depth) {
+                result.move = s.bestMove;
+                result.score = s.bestScore;
+                result.depth = s.completedDepth;
+            }
+        }
+    }
+    result.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MONTE CARLO TREE SEARCH
+// ═══════════════════════════════════════════════════════════════════════════
+
+// The other computer player, for boards too wide for alpha-beta to see far:
+// UCT over random playouts. All threads grow one shared tree (tree
+// parallelism). A thread counts its visit on every node on the way down and
+// adds the result on the way back up, so until then the visit reads as a loss
+// (virtual loss) and other threads spread out instead of following it. Nodes
+// come from a preallocated arena; when it runs out, leaves stop expanding and
+// the search goes on with playouts only.
+const int MCTS_ARENA_NODES = 1 << 20;            // 16 MB
+const int MCTS_EXPAND_VISITS = 4;                // Visits before a leaf grows children
+const float MCTS_EXPLORATION = 1.0f;
+
+struct MctsNode {
+    atomic<int32_t> visits;          // Including visits still on their way back up
+    atomic<int32_t> score;           // 2 per win, 1 per draw, for the player who moved here
+    atomic<int32_t> firstChild;      // MCTS_LEAF, MCTS_EXPANDING, or an arena index
+    int16_t move;
+    uint16_t childCount;             // Written before firstChild is published
+};
+static_assert(sizeof(MctsNode) == 16, "MctsNode should stay 16 bytes");
+
+const int32_t MCTS_LEAF = -1;
+const int32_t MCTS_EXPANDING = -2;               // Also left on a leaf the full arena could not expand
+
+class MctsArena {
+private:
+    unique_ptr<MctsNode[]> nodes;
+    atomic<int> used{0};
+
+public:
+    // Empties the arena and makes the root (index 0)
+    void Reset() {
+        if (!nodes) nodes.reset(new MctsNode[MCTS_ARENA_NODES]);
+        used = 1;
+        Init(0, -1);
+    }
+
+    void Init(int index, int move) {
+        MctsNode& n = nodes[index];
+        n.visits.store(0, memory_order_relaxed);
+        n.score.store(0, memory_order_relaxed);
+        n.firstChild.store(MCTS_LEAF, memory_order_relaxed);
+        n.move = (int16_t)move;
+        n.childCount = 0;
+    }
+
+    // First of count consecutive nodes, or -1 when the arena is full
+    int Allocate(int count) {
+        int first = used.fetch_add(count, memory_order_relaxed);
+        return (first + count <= MCTS_ARENA_NODES) ? first : -1;
+    }
+
+    int Used() const { return min(used.load(memory_order_relaxed), MCTS_ARENA_NODES); }
+    MctsNode& operator[](int index) { return nodes[index]; }
+};
+
+MctsArena mctsArena;
+
+class MctsWorker {
+private:
+    MnkBoard<MNK_MAX_SIDE> rootBoard, board;
+    int8_t rootCell[MNK_CELLS], cell[MNK_CELLS];
+    int16_t rootEmpty[MNK_CELLS], empty[MNK_CELLS];        // Empty cells, and where each sits in empty[]
+    int16_t rootWhere[MNK_CELLS], where[MNK_CELLS];
+    int rootEmpties, empties;
+    int rows, cols, cells;
+    bool allMoves;
+    uint32_t rng;
+
+    uint32_t Random() {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        return rng;
+    }
+
+    // Plays cell i on the working copy; returns true if it wins
+    bool Play(int player, int i) {
+        cell[i] = (int8_t)player;
+        int last = empty[--empties];
+        empty[where[i]] = (int16_t)last;
+        where[last] = where[i];
+        return board.Place(player, i / cols, i % cols);
+    }
+
+    // Empty cells next to a stone, or every empty cell on small boards. An
+    // empty large board opens in the middle, like the alpha-beta searcher.
+    int Candidates(int16_t* out) const {
+        if (empties == cells && !allMoves) {
+            out[0] = (int16_t)(rows / 2 * cols + cols / 2);
+            return 1;
+        }
+        int count = 0;
+        bool all = allMoves;
+        for (int i = 0; i < cells; i++) {
+            if (cell[i] >= 0) continue;
+            bool near = all;
+            int r = i / cols, c = i % cols;
+            for (int y = max(r - 1, 0); y <= min(r + 1, rows - 1) && !near; y++) {
+                for (int x = max(c - 1, 0); x <= min(c + 1, cols - 1) && !near; x++) near = cell[y * cols + x] >= 0;
+            }
+            if (near) out[count++] = (int16_t)i;
+        }
+        return count;
+    }
+
+    // Random moves to the end of the game; the winner, or -1 for a draw
+    int Playout(int player) {
+        while (empties > 0) {
+            int i = empty[Random() % (uint32_t)empties];
+            if (Play(player, i)) return player;
+            player = 1 - player;
+        }
+        return -1;
+    }
+
+    void Expand(MctsNode& node) {
+        int16_t moves[MNK_CELLS];
+        int count = Candidates(moves);
+        int first = count ? mctsArena.Allocate(count) : -1;
+        if (first < 0) return;                           // Stays MCTS_EXPANDING: a leaf for good
+        for (int n = 0; n < count; n++) mctsArena.Init(first + n, moves[n]);
+        node.childCount = (uint16_t)count;
+        node.firstChild.store(first, memory_order_release);
+    }
+
+    int Select(const MctsNode& node, int first) {
+        float logParent = logf((float)max(node.visits.load(memory_order_relaxed), 1));
+        int best = first;
+        float bestValue = -1;
+        for (int n = first; n < first + node.childCount; n++) {
+            const MctsNode& child = mctsArena[n];
+            int visits = child.visits.load(memory_order_relaxed);
+            if (visits == 0) return n;
+            float value = child.score.load(memory_order_relaxed) / (2.0f * visits) +
+                          MCTS_EXPLORATION * sqrtf(logParent / visits);
+            if (value > bestValue) {
+                bestValue = value;
+                best = n;
+            }
+        }
+        return best;
+    }
+
+public:
+    long long playouts;
+    int deepest;
+
+    void Setup(const MnkBoard<MNK_MAX_SIDE>& position, int id) {
+        rows = position.Rows();
+        cols = position.Cols();
+        cells = rows * cols;
+        allMoves = cells <= 25;
+        rootBoard = position;
+        rootEmpties = 0;
+        for (int i = 0; i < cells; i++) {
+            rootCell[i] = (int8_t)position.At(i / cols, i % cols);
+            if (rootCell[i] < 0) {
+                rootWhere[i] = (int16_t)rootEmpties;
+                rootEmpty[rootEmpties++] = (int16_t)i;
+            }
+        }
+        rng = 0x2545F491u * (uint32_t)(id + 1);
+        playouts = 0;
+        deepest = 0;
+    }
+
+    // One descent, playout and update from the root, for player to move there
+    void Iterate(int rootPlayer) {
+        board = rootBoard;
+        memcpy(cell, rootCell, cells);
+        memcpy(empty, rootEmpty, rootEmpties * sizeof(int16_t));
+        memcpy(where, rootWhere, cells * sizeof(int16_t));
+        empties = rootEmpties;
+
+        int path[MNK_CELLS + 1];
+        int length = 0, player = rootPlayer, winner = -2;
+        path[length++] = 0;
+        mctsArena[0].visits.fetch_add(1, memory_order_relaxed);
+        while (true) {
+            MctsNode& node = mctsArena[path[length - 1]];
+            int first = node.firstChild.load(memory_order_acquire);
+            if (first == MCTS_LEAF && node.visits.load(memory_order_relaxed) > MCTS_EXPAND_VISITS) {
+                int32_t expected = MCTS_LEAF;
+                if (node.firstChild.compare_exchange_strong(expected, MCTS_EXPANDING, memory_order_acq_rel)) {
+                    Expand(node);
+                    first = node.firstChild.load(memory_order_acquire);
+                }
+            }
+            if (first < 0) break;                        // A leaf, or another thread is expanding it
+
+            int next = Select(node, first);
+            mctsArena[next].visits.fetch_add(1, memory_order_relaxed);    // The virtual loss
+            path[length++] = next;
+            if (Play(player, mctsArena[next].move)) {
+                winner = player;
+                break;
+            }
+            if (empties == 0) {
+                winner = -1;
+                break;
+            }
+            player = 1 - player;
+        }
+        if (winner == -2) winner = Playout(player);
+        playouts++;
+        deepest = max(deepest, length - 1);
+
+        // Path entry n was reached by a move of rootPlayer on odd n
+        for (int n = 0; n < length; n++) {
+            int mover = (n & 1) ? rootPlayer : 1 - rootPlayer;
+            int points = (winner == mover) ? 2 : (winner < 0) ? 1 : 0;
+            if (points) mctsArena[path[n]].score.fetch_add(points, memory_order_relaxed);
+        }
+    }
+};
+
+// Most visited move for player on board after budgetMs of playouts on up to
+// threads threads. The score is the expected result per mille (1000 = win).
+MnkSearchResult MctsSearch(const MnkBoard<MNK_MAX_SIDE>& board, int player, int budgetMs, int threads,
+                           atomic<bool>& stopFlag) {
+    auto start = chrono::steady_clock::now();
+    MnkSearchResult result = {-1, 0, 0, 0, max(threads, 1), 0};
+    if (!board.Full()) {
+        mctsArena.Reset();
+        vector<MctsWorker> workers(result.threads);
+        for (int t = 0; t < result.threads; t++) workers[t].Setup(board, t);
+        auto deadline = start + chrono::milliseconds(max(budgetMs, 1));
+        searchJobs.ParallelFor(result.threads, 1, [&](int begin, int end) {
+            for (int t = begin; t < end; t++) {
+                // Past the deadline only once the root has children to pick from
+                for (int n = 1; !stopFlag.load(memory_order_relaxed); n++) {
+                    workers[t].Iterate(player);
+                    if ((n & 63) == 0 && mctsArena[0].firstChild.load(memory_order_relaxed) >= 0 &&
+                        chrono::steady_clock::now() >= deadline) break;
+                }
+            }
+        });
+
+        MctsNode& root = mctsArena[0];
+        int first = root.firstChild.load(memory_order_acquire), most = -1;
+        for (int n = first; first >= 0 && n < first + root.childCount; n++) {
+            int visits = mctsArena[n].visits.load(memory_order_relaxed);
+            if (visits > most) {
+                most = visits;
+                result.move = mctsArena[n].move;
+                result.score = visits ? mctsArena[n].score.load(memory_order_relaxed) * 500 / visits : 0;
+            }
+        }
+        for (const MctsWorker& w : workers) {
+            result.nodes += w.playouts;
+            result.depth = max(result.depth, w.deepest);
+        }
+    }
+    result.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+enum MnkEngine { MNK_ALPHA_BETA, MNK_MCTS };
+
+// Computer opponents, weakest first. The budget is a share of --ai-ms.
+struct MnkLevel {
+    const char* name;
+    MnkEngine engine;
+    int budgetPercent;
+};
+
+const MnkLevel MNK_LEVELS[] = {
+    {"Easy", MNK_MCTS, 10},
+    {"Normal", MNK_MCTS, 100},
+    {"Hard", MNK_ALPHA_BETA, 100},
+};
+const int MNK_LEVEL_COUNT = sizeof(MNK_LEVELS) / sizeof(MNK_LEVELS[0]);
+
+// Runs a search off the simulation thread so the game keeps ticking while
+// the computer thinks. Used from the simulation thread only.
+class MnkAi {
+private:
+    // One long-lived thread runs every search, so it registers with
+    // searchJobs once instead of taking a new queue for each move
+    thread worker;
+    mutex lock;
+    condition_variable wake;
+    function<MnkSearchResult(atomic<bool>&)> request;
+    bool pending = false;               // request is waiting for the worker
+    bool running = false;               // The worker is inside a search
+    bool busy = false;                  // Started and not yet polled or cancelled
+    bool quit = false;
+    atomic<bool> stop{false};
+    atomic<bool> ready{false};
+    MnkSearchResult result;
+
+    void Run() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            wake.wait(guard, [this]() { return pending || quit; });
+            if (quit) return;
+            function<MnkSearchResult(atomic<bool>&)> search = move(request);
+            pending = false;
+            running = true;
+            guard.unlock();
+            MnkSearchResult found = search(stop);
+            guard.lock();
+            running = false;
+            result = found;
+            ready.store(true, memory_order_release);
+            wake.notify_all();
+        }
+    }
+
+public:
+    ~MnkAi() {
+        Cancel();
+        {
+            lock_guard<mutex> guard(lock);
+            quit = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    // search(stop) runs on the worker thread and returns the move to play
+    template <typename Search>
+    void Start(const Search& search) {
+        Cancel();
+        lock_guard<mutex> guard(lock);
+        if (!worker.joinable()) worker = thread(&MnkAi::Run, this);
+        stop = false;
+        request = search;
+        pending = true;
+        busy = true;
+        wake.notify_all();
+    }
+
+    void Think(const MnkBoard<MNK_MAX_SIDE>& board, int player, MnkEngine engine, int budgetMs) {
+        Start([board, player, engine, budgetMs](atomic<bool>& stopFlag) {
+            return (engine == MNK_MCTS) ? MctsSearch(board, player, budgetMs, searchJobs.Threads(), stopFlag)
+                                        : MnkSearch(board, player, budgetMs, searchJobs.Threads(), stopFlag);
+        });
+    }
+
+    bool Busy() {
+        lock_guard<mutex> guard(lock);
+        return busy;
+    }
+
+    bool Poll(MnkSearchResult& out) {
+        if (!ready.load(memory_order_acquire)) return false;
+        lock_guard<mutex> guard(lock);
+        ready = false;
+        busy = false;
+        out = result;
+        return true;
+    }
+
+    // Abandons the current search, waiting for the worker to leave it
+    void Cancel() {
+        unique_lock<mutex> guard(lock);
+        pending = false;
+        stop = true;
+        wake.wait(guard, [this]() { return !running; });
+        ready = false;
+        busy = false;
+    }
+};
+
+MnkAi mnkAi;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ULTIMATE TIC-TAC-TOE
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Nine 3x3 boards in a 3x3 meta-board. The cell a move takes picks the board
+// the opponent must answer in; if that board is already won or full, any
+// open board will do. Winning a board claims its meta cell, and three claimed
+// in a row win the game. Every board is one 9-bit mask per player and the
+// meta-board three more, so the legal moves are two masks away, a move is a
+// few bit operations and two table lookups, and a position copies as 44 bytes.
+const uint16_t ULTIMATE_LINES[8] = {0x007, 0x038, 0x1C0, 0x049, 0x092, 0x124, 0x111, 0x054};
+const uint16_t ULTIMATE_ALL = 0x1FF;
+
+struct UltimateTables {
+    bool line[512];                  // The mask holds three in a row
+    uint8_t count[512];              // Bits set
+    UltimateTables() {
+        for (int m = 0; m < 512; m++) {
+            line[m] = false;
+            for (uint16_t l : ULTIMATE_LINES) line[m] = line[m] || (m & l) == l;
+            count[m] = (uint8_t)((m & 1) + (m >> 1 & 1) + (m >> 2 & 1) + (m >> 3 & 1) + (m >> 4 & 1) +
+                                 (m >> 5 & 1) + (m >> 6 & 1) + (m >> 7 & 1) + (m >> 8 & 1));
+        }
+    }
+};
+
+const UltimateTables ultimateTables;
+
+// Moves are numbered board * 9 + cell, both counted row by row
+struct UltimateBoard {
+    uint16_t marks[2][9];
+    uint16_t claimed[2];             // Meta-board: boards each player has won
+    uint16_t closed;                 // Boards won or full
+    int8_t next;                     // Board the next move must go in, or -1 for any open one
+    int8_t toMove;
+    int8_t result;                   // -1 while playing, else the winner, or 2 for a draw
+    uint8_t played;
+
+    void Reset() {
+        memset(this, 0, sizeof(*this));
+        next = -1;
+        result = -1;
+    }
+
+    uint16_t Open(int board) const { return ~(marks[0][board] | marks[1][board]) & ULTIMATE_ALL; }
+
+    // Boards the side to move may play in
+    uint16_t Boards() const {
+        if (result >= 0) return 0;
+        return next >= 0 ? (uint16_t)(1 << next) : (uint16_t)(~closed & ULTIMATE_ALL);
+    }
+
+    bool Legal(int move) const { return (Boards() >> (move / 9) & 1) && (Open(move / 9) >> (move % 9) & 1); }
+
+    // Lists the legal moves; returns how many
+    int Generate(uint8_t* out) const {
+        int count = 0;
+        for (uint16_t boards = Boards(); boards; boards &= boards - 1) {
+            int board = ultimateTables.count[(boards & -boards) - 1];   // Index of the lowest set bit
+            for (uint16_t open = Open(board); open; open &= open - 1) {
+                out[count++] = (uint8_t)(board * 9 + ultimateTables.count[(open & -open) - 1]);
+            }
+        }
+        return count;
+    }
+
+    void Play(int move) {
+        int board = move / 9, cell = move % 9, p = toMove;
+        marks[p][board] |= (uint16_t)(1 << cell);
+        if (ultimateTables.line[marks[p][board]]) {
+            claimed[p] |= (uint16_t)(1 << board);
+            closed |= (uint16_t)(1 << board);
+            if (ultimateTables.line[claimed[p]]) result = (int8_t)p;
+        } else if (!Open(board)) {
+            closed |= (uint16_t)(1 << board);
+        }
+        if (result < 0 && closed == ULTIMATE_ALL) result = 2;
+        next = (closed >> cell & 1) ? -1 : (int8_t)cell;
+        toMove = (int8_t)(1 - p);
+        played++;
+    }
+};
+
+// Iterative-deepening alpha-beta over copies of the position, with killer
+// and history ordering and the same wall-clock budget as the m,n,k search.
+// The branching factor stays small (usually 9 or fewer), so it runs on one
+// thread and still sees 8 to 10 moves ahead in a quarter of a second.
+class UltimateSearcher {
+private:
+    int killers[MNK_MAX_PLY][2];
+    int history[2][81];
+    int rootMove;
+    bool mustFinish;
+    atomic<bool>* stop;
+    chrono::steady_clock::time_point deadline;
+
+    // Open lines on the meta-board and inside every open board, for player
+    static int Evaluate(const UltimateBoard& b, int player) {
+        static const int META[3] = {0, 40, 400};
+        static const int LOCAL[3] = {0, 1, 6};
+        int other = 1 - player, score = 0;
+        uint16_t dead = b.closed & ~(b.claimed[0] | b.claimed[1]);
+        for (uint16_t l : ULTIMATE_LINES) {
+            if (dead & l) continue;
+            int mine = ultimateTables.count[b.claimed[player] & l], theirs = ultimateTables.count[b.claimed[other] & l];
+            if (!theirs) score += META[mine];
+            if (!mine) score -= META[theirs];
+        }
+        for (int board = 0; board < 9; board++) {
+            if (b.closed >> board & 1) continue;
+            int weight = (board & 1) ? 2 : 3;                           // Centre and corners count more
+            for (uint16_t l : ULTIMATE_LINES) {
+                int mine = ultimateTables.count[b.marks[player][board] & l];
+                int theirs = ultimateTables.count[b.marks[other][board] & l];
+                if (!theirs) score += LOCAL[mine] * weight;
+                if (!mine) score -= LOCAL[theirs] * weight;
+            }
+        }
+        return score;
+    }
+
+    bool Stopped() const { return !mustFinish && stop->load(memory_order_relaxed); }
+
+    int Negamax(const UltimateBoard& b, int depth, int alpha, int beta, int ply) {
+        if ((++nodes & MNK_TIME_CHECK) == 0 && chrono::steady_clock::now() >= deadline) {
+            stop->store(true, memory_order_relaxed);
+        }
+        if (Stopped()) return 0;
+        if (b.result >= 0) return b.result == 2 ? 0 : -(MNK_WIN - ply);     // The side that just moved won
+        if (depth <= 0 || ply >= MNK_MAX_PLY - 1) return Evaluate(b, b.toMove);
+
+        uint8_t moves[81];
+        int scores[81];
+        int count = b.Generate(moves);
+        if (count == 0) return 0;                // Only a finished game has no moves
+        for (int n = 0; n < count; n++) {
+            int m = moves[n];
+            scores[n] = (ply == 0 && m == rootMove) ? 1 << 30 : (m == killers[ply][0]) ? 1 << 29 :
+                        (m == killers[ply][1]) ? 1 << 28 : history[b.toMove][m];
+        }
+
+        int best = -MNK_WIN - 1, bestMove = -1;
+        for (int n = 0; n < count; n++) {
+            int pick = n;
+            for (int m = n + 1; m < count; m++) {
+                if (scores[m] > scores[pick]) pick = m;
+            }
+            swap(moves[n], moves[pick]);
+            swap(scores[n], scores[pick]);
+
+            UltimateBoard child = b;
+            child.Play(moves[n]);
+            int score = -Negamax(child, depth - 1, -beta, -alpha, ply + 1);
+            if (Stopped()) return 0;
+            if (score > best) {
+                best = score;
+                bestMove = moves[n];
+            }
+            if (score > alpha) alpha = score;
+            if (alpha >= beta) {
+                if (moves[n] != killers[ply][0]) {
+                    killers[ply][1] = killers[ply][0];
+                    killers[ply][0] = moves[n];
+                }
+                history[b.toMove][moves[n]] = min(history[b.toMove][moves[n]] + depth * depth, 1 << 27);
+                break;
+            }
+        }
+        if (ply == 0) bestRootMove = bestMove;
+        return best;
+    }
+
+public:
+    long long nodes;
+    int bestRootMove;
+
+    MnkSearchResult Run(const UltimateBoard& board, int budgetMs, atomic<bool>& stopFlag) {
+        auto start = chrono::steady_clock::now();
+        stop = &stopFlag;
+        deadline = start + chrono::milliseconds(max(budgetMs, 1));
+        memset(killers, -1, sizeof(killers));
+        memset(history, 0, sizeof(history));
+        nodes = 0;
+        rootMove = -1;
+        MnkSearchResult result = {-1, 0, 0, 0, 1, 0};
+        int left = 81 - board.played;
+        for (int depth = 1; board.result < 0 && depth <= min(left, MNK_MAX_PLY - 1); depth++) {
+            mustFinish = (depth == 1);
+            bestRootMove = -1;
+            int score = Negamax(board, depth, -MNK_WIN - 1, MNK_WIN + 1, 0);
+            if (Stopped()) break;
+            result.move = rootMove = bestRootMove;
+            result.score = score;
+            result.depth = depth;
+            if (abs(score) > MNK_WIN_BOUND) break;
+        }
+        result.nodes = nodes;
+        result.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        return result;
+    }
+};
+
+MnkSearchResult UltimateSearch(const UltimateBoard& board, int budgetMs, atomic<bool>& stopFlag) {
+    UltimateSearcher searcher;
+    return searcher.Run(board, budgetMs, stopFlag);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// QUBIC
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Tic-Tac-Toe on a 4x4x4 cube, four in a row along any of its 76 lines: 48
+// along the axes, 24 diagonals of the 12 axis planes and 4 through the
+// centre. Cell layer * 16 + row * 4 + col is one bit of a 64-bit mask per
+// player and every line is a mask too, so a win check is an AND and a compare
+// for each of the 4 or 7 lines through the move.
+const int QUBIC_LINE_COUNT = 76;
+const uint64_t QUBIC_DEBRUIJN = 0x03F79D71B4CB0A89ULL;
+
+struct QubicTables {
+    uint64_t lines[QUBIC_LINE_COUNT];
+    uint8_t cellLines[64][7];        // Lines through each cell
+    uint8_t cellLineCount[64];       // 7 for the corners and the centre eight, 4 for the rest
+    uint8_t lowest[64];              // De Bruijn index of a lone bit to its position
+    int lineCount;
+
+    QubicTables() {
+        memset(cellLineCount, 0, sizeof(cellLineCount));
+        lineCount = 0;
+        // One of each opposite pair of the 26 directions, from every start that stays inside
+        for (int dz = -1; dz <= 1; dz++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (!(dz > 0 || (dz == 0 && (dy > 0 || (dy == 0 && dx > 0))))) continue;
+                    for (int start = 0; start < 64; start++) {
+                        int z = start / 16, y = start / 4 % 4, x = start % 4;
+                        if (z + 3 * dz < 0 || z + 3 * dz > 3 || y + 3 * dy < 0 || y + 3 * dy > 3 ||
+                            x + 3 * dx < 0 || x + 3 * dx > 3) continue;
+                        uint64_t mask = 0;
+                        for (int n = 0; n < 4; n++) {
+                            int cell = (z + n * dz) * 16 + (y + n * dy) * 4 + x + n * dx;
+                            mask |= 1ULL << cell;
+                            cellLines[cell][cellLineCount[cell]++] = (uint8_t)lineCount;
+                        }
+                        lines[lineCount++] = mask;
+                    }
+                }
+            }
+        }
+        for (int i = 0; i < 64; i++) lowest[((1ULL << i) * QUBIC_DEBRUIJN) >> 58] = (uint8_t)i;
+    }
+
+    int Lowest(uint64_t mask) const { return lowest[((mask & (0 - mask)) * QUBIC_DEBRUIJN) >> 58]; }
+};
+
+const QubicTables qubicTables;
+
+struct QubicBoard {
+    uint64_t marks[2];
+    int8_t toMove;
+    int8_t result;                   // -1 while playing, else the winner, or 2 for a draw
+    int8_t winLine;                  // Index into qubicTables.lines once someone has won
+    uint8_t played;
+
+    void Reset() {
+        marks[0] = marks[1] = 0;
+        toMove = 0;
+        result = winLine = -1;
+        played = 0;
+    }
+
+    uint64_t Empty() const { return ~(marks[0] | marks[1]); }
+    int At(int cell) const { return (marks[0] >> cell & 1) ? 0 : (marks[1] >> cell & 1) ? 1 : -1; }
+    bool Legal(int cell) const { return result < 0 && cell >= 0 && cell < 64 && (Empty() >> cell & 1); }
+
+    // Lists the legal moves, lowest cell first; returns how many
+    int Generate(uint8_t* out) const {
+        int count = 0;
+        for (uint64_t open = (result < 0) ? Empty() : 0; open; open &= open - 1) {
+            out[count++] = (uint8_t)qubicTables.Lowest(open);
+        }
+        return count;
+    }
+
+    // The line player would complete by taking cell, or -1
+    int Completes(int player, int cell) const {
+        uint64_t mine = marks[player] | 1ULL << cell;
+        for (int i = 0; i < qubicTables.cellLineCount[cell]; i++) {
+            uint64_t line = qubicTables.lines[qubicTables.cellLines[cell][i]];
+            if ((mine & line) == line) return qubicTables.cellLines[cell][i];
+        }
+        return -1;
+    }
+
+    void Play(int cell) {
+        int line = Completes(toMove, cell);
+        marks[toMove] |= 1ULL << cell;
+        played++;
+        if (line >= 0) {
+            result = toMove;
+            winLine = (int8_t)line;
+        } else if (played == 64) {
+            result = 2;
+        }
+        toMove = (int8_t)(1 - toMove);
+    }
+};
+
+// Threat-space search. Only moves that make a three (three of a line with
+// the fourth empty) are tried, so every reply is forced and the tree stays
+// narrow: the attacker wins once a move makes two threes at once, or a three
+// the defender can't block without the attacker still having another. The
+// defender's forced blocks may make threes of their own, which the attacker
+// then has to block with a move that is itself a three. Proven failures go
+// in a small table keyed on both masks. When neither side has such a
+// sequence, the move comes from counting open lines through each cell.
+class QubicSearcher {
+private:
+    static const int CACHE_BITS = 16;
+    struct CacheEntry {
+        uint64_t mover, waiting;     // Marks of the side to move and of the other
+        int depth;                   // No win for the mover in this many threes or fewer
+        bool truncated;              // The depth limit cut a sequence, so a deeper pass may still win
+    };
+
+    uint64_t marks[2];
+    uint8_t counts[2][QUBIC_LINE_COUNT];
+    vector<CacheEntry> cache;
+    int winMove;
+    bool truncated;                  // Some sequence was cut by the depth limit
+    atomic<bool>* stop;
+    chrono::steady_clock::time_point deadline;
+
+    void Place(int player, int cell) {
+        marks[player] |= 1ULL << cell;
+        for (int i = 0; i < qubicTables.cellLineCount[cell]; i++) counts[player][qubicTables.cellLines[cell][i]]++;
+    }
+
+    void Unplace(int player, int cell) {
+        marks[player] &= ~(1ULL << cell);
+        for (int i = 0; i < qubicTables.cellLineCount[cell]; i++) counts[player][qubicTables.cellLines[cell][i]]--;
+    }
+
+    // Empty cells on lines where player has `have` and the other side none
+    uint64_t Cells(int player, int have) const {
+        uint64_t cells = 0;
+        for (int i = 0; i < QUBIC_LINE_COUNT; i++) {
+            if (counts[player][i] == have && counts[1 - player][i] == 0) cells |= qubicTables.lines[i];
+        }
+        return cells & ~(marks[0] | marks[1]);
+    }
+
+    bool Stopped() {
+        if ((++nodes & MNK_TIME_CHECK) == 0 && chrono::steady_clock::now() >= deadline) {
+            stop->store(true, memory_order_relaxed);
+        }
+        return stop->load(memory_order_relaxed);
+    }
+
+    // Whether player, to move, wins by a run of at most depth threes
+    bool ThreatWin(int player, int depth, int ply) {
+        if (Stopped()) return false;
+        int other = 1 - player;
+        uint64_t wins = Cells(player, 3);
+        if (wins) {
+            if (ply == 0) winMove = qubicTables.Lowest(wins);
+            return true;
+        }
+        uint64_t theirs = Cells(other, 3);
+        if (theirs & (theirs - 1)) return false;                 // Two to block
+        uint64_t tries = Cells(player, 2);
+        if (theirs) tries &= theirs;                             // The block has to be a three as well
+        if (!tries) return false;
+        if (depth == 0) {
+            truncated = true;
+            return false;
+        }
+
+        uint64_t mover = marks[player], waiting = marks[other];
+        CacheEntry& entry = cache[((mover * 0x9E3779B97F4A7C15ULL) ^ (waiting * 0xC2B2AE3D27D4EB4FULL)) >> (64 - CACHE_BITS)];
+        if (entry.mover == mover && entry.waiting == waiting && entry.depth >= depth) {
+            truncated = truncated || entry.truncated;
+            return false;
+        }
+
+        // Track cuts below this position alone, for its cache entry
+        bool cutAbove = truncated;
+        truncated = false;
+        for (; tries; tries &= tries - 1) {
+            int cell = qubicTables.Lowest(tries);
+            Place(player, cell);
+            uint64_t threes = Cells(player, 3);
+            bool won = (threes & (threes - 1)) != 0;             // One block can't stop both
+            if (!won && threes) {
+                int reply = qubicTables.Lowest(threes);
+                Place(other, reply);
+                won = ThreatWin(player, depth - 1, ply + 1);
+                Unplace(other, reply);
+            }
+            Unplace(player, cell);
+            if (won) {
+                if (ply == 0) winMove = cell;
+                truncated = truncated || cutAbove;
+                return true;
+            }
+            if (stop->load(memory_order_relaxed)) return false;
+        }
+        entry = {mover, waiting, depth, truncated};
+        truncated = truncated || cutAbove;
+        return false;
+    }
+
+    // Deepening threat search for player until a win, the budget or nothing left to cut
+    int Proves(int player, chrono::steady_clock::time_point until) {
+        for (int depth = 1; depth <= 32; depth++) {
+            truncated = false;
+            if (ThreatWin(player, depth, 0)) return depth;
+            if (!truncated || chrono::steady_clock::now() >= until || stop->load(memory_order_relaxed)) break;
+        }
+        return 0;
+    }
+
+    // Open lines through the cell, for making our own and for spoiling theirs
+    int Score(int player, int cell) const {
+        static const int ATTACK[4] = {1, 4, 20, 0};
+        static const int DEFEND[4] = {1, 3, 12, 0};
+        int score = 0;
+        for (int i = 0; i < qubicTables.cellLineCount[cell]; i++) {
+            int line = qubicTables.cellLines[cell][i], mine = counts[player][line], theirs = counts[1 - player][line];
+            if (!theirs) score += ATTACK[mine];
+            if (!mine) score += DEFEND[theirs];
+        }
+        return score;
+    }
+
+public:
+    long long nodes;
+
+    MnkSearchResult Run(const QubicBoard& board, int budgetMs, atomic<bool>& stopFlag) {
+        auto start = chrono::steady_clock::now();
+        stop = &stopFlag;
+        deadline = start + chrono::milliseconds(max(budgetMs, 1));
+        cache.assign(1 << CACHE_BITS, CacheEntry{0, 0, -1, false});
+        marks[0] = marks[1] = 0;
+        memset(counts, 0, sizeof(counts));
+        for (int p = 0; p < 2; p++) {
+            for (uint64_t m = board.marks[p]; m; m &= m - 1) Place(p, qubicTables.Lowest(m));
+        }
+        nodes = 0;
+        MnkSearchResult result = {-1, 0, 0, 0, 1, 0};
+        int player = board.toMove, other = 1 - player;
+        auto finish = [&]() {
+            result.nodes = nodes;
+            result.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            return result;
+        };
+        if (board.result >= 0) return finish();
+
+        // Candidates best first by open lines, so there is always an answer
+        uint8_t moves[64];
+        int scores[64];
+        int count = board.Generate(moves);
+        for (int n = 0; n < count; n++) scores[n] = Score(player, moves[n]) * 64 + 63 - moves[n];
+        for (int n = 1; n < count; n++) {
+            for (int m = n; m > 0 && scores[m] > scores[m - 1]; m--) {
+                swap(scores[m], scores[m - 1]);
+                swap(moves[m], moves[m - 1]);
+            }
+        }
+        result.move = moves[0];
+        result.score = scores[0] / 64;
+
+        // Win now, or block their three
+        uint64_t wins = Cells(player, 3), theirs = Cells(other, 3);
+        if (wins || theirs) {
+            result.move = qubicTables.Lowest(wins ? wins : theirs);
+            result.score = wins ? MNK_WIN - 1 : (theirs & (theirs - 1)) ? -(MNK_WIN - 2) : result.score;
+            result.depth = 1;
+            return finish();
+        }
+
+        // A forced win of our own, in up to half the budget
+        int depth = Proves(player, start + chrono::milliseconds(max(budgetMs / 2, 1)));
+        if (depth) {
+            result.move = winMove;
+            result.score = MNK_WIN - 2 * depth + 1;
+            result.depth = depth;
+            return finish();
+        }
+
+        // Theirs, as if we passed: take the first candidate that leaves them none
+        depth = stop->load(memory_order_relaxed) ? 0 : Proves(other, deadline);
+        result.depth = depth;
+        if (depth) {
+            result.score = -(MNK_WIN - 2 * depth);
+            for (int n = 0; n < count; n++) {
+                Place(player, moves[n]);
+                bool refutes = !ThreatWin(other, depth, 1);
+                Unplace(player, moves[n]);
+                if (stop->load(memory_order_relaxed)) break;
+                if (refutes) {
+                    result.move = moves[n];
+                    result.score = scores[n] / 64;
+                    break;
+                }
+            }
+        }
+        return finish();
+    }
+};
+
+// Runs until it has an answer or the budget is spent; like MnkSearch, it
+// raises stopFlag itself when time runs out
+MnkSearchResult QubicSearch(const QubicBoard& board, int budgetMs, atomic<bool>& stopFlag) {
+    QubicSearcher searcher;
+    return searcher.Run(board, budgetMs, stopFlag);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TIC-TAC-TOE GAME CLASS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// TAB steps through the m,n,k presets, then the variants after them
+const int ULTIMATE_VARIANT = MNK_PRESET_COUNT;
+const int QUBIC_VARIANT = MNK_PRESET_COUNT + 1;
+const int TIC_TAC_TOE_VARIANTS = MNK_PRESET_COUNT + 2;
+
+class TicTacToeGame {
+private:
+    MnkBoard<MNK_MAX_SIDE> board;
+    UltimateBoard ultimate;
+    QubicBoard qubic;
+    int preset;                        // Index into MNK_PRESETS or a variant, kept across games
+    int opponent;                      // 0: two players, else 1 + index into MNK_LEVELS; the computer plays O
+    bool thinking;                     // A search for O's move is running on mnkAi
+    char currentPlayer;
+    bool gameOver;
+    char winner;
+    float cellSize;
+    float offsetX, offsetY;
+    float animTime;
+
+    bool IsUltimate() const { return preset == ULTIMATE_VARIANT; }
+    bool IsQubic() const { return preset == QUBIC_VARIANT; }
+    bool Fresh() const {
+        return IsUltimate() ? ultimate.played == 0 : IsQubic() ? qubic.played == 0 : board.Moves() == 0;
+    }
+    const char* VariantName() const {
+        return IsUltimate() ? "Ultimate" : IsQubic() ? "Qubic 4x4x4" : MNK_PRESETS[preset].name;
+    }
+
+    void EndGame(char result) {
+        gameOver = true;
+        winner = result;
+        if (result != 'D') EmitResultEffect(!opponent || winner == 'X');
+    }
+
+    // A rows x cols grid with its top left at (x, y) and the stones on it;
+    // owner(row, col) gives -1 for an empty cell, else the player
+    template <typename Owner>
+    void DrawGrid(float x, float y, int rows, int cols, Owner owner) {
+        float thickness = max(1.5f, cellSize / 30);
+        for (int i = 0; i <= cols; i++) {
+            Gfx::Line({x + i * cellSize, y}, {x + i * cellSize, y + rows * cellSize}, thickness, Colors::PRIMARY);
+        }
+        for (int i = 0; i <= rows; i++) {
+            Gfx::Line({x, y + i * cellSize}, {x + cols * cellSize, y + i * cellSize}, thickness, Colors::PRIMARY);
+        }
+
+        // Draw X's and O's, scaled from the 120 px cell the sprites were baked
+        // for. Below half that their strokes thin out, so use Gomoku stones.
+        float scale = cellSize / 120;
+        for (int row = 0; row < rows; row++) {
+            for (int col = 0; col < cols; col++) {
+                int player = owner(row, col);
+                if (player < 0) continue;
+                float cx = x + col * cellSize + cellSize / 2;
+                float cy = y + row * cellSize + cellSize / 2;
+                if (cellSize >= 60) spriteAtlas.Draw(player == 0 ? SPRITE_MARK_X : SPRITE_MARK_O, cx, cy, scale);
+                else Gfx::FillCircle(cx, cy, cellSize * 0.38f, player == 0 ? Colors::SUCCESS : Colors::DANGER);
+            }
+        }
+    }
+
+    // The four layers of the cube left to right, bottom layer first, one
+    // cell apart; a winning line is lit across all the layers it crosses
+    void DrawQubic() {
+        uint64_t lit = (qubic.winLine >= 0) ? qubicTables.lines[qubic.winLine] : 0;
+        for (int layer = 0; layer < 4; layer++) {
+            float x = offsetX + layer * 5 * cellSize;
+            char label[16];
+            snprintf(label, sizeof(label), "Layer %d", layer + 1);
+            DrawUIText(label, x, offsetY - 28, 18, Colors::TEXT_DIM);
+            for (int cell = 0; cell < 16; cell++) {
+                if (lit >> (layer * 16 + cell) & 1) {
+                    Gfx::FillRect(x + (cell % 4) * cellSize, offsetY + (cell / 4) * cellSize, cellSize, cellSize,
+                                  (Color){255, 215, 0, 60});
+                }
+            }
+            DrawGrid(x, offsetY, 4, 4, [&](int row, int col) { return qubic.At(layer * 16 + row * 4 + col); });
+        }
+    }
+
+    // The 3x3 boards of Ultimate, with the ones the next move may go in lit,
+    // and won boards covered by the winner's mark
+    void DrawUltimate() {
+        float block = cellSize * 3;
+        uint16_t playable = gameOver ? 0 : ultimate.Boards();
+        for (int b = 0; b < 9; b++) {
+            if (playable >> b & 1) {
+                Gfx::FillRect(offsetX + (b % 3) * block, offsetY + (b / 3) * block, block, block, (Color){255, 215, 0, 40});
+            }
+        }
+        for (int i = 0; i <= 9; i++) {
+            float thickness = (i % 3 == 0) ? 4 : 1.5f;
+            Gfx::Line({offsetX + i * cellSize, offsetY}, {offsetX + i * cellSize, offsetY + 9 * cellSize}, thickness,
+                      Colors::PRIMARY);
+            Gfx::Line({offsetX, offsetY + i * cellSize}, {offsetX + 9 * cellSize, offsetY + i * cellSize}, thickness,
+                      Colors::PRIMARY);
+        }
+        for (int b = 0; b < 9; b++) {
+            float bx = offsetX + (b % 3) * block, by = offsetY + (b / 3) * block;
+            for (int c = 0; c < 9; c++) {
+                int owner = (ultimate.marks[0][b] >> c & 1) ? 0 : (ultimate.marks[1][b] >> c & 1) ? 1 : -1;
+                if (owner < 0) continue;
+                Gfx::FillCircle(bx + (c % 3) * cellSize + cellSize / 2, by + (c / 3) * cellSize + cellSize / 2,
+                                cellSize * 0.38f, owner == 0 ? Colors::SUCCESS : Colors::DANGER);
+            }
+            if (ultimate.closed >> b & 1) {
+                Gfx::FillRect(bx + 2, by + 2, block - 4, block - 4, (Color){15, 15, 35, 170});
+                for (int p = 0; p < 2; p++) {
+                    if (ultimate.claimed[p] >> b & 1) {
+                        spriteAtlas.Draw(p == 0 ? SPRITE_MARK_X : SPRITE_MARK_O, bx + block / 2, by + block / 2, block / 120);
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    void Init() {
+        if (thinking) mnkAi.Cancel();
+        thinking = false;
+        currentPlayer = 'X';
+        gameOver = false;
+        winner = ' ';
+        int rows = 9, cols = 9;
+        if (IsUltimate()) {
+            ultimate.Reset();
+        } else if (IsQubic()) {
+            qubic.Reset();
+            rows = 4;
+            cols = 19;                 // Four layers of 4 with a cell between each
+        } else {
+            const MnkRules& rules = MNK_PRESETS[preset];
+            board.Reset(rules.rows, rules.cols, rules.k);
+            rows = rules.rows;
+            cols = rules.cols;
+        }
+        // 120 px cells for 3x3, shrinking so 19x19 still fits above the status
+        // line; the cube's layers are only 4 high, so they are fitted to the width
+        cellSize = IsQubic() ? floorf((SCREEN_WIDTH - 100) / (float)cols) : min(120.0f, floorf(380.0f / max(rows, cols)));
+        offsetX = (SCREEN_WIDTH - cellSize * cols) / 2;
+        offsetY = 200 + (360 - cellSize * rows) / 2;
+        animTime = 0;
+    }
+
+    // A board mid-game for screenshots: a fixed pattern of moves, no winner yet
+    void StartDemo(int variant) {
+        preset = min(max(variant, 0), TIC_TAC_TOE_VARIANTS - 1);
+        Init();
+        if (IsUltimate()) {
+            uint8_t moves[81];
+            for (int m = 0; m < 40; m++) {
+                UltimateBoard next = ultimate;
+                next.Play(moves[(m * 7 + 3) % ultimate.Generate(moves)]);
+                if (next.result >= 0) break;
+                ultimate = next;
+            }
+            currentPlayer = ultimate.toMove ? 'O' : 'X';
+            return;
+        }
+        if (IsQubic()) {
+            uint8_t moves[64];
+            for (int m = 0; m < 20; m++) {
+                QubicBoard next = qubic;
+                next.Play(moves[(m * 23 + 5) % qubic.Generate(moves)]);
+                if (next.result >= 0) break;
+                qubic = next;
+            }
+            currentPlayer = qubic.toMove ? 'O' : 'X';
+            return;
+        }
+        int rows = board.Rows(), cols = board.Cols();
+        for (int m = 0; m < rows * cols / 3; m++) {
+            int r = (m * 7 + m / cols) % rows, c = (m * 11 + 3) % cols;
+            int player = board.Moves() & 1;
+            if (board.At(r, c) < 0 && board.Place(player, r, c)) board.Remove(player, r, c);
+        }
+        currentPlayer = (board.Moves() & 1) ? 'O' : 'X';
+    }
+
+    void PlayMove(int row, int col) {
+        if (board.Place(currentPlayer == 'X' ? 0 : 1, row, col)) EndGame(currentPlayer);
+        else if (board.Full()) EndGame('D');
+        else currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
+    }
+
+    void PlayUltimate(int move) {
+        ultimate.Play(move);
+        if (ultimate.result >= 0) EndGame(ultimate.result == 2 ? 'D' : ultimate.result == 0 ? 'X' : 'O');
+        else currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
+    }
+
+    void PlayQubic(int cell) {
+        qubic.Play(cell);
+        if (qubic.result >= 0) EndGame(qubic.result == 2 ? 'D' : qubic.result == 0 ? 'X' : 'O');
+        else currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
+    }
+
+    bool Update() {  // Returns true if should go back to menu
+        animTime += FrameDelta();
+
+        if (gameInput.KeyPressed(KEY_ESCAPE) || gameInput.KeyPressed(KEY_M)) {
+            if (thinking) mnkAi.Cancel();
+            thinking = false;
+            return true;
+        }
+
+        // The board and opponent can change before the first move or after a game
+        if (gameOver || Fresh()) {
+            if (gameInput.KeyPressed(KEY_TAB)) {
+                preset = (preset + 1) % TIC_TAC_TOE_VARIANTS;
+                Init();
+            }
+            if (gameInput.KeyPressed(KEY_C)) {
+                opponent = (opponent + 1) % (MNK_LEVEL_COUNT + 1);
+                Init();
+            }
+        }
+
+        if (!gameOver && opponent && currentPlayer == 'O') {
+            // The search runs off this thread; the game keeps ticking until it answers
+            // Ultimate and Qubic have searches of their own; the level only sets their budget
+            if (!thinking) {
+                const MnkLevel& level = MNK_LEVELS[opponent - 1];
+                int budget = max(mnkThinkMs * level.budgetPercent / 100, 1);
+                if (IsUltimate()) {
+                    UltimateBoard position = ultimate;
+                    mnkAi.Start([position, budget](atomic<bool>& stop) { return UltimateSearch(position, budget, stop); });
+                } else if (IsQubic()) {
+                    QubicBoard position = qubic;
+                    mnkAi.Start([position, budget](atomic<bool>& stop) { return QubicSearch(position, budget, stop); });
+                } else {
+                    mnkAi.Think(board, 1, level.engine, budget);
+                }
+                thinking = true;
+            }
+            MnkSearchResult result;
+            if (mnkAi.Poll(result)) {
+                thinking = false;
+                if (result.move >= 0 && IsUltimate()) PlayUltimate(result.move);
+                else if (result.move >= 0 && IsQubic()) PlayQubic(result.move);
+                else if (result.move >= 0) PlayMove(result.move / board.Cols(), result.move % board.Cols());
+            }
+        } else if (!gameOver && gameInput.MousePressed(MOUSE_LEFT_BUTTON)) {
+            Vector2 mouse = gameInput.MousePosition();
+            int col = (int)floorf((mouse.x - offsetX) / cellSize);
+            int row = (int)floorf((mouse.y - offsetY) / cellSize);
+
+            if (IsUltimate()) {
+                // Row and column on the 9x9 grid to board and cell within it
+                int move = ((row / 3) * 3 + col / 3) * 9 + (row % 3) * 3 + col % 3;
+                if (col >= 0 && col < 9 && row >= 0 && row < 9 && ultimate.Legal(move)) PlayUltimate(move);
+            } else if (IsQubic()) {
+                // Every fifth column is the gap between two layers
+                int cell = (col / 5) * 16 + row * 4 + col % 5;
+                if (col >= 0 && col < 19 && col % 5 < 4 && row >= 0 && row < 4 && qubic.Legal(cell)) PlayQubic(cell);
+            } else if (col >= 0 && col < board.Cols() && row >= 0 && row < board.Rows() && board.At(row, col) < 0) {
+                PlayMove(row, col);
+            }
+        }
+
+        if (gameOver && gameInput.KeyPressed(KEY_SPACE)) Init();
+
+        return false;
+    }
+
+    void Draw() {
+        DrawAnimatedBackground();
+
+        // Title
+        DrawTextCentered("TIC-TAC-TOE", 50, 50, Colors::ACCENT);
+        char subtitle[64];
+        if (opponent) snprintf(subtitle, sizeof(subtitle), "vs Computer (%s) - %s", MNK_LEVELS[opponent - 1].name,
+                               VariantName());
+        else snprintf(subtitle, sizeof(subtitle), "2-Player Game - %s", VariantName());
+        DrawTextCentered(subtitle, 110, 24, Colors::TEXT_DIM);
+
+        if (IsUltimate()) {
+            DrawUltimate();
+        } else if (IsQubic()) {
+            DrawQubic();
+        } else {
+            DrawGrid(offsetX, offsetY, board.Rows(), board.Cols(), [this](int row, int col) { return board.At(row, col); });
+        }
+
+        // Current player or result
+        if (!gameOver) {
+            const char* playerText = (currentPlayer == 'X') ? "Player X's Turn"
+                                     : opponent ? "Computer is thinking..." : "Player O's Turn";
+            Color playerColor = (currentPlayer == 'X') ? Colors::SUCCESS : Colors::DANGER;
+            DrawTextCentered(playerText, 580, 30, playerColor);
+        } else {
+            if (winner == 'D') {
+                DrawTextCentered("IT'S A DRAW!", 560, 40, Colors::ACCENT);
+            } else {
+                const char* winText = (winner == 'X') ? "PLAYER X WINS!" : opponent ? "COMPUTER WINS!" : "PLAYER O WINS!";
+                Color winColor = (winner == 'X') ? Colors::SUCCESS : Colors::DANGER;
+                DrawTextCentered(winText, 560, 40, winColor);
+            }
+            DrawTextCentered("Press SPACE to play again", 610, 20, Colors::TEXT_DIM);
+        }
+
+        // Instructions
+        DrawUIText((gameOver || Fresh()) ? "TAB: board size | C: opponent | Press M or ESC to return to menu"
+                                          : "Press M or ESC to return to menu",
+                   20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CONTINUOUS COLLISION
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Asteroids fall faster as the score grows, and once a rock moves further per
+// tick than the ship is wide, checking only end-of-tick positions lets it pass
+// straight through. Instead both circles are swept over the tick and the first
+// time their distance reaches the sum of the radii is solved for directly.
+
+// A rock in classic Space Survivor: four floats, so four rocks load as one
+// 4x4 block that transposes into x, y, speed and size lanes
+struct FallingRock {
+    float x, y;
+    float speed;        // Pixels per tick, straight down
+    float size;
+};
+static_assert(sizeof(FallingRock) == 4 * sizeof(float), "FallingRock must stay four packed floats");
+
+// Time of impact in [0, 1] for a circle starting at offset (rx, ry) from
+// another and moving (dx, dy) relative to it over the tick, or -1 for a miss.
+// Touching exactly counts as a miss, like the old end-of-tick test.
+inline float SweptCircleTime(float rx, float ry, float dx, float dy, float radius) {
+    float c = rx * rx + ry * ry - radius * radius;
+    if (c < 0) return 0;                         // Already overlapping
+    float a = dx * dx + dy * dy;
+    float b = rx * dx + ry * dy;                 // Half of the usual b
+    if (b >= 0 || a == 0) return -1;             // Moving apart or not moving
+    float disc = b * b - a * c;
+    if (disc <= 0) return -1;                    // Passes by, at best grazing
+    float t = (-b - sqrtf(disc)) / a;
+    return (t <= 1) ? t : -1;
+}
+
+// Earliest impact between the ship, moving from shipFrom to shipTo this tick,
+// and any rock, with rocks at their positions before they fall. Returns the
+// rock index (or -1) and stores the time of impact. The SSE2 pass only
+// filters: lanes it flags are confirmed with the scalar solver, so both paths
+// give the same answer. Versus mode tests its circles with it; the classic game
+// takes broadphase candidates to RockHitsShip(), which starts from the same
+// SweptCircleTime() and then checks the outlines (--bench polygons).
+int FirstRockImpact(const FallingRock* rocks, int count, Vector2 shipFrom, Vector2 shipTo, float shipRadius,
+                    float* timeOut = nullptr) {
+    float sdx = shipTo.x - shipFrom.x, sdy = shipTo.y - shipFrom.y;
+    int best = -1;
+    float bestTime = 2;
+    auto confirm = [&](int i) {
+        const FallingRock& r = rocks[i];
+        float t = SweptCircleTime(r.x - shipFrom.x, r.y - shipFrom.y, -sdx, r.speed - sdy, r.size + shipRadius);
+        if (t >= 0 && t < bestTime) {
+            bestTime = t;
+            best = i;
+        }
+    };
+
+    int i = 0;
+#if defined(__SSE2__)
+    __m128 shipX = _mm_set1_ps(shipFrom.x), shipY = _mm_set1_ps(shipFrom.y);
+    __m128 relDx = _mm_set1_ps(-sdx), shipDy = _mm_set1_ps(sdy);
+    __m128 shipR = _mm_set1_ps(shipRadius), zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        // One rock per register, transposed into one field per register
+        __m128 x = _mm_loadu_ps(&rocks[i].x);
+        __m128 y = _mm_loadu_ps(&rocks[i + 1].x);
+        __m128 speed = _mm_loadu_ps(&rocks[i + 2].x);
+        __m128 size = _mm_loadu_ps(&rocks[i + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, speed, size);
+
+        __m128 rx = _mm_sub_ps(x, shipX), ry = _mm_sub_ps(y, shipY);
+        __m128 dy = _mm_sub_ps(speed, shipDy);
+        __m128 radius = _mm_add_ps(size, shipR);
+        __m128 c = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_mul_ps(radius, radius));
+        __m128 a = _mm_add_ps(_mm_mul_ps(relDx, relDx), _mm_mul_ps(dy, dy));
+        __m128 b = _mm_add_ps(_mm_mul_ps(rx, relDx), _mm_mul_ps(ry, dy));
+        __m128 disc = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, c));
+        // t <= 1  <=>  -b - sqrt(disc) <= a, with a > 0
+        __m128 reach = _mm_sub_ps(_mm_sub_ps(zero, b), _mm_sqrt_ps(_mm_max_ps(disc, zero)));
+        __m128 sweep = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(b, zero), _mm_cmpgt_ps(disc, zero)),
+                                  _mm_cmple_ps(reach, a));
+        __m128 hit = _mm_or_ps(_mm_cmplt_ps(c, zero), sweep);
+        int mask = _mm_movemask_ps(hit);
+        if (mask == 0) continue;
+        for (int lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) confirm(i + lane);
+        }
+    }
+#endif
+    for (; i < count; i++) confirm(i);
+
+    if (timeOut) *timeOut = (best >= 0) ? bestTime : -1;
+    return best;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SPACE SURVIVOR OPEN FIELD
+// ═══════════════════════════════════════════════════════════════════════════
+
+// A world FIELD_CHUNKS x FIELD_CHUNKS chunks across (about 40 screens each
+// way). Only chunks around the camera exist in memory: those inside the view
+// are simulated and drawn, a ring around it is prefetched by a background
+// thread and kept frozen, and everything further out is dropped. Chunk
+// contents are a pure function of (seed, cx, cy), so a chunk that is dropped
+// and streamed in again looks the same, whichever thread generated it.
+const int FIELD_CHUNK_SIZE = 512;
+const int FIELD_CHUNKS = 80;
+const float FIELD_SIZE = (float)(FIELD_CHUNK_SIZE * FIELD_CHUNKS);
+const int FIELD_MAX_PER_CHUNK = 24;
+const int FIELD_PREFETCH = 1;           // Chunks requested beyond the view
+const int FIELD_KEEP = 2;               // Chunks kept beyond the view before eviction
+const int FIELD_MAX_RESIDENT = 64;      // Covers the keep area for a 1000x700 view
+const int FIELD_MAX_PENDING = 32;
+const float FIELD_SHIP_SPEED = 7.0f;
+
+struct FieldAsteroid {
+    float homeX, homeY;     // World position the asteroid drifts around
+    float orbit;            // Drift radius
+    float phase, spin;      // Angle on the drift circle and its rate (rad/s)
+    float size;
+    float x, y;             // Current world position
+};
+
+struct FieldChunk {
+    int cx, cy;
+    uint32_t seed;
+    int count;
+    FieldAsteroid rocks[FIELD_MAX_PER_CHUNK];
+};
+
+// Small integer hash so chunk generation needs no shared RNG state
+inline uint32_t FieldHash(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352dU;
+    x ^= x >> 15; x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+void GenerateFieldChunk(int cx, int cy, uint32_t seed, FieldChunk& out) {
+    out.cx = cx;
+    out.cy = cy;
+    out.seed = seed;
+    out.count = 0;
+    if (cx < 0 || cy < 0 || cx >= FIELD_CHUNKS || cy >= FIELD_CHUNKS) return;
+
+    uint32_t state = FieldHash(seed ^ FieldHash((uint32_t)cx * 73856093U ^ (uint32_t)cy * 19349663U));
+    auto next = [&state]() {
+        state = FieldHash(state + 0x9e3779b9U);
+        return (state & 0xFFFFFF) / 16777216.0f;
+    };
+
+    // Density rises with distance from the start in the field centre
+    float dx = cx - FIELD_CHUNKS / 2.0f, dy = cy - FIELD_CHUNKS / 2.0f;
+    float density = min(1.0f, sqrtf(dx * dx + dy * dy) / (FIELD_CHUNKS / 2.0f));
+    out.count = (int)(6 + density * (FIELD_MAX_PER_CHUNK - 6) * next());
+    if (cx == FIELD_CHUNKS / 2 && cy == FIELD_CHUNKS / 2) out.count = 0;   // Safe spawn
+
+    for (int i = 0; i < out.count; i++) {
+        FieldAsteroid& a = out.rocks[i];
+        a.size = 15 + next() * 25;
+        a.orbit = 10 + next() * 60;
+        a.homeX = cx * FIELD_CHUNK_SIZE + a.orbit + next() * (FIELD_CHUNK_SIZE - 2 * a.orbit);
+        a.homeY = cy * FIELD_CHUNK_SIZE + a.orbit + next() * (FIELD_CHUNK_SIZE - 2 * a.orbit);
+        a.phase = next() * 2 * PI;
+        a.spin = (next() - 0.5f) * 2.0f;
+        a.x = a.homeX + cosf(a.phase) * a.orbit;
+        a.y = a.homeY + sinf(a.phase) * a.orbit;
+    }
+}
+
+// Background thread that generates requested chunks. Requests and results go
+// through SPSC queues, so exactly one thread (whichever runs the simulation)
+// may call Request() and Poll().
+class ChunkStreamer {
+private:
+    struct ChunkRequest { int cx, cy; uint32_t seed; };
+    SpscQueue<ChunkRequest, 64> requests;
+    SpscQueue<FieldChunk, 64> results;
+    thread worker;
+    atomic<bool> running{false};
+
+    void Run() {
+        ChunkRequest r;
+        FieldChunk chunk;
+        while (running.load(memory_order_acquire)) {
+            if (!requests.Pop(r)) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+                continue;
+            }
+            GenerateFieldChunk(r.cx, r.cy, r.seed, chunk);
+            while (!results.Push(chunk) && running.load(memory_order_acquire)) this_thread::yield();
+        }
+    }
+
+public:
+    ~ChunkStreamer() { Stop(); }
+
+    bool Request(int cx, int cy, uint32_t seed) {
+        if (!running) {
+            running = true;
+            worker = thread(&ChunkStreamer::Run, this);
+        }
+        return requests.Push({cx, cy, seed});
+    }
+
+    bool Poll(FieldChunk& out) { return results.Pop(out); }
+
+    void Stop() {
+        running = false;
+        if (worker.joinable()) worker.join();
+    }
+};
+
+ChunkStreamer chunkStreamer;
+
+class OpenField {
+private:
+    FieldChunk chunks[FIELD_MAX_RESIDENT];
+    int residentCount;
+    struct { int cx, cy; } pending[FIELD_MAX_PENDING];
+    int pendingCount;
+    uint32_t seed;
+    int activeCount;
+    int drawnCount;
+    float distance;
+
+    // Chunk range covering the view plus border chunks on every side
+    void ViewChunks(int border, int& x0, int& y0, int& x1, int& y1) const {
+        float left = camera.target.x - camera.offset.x, top = camera.target.y - camera.offset.y;
+        x0 = (int)floorf(left / FIELD_CHUNK_SIZE) - border;
+        y0 = (int)floorf(top / FIELD_CHUNK_SIZE) - border;
+        x1 = (int)floorf((left + SCREEN_WIDTH) / FIELD_CHUNK_SIZE) + border;
+        y1 = (int)floorf((top + SCREEN_HEIGHT) / FIELD_CHUNK_SIZE) + border;
+    }
+
+    int FindResident(int cx, int cy) const {
+        for (int i = 0; i < residentCount; i++) {
+            if (chunks[i].cx == cx && chunks[i].cy == cy) return i;
+        }
+        return -1;
+    }
+
+    bool IsPending(int cx, int cy) const {
+        for (int i = 0; i < pendingCount; i++) {
+            if (pending[i].cx == cx && pending[i].cy == cy) return true;
+        }
+        return false;
+    }
+
+    void ClearPending(int cx, int cy) {
+        for (int i = 0; i < pendingCount; i++) {
+            if (pending[i].cx == cx && pending[i].cy == cy) {
+                pending[i] = pending[--pendingCount];
+                return;
+            }
+        }
+    }
+
+    static bool InWorld(int cx, int cy) {
+        return cx >= 0 && cy >= 0 && cx < FIELD_CHUNKS && cy < FIELD_CHUNKS;
+    }
+
+    void Stream() {
+        // Drop chunks that drifted out of the keep area
+        int kx0, ky0, kx1, ky1;
+        ViewChunks(FIELD_KEEP, kx0, ky0, kx1, ky1);
+        for (int i = 0; i < residentCount;) {
+            const FieldChunk& c = chunks[i];
+            if (c.cx < kx0 || c.cx > kx1 || c.cy < ky0 || c.cy > ky1) chunks[i] = chunks[--residentCount];
+            else i++;
+        }
+
+        // Take finished chunks from the streamer
+        FieldChunk* slot = residentCount < FIELD_MAX_RESIDENT ? &chunks[residentCount] : nullptr;
+        FieldChunk incoming;
+        while (chunkStreamer.Poll(incoming)) {
+            if (incoming.seed != seed) continue;             // From a previous run
+            ClearPending(incoming.cx, incoming.cy);
+            if (!slot || FindResident(incoming.cx, incoming.cy) >= 0) continue;
+            if (incoming.cx < kx0 || incoming.cx > kx1 || incoming.cy < ky0 || incoming.cy > ky1) continue;
+            *slot = incoming;
+            residentCount++;
+            slot = residentCount < FIELD_MAX_RESIDENT ? &chunks[residentCount] : nullptr;
+        }
+
+        // Visible chunks must exist now; generate any the streamer has not
+        // delivered yet right here rather than letting them pop in late
+        int vx0, vy0, vx1, vy1;
+        ViewChunks(0, vx0, vy0, vx1, vy1);
+        int missing[FIELD_MAX_RESIDENT][2];
+        int missingCount = 0;
+        for (int cy = vy0; cy <= vy1; cy++) {
+            for (int cx = vx0; cx <= vx1; cx++) {
+                if (!InWorld(cx, cy) || FindResident(cx, cy) >= 0) continue;
+                if (residentCount + missingCount >= FIELD_MAX_RESIDENT) continue;
+                missing[missingCount][0] = cx;
+                missing[missingCount][1] = cy;
+                missingCount++;
+            }
+        }
+        FieldChunk* firstFree = &chunks[residentCount];
+        jobs.ParallelFor(missingCount, 1, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) GenerateFieldChunk(missing[i][0], missing[i][1], seed, firstFree[i]);
+        });
+        residentCount += missingCount;
+
+        // Ask the background thread for the ring just outside the view
+        int px0, py0, px1, py1;
+        ViewChunks(FIELD_PREFETCH, px0, py0, px1, py1);
+        for (int cy = py0; cy <= py1; cy++) {
+            for (int cx = px0; cx <= px1; cx++) {
+                if (!InWorld(cx, cy) || pendingCount >= FIELD_MAX_PENDING) continue;
+                if (FindResident(cx, cy) >= 0 || IsPending(cx, cy)) continue;
+                if (chunkStreamer.Request(cx, cy, seed)) pending[pendingCount++] = {cx, cy};
+            }
+        }
+    }
+
+    bool ChunkVisible(const FieldChunk& c) const {
+        int vx0, vy0, vx1, vy1;
+        ViewChunks(0, vx0, vy0, vx1, vy1);
+        return c.cx >= vx0 && c.cx <= vx1 && c.cy >= vy0 && c.cy <= vy1;
+    }
+
+public:
+    Camera2D camera;
+    float shipX, shipY;
+
+    void Init(uint32_t runSeed) {
+        seed = runSeed;
+        residentCount = pendingCount = 0;
+        activeCount = drawnCount = 0;
+        distance = 0;
+        shipX = shipY = FIELD_SIZE / 2 + FIELD_CHUNK_SIZE / 2;
+        camera = {};
+        camera.offset = {SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+        camera.target = {shipX, shipY};
+        camera.zoom = 1.0f;
+        Stream();
+    }
+
+    // Returns true when the ship hit an asteroid
+    bool Update(float dt) {
+        float vx = 0, vy = 0;
+        if (gameInput.KeyDown(KEY_LEFT) || gameInput.KeyDown(KEY_A)) vx -= FIELD_SHIP_SPEED;
+        if (gameInput.KeyDown(KEY_RIGHT) || gameInput.KeyDown(KEY_D)) vx += FIELD_SHIP_SPEED;
+        if (gameInput.KeyDown(KEY_UP) || gameInput.KeyDown(KEY_W)) vy -= FIELD_SHIP_SPEED;
+        if (gameInput.KeyDown(KEY_DOWN) || gameInput.KeyDown(KEY_S)) vy += FIELD_SHIP_SPEED;
+        float oldX = shipX, oldY = shipY;
+        shipX = min(max(shipX + vx, 30.0f), FIELD_SIZE - 30);
+        shipY = min(max(shipY + vy, 30.0f), FIELD_SIZE - 30);
+        distance += sqrtf((shipX - oldX) * (shipX - oldX) + (shipY - oldY) * (shipY - oldY));
+
+        // Camera eases toward the ship
+        camera.target.x += (shipX - camera.target.x) * 0.15f;
+        camera.target.y += (shipY - camera.target.y) * 0.15f;
+
+        Stream();
+
+        // Only chunks in view are simulated; the rest stay frozen until seen.
+        // Chunks are independent, so they are integrated as jobs.
+        FieldChunk* active[FIELD_MAX_RESIDENT];
+        activeCount = 0;
+        for (int i = 0; i < residentCount; i++) {
+            if (ChunkVisible(chunks[i])) active[activeCount++] = &chunks[i];
+        }
+        atomic<bool> hit(false);
+        float sx = shipX, sy = shipY;
+        jobs.ParallelFor(activeCount, 4, [&](int begin, int end) {
+            bool local = false;
+            for (int i = begin; i < end; i++) {
+                FieldChunk& c = *active[i];
+                for (int k = 0; k < c.count; k++) {
+                    FieldAsteroid& a = c.rocks[k];
+                    a.phase += a.spin * dt;
+                    a.x = a.homeX + cosf(a.phase) * a.orbit;
+                    a.y = a.homeY + sinf(a.phase) * a.orbit;
+                    float dx = a.x - sx, dy = a.y - sy;
+                    if (dx * dx + dy * dy < (a.size + 20) * (a.size + 20)) local = true;
+                }
+            }
+            if (local) hit.store(true, memory_order_relaxed);
+        });
+        return hit.load(memory_order_relaxed);
+    }
+
+    int Score() const { return (int)(distance / 10); }
+
+    Vector2 ToScreen(float x, float y) const {
+        return {(x - camera.target.x) * camera.zoom + camera.offset.x,
+                (y - camera.target.y) * camera.zoom + camera.offset.y};
+    }
+
+    // Records visible asteroids into drawQueue on the current layer; off-screen
+    // ones are culled individually
+    void Record() {
+        const FieldChunk* visible[FIELD_MAX_RESIDENT];
+        int visibleCount = 0;
+        for (int i = 0; i < residentCount; i++) {
+            if (ChunkVisible(chunks[i])) visible[visibleCount++] = &chunks[i];
+        }
+
+        atomic<int> drawn(0);
+        const OpenField* self = this;
+        drawQueue.ParallelRecord(visibleCount, 16, [&](DrawList& out, int begin, int end) {
+            int local = 0;
+            for (int i = begin; i < end; i++) {
+                const FieldChunk& c = *visible[i];
+                for (int k = 0; k < c.count; k++) {
+                    const FieldAsteroid& a = c.rocks[k];
+                    Vector2 p = self->ToScreen(a.x, a.y);
+                    float r = a.size * self->camera.zoom;
+                    if (p.x + r < 0 || p.y + r < 0 || p.x - r > SCREEN_WIDTH || p.y - r > SCREEN_HEIGHT) continue;
+                    out.Sprite(SPRITE_ASTEROID, p.x, p.y, a.size / ASTEROID_SPRITE_RADIUS * self->camera.zoom);
+                    local++;
+                }
+            }
+            drawn += local;
+        });
+        drawnCount = drawn;
+    }
+
+    int ResidentChunks() const { return residentCount; }
+    int ActiveChunks() const { return activeCount; }
+    int DrawnAsteroids() const { return drawnCount; }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// POLYGON ASTEROIDS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Classic-mode rocks are convex polygons that spin as they fall, and the
+// narrow phase is a separating-axis test between the drawn outline and
+// SHIP_HULL. Candidates come from a dynamic AABB tree. A leaf is only taken
+// out and reinserted when its rock leaves the enlarged box around it, so a
+// tick costs a few reinsertions plus one O(log n) query, not a rebuild.
+
+const int ROCK_MAX_VERTICES = 10;
+const float AABB_TREE_MARGIN = 4.0f;             // Slack around every leaf box
+const float AABB_TREE_PREDICT = 8.0f;            // Ticks of motion a leaf box leaves room for
+const float SHIP_BOUND_RADIUS = 28.3f;           // Farthest SHIP_HULL vertex from the ship position
+const float SHIP_INNER_RADIUS = 13.0f;           // Radius of the circle inscribed in SHIP_HULL
+
+// Outline in the rock's own frame, counter-clockwise like the ship hull. The
+// farthest vertex sits exactly at the rock's size, so the bounding circle the
+// sweep uses is tight. Also holds the motion FallingRock has no room for.
+struct RockShape {
+    Vector2 local[ROCK_MAX_VERTICES];
+    int count;
+    float inner;            // Distance from the centre to the nearest edge
+    float angle, spin;      // Radians, and radians per tick
+    float drift;            // Sideways pixels per tick, for split fragments
+    int proxy;              // Leaf in the broadphase tree
+};
+
+void GenerateRockShape(float size, uint32_t seed, RockShape& out) {
+    uint32_t state = FieldHash(seed);
+    auto next = [&state]() {
+        state = FieldHash(state + 0x9e3779b9U);
+        return (state & 0xFFFFFF) / 16777216.0f;
+    };
+
+    // Jittered points around a circle, then their convex hull (monotone chain)
+    int n = min(7 + (int)(next() * (ROCK_MAX_VERTICES - 6)), ROCK_MAX_VERTICES);
+    Vector2 points[ROCK_MAX_VERTICES];
+    for (int i = 0; i < n; i++) {
+        float a = (i + (next() - 0.5f) * 0.6f) * 2 * PI / n;
+        float r = size * (0.7f + 0.3f * next());
+        points[i] = {cosf(a) * r, sinf(a) * r};
+    }
+    // Insertion sort by x, then y; at most ROCK_MAX_VERTICES points
+    for (int i = 1; i < n; i++) {
+        Vector2 p = points[i];
+        int j = i;
+        for (; j > 0 && (p.x < points[j - 1].x || (p.x == points[j - 1].x && p.y < points[j - 1].y)); j--) {
+            points[j] = points[j - 1];
+        }
+        points[j] = p;
+    }
+    auto turn = [](Vector2 o, Vector2 a, Vector2 b) { return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x); };
+    Vector2 hull[2 * ROCK_MAX_VERTICES];
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        while (k >= 2 && turn(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+        hull[k++] = points[i];
+    }
+    for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+        while (k >= lower && turn(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+        hull[k++] = points[i];
+    }
+    out.count = k - 1;                           // The last point repeats the first
+
+    float farthest = 0;
+    for (int i = 0; i < out.count; i++) farthest = max(farthest, sqrtf(hull[i].x * hull[i].x + hull[i].y * hull[i].y));
+    float scale = size / farthest;
+    for (int i = 0; i < out.count; i++) out.local[i] = {hull[i].x * scale, hull[i].y * scale};
+
+    out.inner = size;
+    for (int i = 0; i < out.count; i++) {
+        Vector2 a = out.local[i], b = out.local[(i + 1) % out.count];
+        float ex = b.x - a.x, ey = b.y - a.y;
+        out.inner = min(out.inner, (a.y * ex - a.x * ey) / sqrtf(ex * ex + ey * ey));
+    }
+    out.angle = next() * 2 * PI;
+    out.spin = (next() - 0.5f) * 0.08f;
+    out.drift = 0;
+    out.proxy = -1;
+}
+
+// World-space outline of a rock at time t (0..1) into the tick
+int RockOutline(const FallingRock& r, const RockShape& s, float t, Vector2* out) {
+    float angle = s.angle + s.spin * t;
+    float c = cosf(angle), sn = sinf(angle);
+    float x = r.x + s.drift * t, y = r.y + r.speed * t;
+    for (int i = 0; i < s.count; i++) {
+        out[i] = {x + s.local[i].x * c - s.local[i].y * sn, y + s.local[i].x * sn + s.local[i].y * c};
+    }
+    return s.count;
+}
+
+// Separating axis test for two convex polygons: they overlap unless some edge
+// normal of either one separates their projections. Touching counts as a miss.
+bool ConvexOverlap(const Vector2* a, int countA, const Vector2* b, int countB) {
+    auto project = [](const Vector2* p, int count, float nx, float ny, float& lo, float& hi) {
+        lo = hi = p[0].x * nx + p[0].y * ny;
+        for (int i = 1; i < count; i++) {
+            float d = p[i].x * nx + p[i].y * ny;
+            lo = min(lo, d);
+            hi = max(hi, d);
+        }
+    };
+    for (int pass = 0; pass < 2; pass++) {
+        const Vector2* p = pass ? b : a;
+        int count = pass ? countB : countA;
+        for (int i = 0; i < count; i++) {
+            Vector2 e0 = p[i], e1 = p[(i + 1) % count];
+            float nx = e0.y - e1.y, ny = e1.x - e0.x;
+            float loA, hiA, loB, hiB;
+            project(a, countA, nx, ny, loA, hiA);
+            project(b, countB, nx, ny, loB, hiB);
+            if (hiA <= loB || hiB <= loA) return false;
+        }
+    }
+    return true;
+}
+
+struct Aabb {
+    float minX, minY, maxX, maxY;
+
+    bool Overlaps(const Aabb& o) const { return minX < o.maxX && o.minX < maxX && minY < o.maxY && o.minY < maxY; }
+    bool Contains(const Aabb& o) const {
+        return minX <= o.minX && minY <= o.minY && o.maxX <= maxX && o.maxY <= maxY;
+    }
+    Aabb Union(const Aabb& o) const {
+        return {min(minX, o.minX), min(minY, o.minY), max(maxX, o.maxX), max(maxY, o.maxY)};
+    }
+    float Perimeter() const { return 2 * ((maxX - minX) + (maxY - minY)); }
+};
+
+// Dynamic bounding volume hierarchy. Nodes live in one vector and are
+// recycled through a free list, so a proxy (leaf index) stays valid until it
+// is removed. Insertion picks the sibling that grows the tree's total
+// perimeter least, and AVL-style rotations on the way back up keep the height
+// logarithmic however the leaves move.
+class AabbTree {
+private:
+    struct Node {
+        Aabb box;
+        int parent;             // Next free node while on the free list
+        int child1, child2;     // -1 for leaves
+        int height;             // 0 for leaves
+        int item;
+
+        bool IsLeaf() const { return child1 < 0; }
+    };
+
+    vector<Node> nodes;
+    int root = -1;
+    int freeList = -1;
+    int leafCount = 0;
+    int reinserts = 0;
+
+    int Allocate() {
+        int id = freeList;
+        if (id >= 0) {
+            freeList = nodes[id].parent;
+        } else {
+            id = (int)nodes.size();
+            nodes.push_back({});
+        }
+        nodes[id].parent = nodes[id].child1 = nodes[id].child2 = -1;
+        nodes[id].height = 0;
+        nodes[id].item = -1;
+        return id;
+    }
+
+    void Release(int id) {
+        nodes[id].parent = freeList;
+        freeList = id;
+    }
+
+    void InsertLeaf(int leaf) {
+        if (root < 0) {
+            root = leaf;
+            nodes[leaf].parent = -1;
+            return;
+        }
+
+        // Walk down while pushing the leaf further costs less than pairing it here
+        Aabb box = nodes[leaf].box;
+        int index = root;
+        while (!nodes[index].IsLeaf()) {
+            const Node& n = nodes[index];
+            float combined = n.box.Union(box).Perimeter();
+            float here = 2 * combined;
+            float inherited = 2 * (combined - n.box.Perimeter());
+            auto descend = [&](int child) {
+                const Node& c = nodes[child];
+                float cost = c.box.Union(box).Perimeter() + inherited;
+                return c.IsLeaf() ? cost : cost - c.box.Perimeter();
+            };
+            float cost1 = descend(n.child1), cost2 = descend(n.child2);
+            if (here < cost1 && here < cost2) break;
+            index = (cost1 < cost2) ? n.child1 : n.child2;
+        }
+
+        int sibling = index;
+        int oldParent = nodes[sibling].parent;
+        int parent = Allocate();
+        nodes[parent].parent = oldParent;
+        nodes[parent].child1 = sibling;
+        nodes[parent].child2 = leaf;
+        nodes[sibling].parent = parent;
+        nodes[leaf].parent = parent;
+        if (oldParent < 0) {
+            root = parent;
+        } else if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = parent;
+        } else {
+            nodes[oldParent].child2 = parent;
+        }
+        Refit(parent);
+    }
+
+    void RemoveLeaf(int leaf) {
+        if (leaf == root) {
+            root = -1;
+            return;
+        }
+        int parent = nodes[leaf].parent;
+        int grandparent = nodes[parent].parent;
+        int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+        nodes[sibling].parent = grandparent;
+        Release(parent);
+        if (grandparent < 0) {
+            root = sibling;
+            return;
+        }
+        if (nodes[grandparent].child1 == parent) {
+            nodes[grandparent].child1 = sibling;
+        } else {
+            nodes[grandparent].child2 = sibling;
+        }
+        Refit(grandparent);
+    }
+
+    // Recompute boxes and heights from index up to the root, rebalancing as it goes
+    void Refit(int index) {
+        while (index >= 0) {
+            index = Balance(index);
+            Node& n = nodes[index];
+            n.height = 1 + max(nodes[n.child1].height, nodes[n.child2].height);
+            n.box = nodes[n.child1].box.Union(nodes[n.child2].box);
+            index = n.parent;
+        }
+    }
+
+    // If one child's subtree is more than one level taller, rotate that child
+    // up into a's place. Returns the node now at a's position.
+    int Balance(int a) {
+        const Node& n = nodes[a];
+        if (n.IsLeaf() || n.height < 2) return a;
+        int diff = nodes[n.child2].height - nodes[n.child1].height;
+        if (diff > 1) return Rotate(a, n.child2);
+        if (diff < -1) return Rotate(a, n.child1);
+        return a;
+    }
+
+    int Rotate(int a, int up) {
+        Node& A = nodes[a];
+        Node& U = nodes[up];
+        // The taller grandchild stays under the promoted node, the other moves to a
+        int keep = (nodes[U.child1].height > nodes[U.child2].height) ? U.child1 : U.child2;
+        int move = (keep == U.child1) ? U.child2 : U.child1;
+
+        U.parent = A.parent;
+        if (U.parent < 0) {
+            root = up;
+        } else if (nodes[U.parent].child1 == a) {
+            nodes[U.parent].child1 = up;
+        } else {
+            nodes[U.parent].child2 = up;
+        }
+        U.child1 = a;
+        U.child2 = keep;
+        A.parent = up;
+        if (A.child1 == up) {
+            A.child1 = move;
+        } else {
+            A.child2 = move;
+        }
+        nodes[move].parent = a;
+
+        A.box = nodes[A.child1].box.Union(nodes[A.child2].box);
+        A.height = 1 + max(nodes[A.child1].height, nodes[A.child2].height);
+        U.box = A.box.Union(nodes[keep].box);
+        U.height = 1 + max(A.height, nodes[keep].height);
+        return up;
+    }
+
+    static Aabb Enlarge(const Aabb& box, Vector2 velocity) {
+        Aabb fat = {box.minX - AABB_TREE_MARGIN, box.minY - AABB_TREE_MARGIN,
+                    box.maxX + AABB_TREE_MARGIN, box.maxY + AABB_TREE_MARGIN};
+        float dx = velocity.x * AABB_TREE_PREDICT, dy = velocity.y * AABB_TREE_PREDICT;
+        if (dx < 0) fat.minX += dx; else fat.maxX += dx;
+        if (dy < 0) fat.minY += dy; else fat.maxY += dy;
+        return fat;
+    }
+
+public:
+    // Room for this many leaves (and their parents) before the node array grows
+    void Reserve(int leaves) { nodes.reserve(2 * leaves); }
+
+    void Clear() {
+        nodes.clear();
+        root = freeList = -1;
+        leafCount = reinserts = 0;
+    }
+
+    // Add an item and return its proxy
+    int Insert(const Aabb& box, int item, Vector2 velocity = {0, 0}) {
+        int leaf = Allocate();
+        nodes[leaf].box = Enlarge(box, velocity);
+        nodes[leaf].item = item;
+        InsertLeaf(leaf);
+        leafCount++;
+        return leaf;
+    }
+
+    void Remove(int proxy) {
+        RemoveLeaf(proxy);
+        Release(proxy);
+        leafCount--;
+    }
+
+    // Report a proxy's new box. Nothing changes while it stays inside the
+    // leaf's enlarged box; otherwise only this leaf is reinserted, with room
+    // for velocity (per tick) to carry on, and its ancestors are refit.
+    // Returns true if the tree changed.
+    bool Move(int proxy, const Aabb& box, Vector2 velocity) {
+        if (nodes[proxy].box.Contains(box)) return false;
+        RemoveLeaf(proxy);
+        nodes[proxy].box = Enlarge(box, velocity);
+        InsertLeaf(proxy);
+        reinserts++;
+        return true;
+    }
+
+    // Call visit(item) for every leaf whose box overlaps box, stopping early if
+    // it returns false. Returns the number of nodes visited.
+    template <typename Fn>
+    int Query(const Aabb& box, Fn visit) const {
+        int stack[64];                           // Height stays below 1.44 log2(leaves)
+        int top = 0, visited = 0;
+        if (root >= 0) stack[top++] = root;
+        while (top > 0) {
+            const Node& n = nodes[stack[--top]];
+            visited++;
+            if (!n.box.Overlaps(box)) continue;
+            if (n.IsLeaf()) {
+                if (!visit(n.item)) break;
+            } else {
+                stack[top++] = n.child1;
+                stack[top++] = n.child2;
+            }
+        }
+        return visited;
+    }
+
+    int Count() const { return leafCount; }
+    int Height() const { return (root >= 0) ? nodes[root].height : 0; }
+    int Reinserts() const { return reinserts; }
+};
+
+// Box around a rock over the coming tick, from its position now to where it lands
+inline Aabb RockSweepBounds(const FallingRock& r, const RockShape& s) {
+    return {r.x + min(s.drift, 0.0f) - r.size, r.y - r.size, r.x + max(s.drift, 0.0f) + r.size, r.y + r.speed + r.size};
+}
+
+inline Aabb ShipBounds(Vector2 ship) {
+    return {ship.x + SHIP_HULL[2].x, ship.y + SHIP_HULL[0].y, ship.x + SHIP_HULL[1].x, ship.y + SHIP_HULL[1].y};
+}
+
+// Whether a rock, starting from its position before it falls, touches the
+// ship moving from shipFrom to shipTo at any point this tick. The bounding
+// circles are swept first. If they meet, the outlines are tested from that
+// moment to the end of the tick at steps no longer than the smaller inradius,
+// so a rock cannot cross the hull between two samples; at most a corner can
+// graze it unnoticed.
+bool RockHitsShip(const FallingRock& r, const RockShape& s, Vector2 shipFrom, Vector2 shipTo) {
+    float sdx = shipTo.x - shipFrom.x, sdy = shipTo.y - shipFrom.y;
+    float dx = s.drift - sdx, dy = r.speed - sdy;
+    float t = SweptCircleTime(r.x - shipFrom.x, r.y - shipFrom.y, dx, dy, r.size + SHIP_BOUND_RADIUS);
+    if (t < 0) return false;
+
+    float travel = (1 - t) * sqrtf(dx * dx + dy * dy);
+    int steps = max(1, (int)ceilf(travel / min(s.inner, SHIP_INNER_RADIUS)));
+    Vector2 rock[ROCK_MAX_VERTICES], hull[3];
+    for (int k = 0; k <= steps; k++) {
+        float u = t + (1 - t) * k / steps;
+        RockOutline(r, s, u, rock);
+        for (int i = 0; i < 3; i++) hull[i] = {shipFrom.x + sdx * u + SHIP_HULL[i].x, shipFrom.y + sdy * u + SHIP_HULL[i].y};
+        if (ConvexOverlap(rock, s.count, hull, 3)) return true;
+    }
+    return false;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SPACE SURVIVOR WEAPONS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// With weapons on (F in the classic game) the ship fires while SPACE is held.
+// A shot rock breaks into two smaller fragments that drift apart, and pieces
+// too small to split scatter into debris. Rocks, fragments, shots and debris
+// all live in Pools, so a burst of hundreds of spawns never allocates.
+
+const int ROCK_POOL_SIZE = 96;                   // Respawning rocks, wave rocks and fragments
+const int PROJECTILE_POOL_SIZE = 48;
+const int DEBRIS_POOL_SIZE = 384;
+const int FIRE_INTERVAL = 6;                     // Ticks between shots
+const float PROJECTILE_SPEED = 14.0f;            // Pixels per tick, upwards
+const float FRAGMENT_SCALE = 0.6f;               // Fragment size relative to its parent
+const float FRAGMENT_MIN_SIZE = 9.0f;            // Smaller pieces turn into debris
+const int DEBRIS_PER_BREAK = 8;
+const int DEBRIS_TICKS = 36;
+
+struct Projectile {
+    float x, y;
+};
+
+struct Debris {
+    float x, y;
+    float vx, vy;           // Pixels per tick
+    float size;
+    int ticks;              // Left to live
+};
+
+// Whether a shot at `shot` hits a rock this tick: the path the shot covers
+// relative to the rock, as a segment, against the rock's starting outline
+bool ShotHitsRock(Vector2 shot, const FallingRock& r, const RockShape& s) {
+    Vector2 outline[ROCK_MAX_VERTICES];
+    int count = RockOutline(r, s, 0, outline);
+    Vector2 path[2] = {shot, {shot.x - s.drift, shot.y - PROJECTILE_SPEED - r.speed}};
+    return ConvexOverlap(outline, count, path, 2);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WAVE DIRECTOR
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Classic Space Survivor difficulty comes from a schedule instead of the score.
+// Each wave starts at a time in seconds and has a spawn budget (rocks per
+// window of seconds), a pattern, and speed and size ranges. Budgets accrue
+// with elapsed time and carry fractions between ticks, so the spawn rate is
+// the same at any tick or frame rate. Speed and size ranges blend linearly
+// toward the next wave. The schedule is read from WAVE_SCHEDULE_FILE when it
+// exists, so difficulty can be tuned without a rebuild; otherwise the built-in
+// one below is used. Wave rocks fall once, like fragments.
+
+const char* WAVE_SCHEDULE_FILE = "space_waves.txt";
+const int WAVE_MAX_WAVES = 64;
+const int WAVE_MAX_SPAWNS = 16;                  // Per tick
+const int WAVE_WALL_LANES = 8;
+
+const char* DEFAULT_WAVES =
+    "# start  rocks  window  pattern  speed  size\n"
+    "0        2      10      rain     3-6    15-34\n"
+    "30       4      10      rain     4-7    15-34\n"
+    "60       3      6       sweep    4-8    15-34\n"
+    "90       5      8       aimed    5-9    15-38\n"
+    "120      14     10      wall     5-8    15-30\n"
+    "150      10     10      rain     6-10   15-40\n";
+
+enum WavePattern {
+    WAVE_RAIN,              // Anywhere across the top
+    WAVE_SWEEP,             // Lane by lane, left to right and back
+    WAVE_AIMED,             // Above the ship
+    WAVE_WALL,              // A row across all lanes but one
+    WAVE_PATTERN_COUNT
+};
+
+const char* WAVE_PATTERN_NAMES[WAVE_PATTERN_COUNT] = {"rain", "sweep", "aimed", "wall"};
+const int WAVE_PATTERN_GROUP[WAVE_PATTERN_COUNT] = {1, 1, 1, WAVE_WALL_LANES - 1};   // Rocks per spawn
+
+struct WaveDesc {
+    float start;            // Seconds into the run
+    float rocks;            // Spawn budget per window
+    float window;           // Seconds
+    WavePattern pattern;
+    float speedMin, speedMax;
+    float sizeMin, sizeMax;
+};
+
+class WaveSchedule {
+private:
+    WaveDesc waves[WAVE_MAX_WAVES];
+    int count = 0;
+
+public:
+    WaveSchedule() { Parse(DEFAULT_WAVES, "built-in schedule"); }
+
+    // Replaces the schedule only if all of text is valid
+    bool Parse(const char* text, const char* source) {
+        WaveDesc parsed[WAVE_MAX_WAVES];
+        int parsedCount = 0, lineNumber = 0;
+        for (const char* line = text; *line; ) {
+            const char* next = strchr(line, '\n');
+            string current(line, next ? next - line : strlen(line));
+            line = next ? next + 1 : line + current.size();
+            lineNumber++;
+
+            size_t first = current.find_first_not_of(" \t\r");
+            if (first == string::npos || current[first] == '#') continue;
+            WaveDesc w = {};
+            char pattern[16] = {};
+            bool ok = sscanf(current.c_str(), "%f %f %f %15s %f-%f %f-%f", &w.start, &w.rocks, &w.window, pattern,
+                             &w.speedMin, &w.speedMax, &w.sizeMin, &w.sizeMax) == 8;
+            int p = 0;
+            while (p < WAVE_PATTERN_COUNT && strcmp(pattern, WAVE_PATTERN_NAMES[p]) != 0) p++;
+            w.pattern = (WavePattern)p;
+            ok = ok && p < WAVE_PATTERN_COUNT && w.window > 0 && w.rocks >= 0 && w.speedMin > 0 &&
+                 w.speedMin <= w.speedMax && w.sizeMin > 0 && w.sizeMin <= w.sizeMax && parsedCount < WAVE_MAX_WAVES &&
+                 (parsedCount == 0 ? w.start >= 0 : w.start > parsed[parsedCount - 1].start);
+            if (!ok) {
+                TraceLog(LOG_WARNING, "WAVES: %s line %d is not a valid wave, schedule ignored", source, lineNumber);
+                return false;
+            }
+            parsed[parsedCount++] = w;
+        }
+        if (parsedCount == 0) {
+            TraceLog(LOG_WARNING, "WAVES: %s has no waves, schedule ignored", source);
+            return false;
+        }
+        copy(parsed, parsed + parsedCount, waves);
+        count = parsedCount;
+        return true;
+    }
+
+    // Designer overrides; keeps the current schedule if the file is missing or bad
+    bool Load(const char* path = WAVE_SCHEDULE_FILE) {
+        ifstream file(path);
+        if (!file.is_open()) return false;
+        string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        if (!Parse(text.c_str(), path)) return false;
+        TraceLog(LOG_INFO, "WAVES: Loaded %d waves from %s", count, path);
+        return true;
+    }
+
+    int Count() const { return count; }
+    const WaveDesc& operator[](int i) const { return waves[i]; }
+};
+
+WaveSchedule waveSchedule;        // Read-only once the game is running
+
+struct WaveSpawn {
+    float x;
+    float speed;
+    float size;
+};
+
+// Per-run state; plain values, so it copies with the World snapshots
+class WaveDirector {
+private:
+    float time = 0;
+    int wave = 0;
+    float carry = 0;        // Budget accrued but not spawned yet
+    int sweepStep = 0;
+
+    // Position of the current time between this wave and the next, 0..1
+    float Blend() const {
+        if (wave + 1 >= waveSchedule.Count()) return 0;
+        const WaveDesc& w = waveSchedule[wave];
+        return min(max((time - w.start) / (waveSchedule[wave + 1].start - w.start), 0.0f), 1.0f);
+    }
+
+    float Range(float WaveDesc::*low, float WaveDesc::*high) const {
+        const WaveDesc& w = waveSchedule[wave];
+        const WaveDesc& n = waveSchedule[min(wave + 1, waveSchedule.Count() - 1)];
+        float f = Blend();
+        float lo = w.*low + (n.*low - w.*low) * f;
+        float hi = w.*high + (n.*high - w.*high) * f;
+        return lo + (hi - lo) * (rand() % 1001) / 1000.0f;
+    }
+
+public:
+    void Reset() {
+        time = carry = 0;
+        wave = sweepStep = 0;
+    }
+
+    float RollSpeed() const { return Range(&WaveDesc::speedMin, &WaveDesc::speedMax); }
+    float RollSize() const { return Range(&WaveDesc::sizeMin, &WaveDesc::sizeMax); }
+    int WaveNumber() const { return wave + 1; }
+
+    // Advances by dt seconds and writes this tick's spawns (at most maxOut).
+    // Constant work per tick: the wave index only ever moves forward.
+    int Update(float dt, float shipX, WaveSpawn* out, int maxOut) {
+        time += dt;
+        while (wave + 1 < waveSchedule.Count() && time >= waveSchedule[wave + 1].start) wave++;
+        const WaveDesc& w = waveSchedule[wave];
+        if (time < w.start) return 0;
+        carry += w.rocks / w.window * dt;
+
+        int group = WAVE_PATTERN_GROUP[w.pattern];
+        int n = 0;
+        while (carry >= group && n + group <= maxOut) {
+            carry -= group;
+            switch (w.pattern) {
+                case WAVE_RAIN:
+                    out[n++] = {(float)(rand() % SCREEN_WIDTH), RollSpeed(), RollSize()};
+                    break;
+                case WAVE_SWEEP: {
+                    int step = sweepStep++ % (2 * WAVE_WALL_LANES - 2);
+                    int lane = step < WAVE_WALL_LANES ? step : 2 * WAVE_WALL_LANES - 2 - step;
+                    out[n++] = {60 + lane * (SCREEN_WIDTH - 120.0f) / (WAVE_WALL_LANES - 1), RollSpeed(), RollSize()};
+                    break;
+                }
+                case WAVE_AIMED: {
+                    float x = min(max(shipX + rand() % 121 - 60, 20.0f), SCREEN_WIDTH - 20.0f);
+                    out[n++] = {x, RollSpeed(), RollSize()};
+                    break;
+                }
+                default: {
+                    // One speed for the whole row so it stays a wall
+                    int gap = rand() % WAVE_WALL_LANES;
+                    float speed = RollSpeed();
+                    for (int lane = 0; lane < WAVE_WALL_LANES; lane++) {
+                        if (lane == gap) continue;
+                        float x = (lane + 0.5f) * SCREEN_WIDTH / WAVE_WALL_LANES;
+                        out[n++] = {x, speed, RollSize()};
+                    }
+                    break;
+                }
+            }
+        }
+        return n;
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ASTEROID SWARM
+// ═══════════════════════════════════════════════════════════════════════════
+
+// The third Space Survivor mode: the classic falling rocks, but hundreds of
+// thousands of them in a column far taller than the screen, all simulated
+// every tick. The rocks are split into a fixed number of partitions that start
+// on cache-line boundaries, so no two jobs ever write the same line, and each
+// partition integrates, respawns and tests its rocks against the ship into its
+// own result block. The results are then reduced in partition order. Respawns
+// draw from a hash of the rock index and tick instead of rand(), so the state
+// after every tick is bit-identical whatever the thread count.
+//
+// The swarm is far too big to copy with every World snapshot, so it lives
+// outside the game like chunkStreamer and only the simulation thread touches
+// it; the rocks in view are copied out for drawing each tick.
+
+const int SWARM_PARTITIONS = 256;
+const int SWARM_LINE_FLOATS = 64 / sizeof(float);
+const int SWARM_PLAY_COUNT = 1 << 16;
+const int SWARM_BENCH_COUNT = 1 << 20;
+const int SWARM_ON_SCREEN = 30;                  // Rocks in view on average
+const int SWARM_MAX_VISIBLE = 2048;
+const float SWARM_MAX_SIZE = 20.0f;
+const float SWARM_SHIP_RADIUS = 18.0f;
+
+// One cache line of one field
+struct alignas(64) SwarmLine {
+    float v[SWARM_LINE_FLOATS];
+};
+
+// Everything one tick changed, reduced over the partitions
+struct SwarmStep {
+    int passed;             // Rocks that left the bottom of the screen
+    int hitRock;            // Rock that hit the ship first, or -1
+    float hitTime;          // Its time of impact within the tick
+};
+
+class AsteroidSwarm {
+private:
+    struct alignas(64) Partition {
+        int begin, end;                 // Rock range; begin is on a cache line
+        int passed;
+        int hitRock;
+        float hitTime;
+        vector<FallingRock> visible;    // Keeps its capacity from tick to tick
+    };
+
+    // Fields in separate arrays: the per-tick pass only streams y and speed,
+    // x and size are read for the few rocks near the screen
+    vector<SwarmLine> xLines, yLines, speedLines, sizeLines;
+    float* xs = nullptr;
+    float* ys = nullptr;
+    float* speeds = nullptr;
+    float* sizes = nullptr;
+    int count = 0;
+    float depth = 0;                    // Height of the column above the screen
+    uint32_t seed = 0;
+    uint32_t tick = 0;
+    Partition partitions[SWARM_PARTITIONS];
+
+    // New x, speed and size for a rock; y is left to the caller
+    void Roll(int i) {
+        uint32_t h = FieldHash(seed ^ FieldHash((uint32_t)i * 2654435761U ^ tick));
+        xs[i] = (float)(h % SCREEN_WIDTH);
+        speeds[i] = 3 + (float)((h >> 12) % 5);
+        sizes[i] = 8 + (float)((h >> 20) % 12);
+    }
+
+    // Rock i has just fallen from oldY. The ship test uses where it started
+    // the tick, as in the classic game and FirstRockImpact().
+    void Settle(Partition& part, int i, float oldY, Vector2 shipFrom, Vector2 shipTo) {
+        float t = SweptCircleTime(xs[i] - shipFrom.x, oldY - shipFrom.y, shipFrom.x - shipTo.x,
+                                  speeds[i] - (shipTo.y - shipFrom.y), sizes[i] + SWARM_SHIP_RADIUS);
+        if (t >= 0 && (part.hitRock < 0 || t < part.hitTime)) {
+            part.hitRock = i;
+            part.hitTime = t;
+        }
+        if (ys[i] > SCREEN_HEIGHT + 50) {
+            Roll(i);
+            ys[i] -= depth + SCREEN_HEIGHT + 100;
+            part.passed++;
+        }
+        if (ys[i] > -sizes[i] && (int)part.visible.size() < SWARM_MAX_VISIBLE) {
+            part.visible.push_back({xs[i], ys[i], speeds[i], sizes[i]});
+        }
+    }
+
+    // Only rocks that reach y > -SWARM_MAX_SIZE can be seen, hit the ship or
+    // respawn; the SSE2 pass moves four rocks at a time and hands just those
+    // lanes to Settle()
+    void StepPartition(Partition& part, Vector2 shipFrom, Vector2 shipTo) {
+        part.passed = 0;
+        part.hitRock = -1;
+        part.hitTime = 2;
+        part.visible.clear();
+
+        int i = part.begin;
+#if defined(__SSE2__)
+        __m128 edge = _mm_set1_ps(-SWARM_MAX_SIZE);
+        for (; i + 4 <= part.end; i += 4) {
+            __m128 y = _mm_load_ps(ys + i);
+            __m128 fallen = _mm_add_ps(y, _mm_load_ps(speeds + i));
+            _mm_store_ps(ys + i, fallen);
+            int mask = _mm_movemask_ps(_mm_cmpgt_ps(fallen, edge));
+            if (mask == 0) continue;
+            float old[4];
+            _mm_storeu_ps(old, y);
+            for (int lane = 0; lane < 4; lane++) {
+                if (mask & (1 << lane)) Settle(part, i + lane, old[lane], shipFrom, shipTo);
+            }
+        }
+#endif
+        for (; i < part.end; i++) {
+            float old = ys[i];
+            ys[i] = old + speeds[i];
+            if (ys[i] > -SWARM_MAX_SIZE) Settle(part, i, old, shipFrom, shipTo);
+        }
+    }
+
+public:
+    // count is rounded up to whole cache lines
+    void Init(int rockCount, uint32_t runSeed) {
+        int lineCount = max(1, (rockCount + SWARM_LINE_FLOATS - 1) / SWARM_LINE_FLOATS);
+        xLines.resize(lineCount);
+        yLines.resize(lineCount);
+        speedLines.resize(lineCount);
+        sizeLines.resize(lineCount);
+        xs = xLines[0].v;
+        ys = yLines[0].v;
+        speeds = speedLines[0].v;
+        sizes = sizeLines[0].v;
+        count = lineCount * SWARM_LINE_FLOATS;
+        depth = (float)count / SWARM_ON_SCREEN * SCREEN_HEIGHT;
+        seed = runSeed;
+        tick = 0;
+
+        // The screen starts empty; everything waits in the column above it
+        for (int i = 0; i < count; i++) {
+            Roll(i);
+            ys[i] = -50 - (float)(FieldHash(seed + (uint32_t)i) % (uint32_t)depth);
+        }
+        for (int p = 0; p < SWARM_PARTITIONS; p++) {
+            partitions[p].begin = (int)((long long)lineCount * p / SWARM_PARTITIONS) * SWARM_LINE_FLOATS;
+            partitions[p].end = (int)((long long)lineCount * (p + 1) / SWARM_PARTITIONS) * SWARM_LINE_FLOATS;
+        }
+    }
+
+    // One fixed tick. The rocks in view afterwards are written to visible.
+    SwarmStep Step(Vector2 shipFrom, Vector2 shipTo, vector<FallingRock>& visible) {
+        tick++;
+        jobs.ParallelFor(SWARM_PARTITIONS, 1, [&](int begin, int end) {
+            for (int p = begin; p < end; p++) StepPartition(partitions[p], shipFrom, shipTo);
+        });
+
+        // Partition order, so ties go to the lowest rock index
+        SwarmStep result = {0, -1, -1};
+        visible.clear();
+        for (const Partition& part : partitions) {
+            result.passed += part.passed;
+            if (part.hitRock >= 0 && (result.hitRock < 0 || part.hitTime < result.hitTime)) {
+                result.hitRock = part.hitRock;
+                result.hitTime = part.hitTime;
+            }
+            int room = SWARM_MAX_VISIBLE - (int)visible.size();
+            visible.insert(visible.end(), part.visible.begin(), part.visible.begin() + min(room, (int)part.visible.size()));
+        }
+        return result;
+    }
+
+    int Count() const { return count; }
+
+    // FNV-1a over every field of every rock, to compare runs
+    uint64_t Checksum() const {
+        uint64_t h = 1469598103934665603ULL;
+        const float* fields[4] = {xs, ys, speeds, sizes};
+        for (const float* field : fields) {
+            const unsigned char* bytes = (const unsigned char*)field;
+            for (size_t i = 0; i < (size_t)count * sizeof(float); i++) h = (h ^ bytes[i]) * 1099511628211ULL;
+        }
+        return h;
+    }
+};
+
+AsteroidSwarm asteroidSwarm;      // Simulation thread only
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SPACE SURVIVOR GAME CLASS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// TAB cycles through these
+enum SpaceMode {
+    SPACE_CLASSIC,
+    SPACE_OPEN_FIELD,
+    SPACE_SWARM
+};
+
+class SpaceSurvivorGame {
+private:
+    struct Asteroid : FallingRock {
+        RockShape shape;
+        int splits;             // 0 for rocks that respawn at the top; wave rocks start at 1, one more per split
+    };
+
+    float playerX;
+    float playerY;
+    int score;
+    bool gameOver;
+    Pool<Asteroid, ROCK_POOL_SIZE> asteroids;   // Broadphase items are handles into this
+    AabbTree broadphase;
+    WaveDirector director;
+    bool weapons = false;       // F toggles shooting in the classic game
+    int fireCooldown;
+    Pool<Projectile, PROJECTILE_POOL_SIZE> projectiles;
+    Pool<Debris, DEBRIS_POOL_SIZE> debris;
+    float animTime;
+    StarScroll stars;
+    SpaceMode mode = SPACE_CLASSIC;
+    ParticleEmitter exhaust;
+    OpenField field;
+    vector<FallingRock> swarmVisible;   // Rocks of asteroidSwarm in view after the last tick
+    int swarmCount = 0;                 // asteroidSwarm.Count(), for the HUD on the render thread
+    TweenPool<2, 1> tweens;     // Channel 0: game-over fade
+
+    void EndRun() {
+        if (gameOver) return;
+        gameOver = true;
+        tweens.To(0, 1, 0.4f, EASE_OUT_CUBIC);
+        Vector2 ship = (mode == SPACE_OPEN_FIELD) ? field.ToScreen(field.shipX, field.shipY) : (Vector2){playerX, playerY};
+        EmitEffect(EFFECT_EXPLOSION, ship.x, ship.y);
+        EmitResultEffect(false);
+    }
+
+    // Trail behind the engine flame, drawn with the rest of the effects
+    void EmitExhaust(float shipX, float shipY) {
+        if (!gameOver) exhaust.Emit(EFFECT_EXHAUST, shipX, shipY + 22, FrameDelta());
+    }
+
+    void AddAsteroid(const FallingRock& body, int splits, float drift) {
+        PoolHandle handle = asteroids.Acquire();
+        Asteroid* a = asteroids.Get(handle);
+        if (!a) return;
+        static_cast<FallingRock&>(*a) = body;
+        a->splits = splits;
+        GenerateRockShape(body.size, (uint32_t)rand(), a->shape);
+        a->shape.drift = drift;
+        a->shape.proxy = broadphase.Insert(RockSweepBounds(*a, a->shape), handle, {drift, body.speed});
+    }
+
+    void RemoveAsteroid(PoolHandle handle) {
+        const Asteroid* a = asteroids.Get(handle);
+        if (!a) return;
+        broadphase.Remove(a->shape.proxy);
+        asteroids.Release(handle);
+    }
+
+    // Back to the top with a new size and outline
+    void Respawn(Asteroid& a) {
+        a.y = -50;
+        a.x = rand() % SCREEN_WIDTH;
+        a.speed = director.RollSpeed();
+        a.size = director.RollSize();
+        int proxy = a.shape.proxy;
+        GenerateRockShape(a.size, (uint32_t)rand(), a.shape);
+        a.shape.proxy = proxy;
+        broadphase.Move(proxy, RockSweepBounds(a, a.shape), {0, a.speed});
+    }
+
+    // Broadphase candidates near the ship's path, confirmed against their outlines
+    bool ShipHit(Vector2 shipFrom, Vector2 shipTo) {
+        bool hit = false;
+        broadphase.Query(ShipBounds(shipFrom).Union(ShipBounds(shipTo)), [&](PoolHandle handle) {
+            const Asteroid* a = asteroids.Get(handle);
+            hit = a && RockHitsShip(*a, a->shape, shipFrom, shipTo);
+            return !hit;
+        });
+        return hit;
+    }
+
+    void SpawnDebris(float x, float y, float size) {
+        for (int i = 0; i < DEBRIS_PER_BREAK; i++) {
+            Debris* d = debris.Get(debris.Acquire());
+            if (!d) return;
+            float angle = (rand() % 628) / 100.0f;
+            float speed = 1 + (rand() % 30) / 10.0f;
+            *d = {x, y, cosf(angle) * speed, sinf(angle) * speed, 2 + size / 10 + rand() % 3, DEBRIS_TICKS - rand() % 12};
+        }
+    }
+
+    // Classic rocks respawn at the top; fragments split in two until they are
+    // too small, then break up
+    void ShootAsteroid(PoolHandle handle) {
+        Asteroid& a = *asteroids.Get(handle);
+        SpawnDebris(a.x, a.y, a.size);
+        EmitEffect(EFFECT_SPARKS, a.x, a.y, a.size / 25);
+        float childSize = a.size * FRAGMENT_SCALE;
+        if (childSize >= FRAGMENT_MIN_SIZE) {
+            for (int side = -1; side <= 1; side += 2) {
+                float drift = a.shape.drift + side * (1 + (rand() % 10) / 10.0f);
+                AddAsteroid({a.x + side * childSize / 2, a.y, a.speed, childSize}, a.splits + 1, drift);
+            }
+            score += 20;
+        } else {
+            score += 30;
+        }
+        if (a.splits == 0) {
+            Respawn(a);
+        } else {
+            RemoveAsteroid(handle);
+        }
+    }
+
+    void UpdateProjectiles() {
+        projectiles.ForEach([this](PoolHandle shot, Projectile& p) {
+            PoolHandle target = POOL_NO_HANDLE;
+            broadphase.Query({p.x - 1, p.y - PROJECTILE_SPEED, p.x + 1, p.y}, [&](PoolHandle handle) {
+                const Asteroid* a = asteroids.Get(handle);
+                if (a && ShotHitsRock({p.x, p.y}, *a, a->shape)) target = handle;
+                return target == POOL_NO_HANDLE;
+            });
+            if (target != POOL_NO_HANDLE) {
+                ShootAsteroid(target);
+                projectiles.Release(shot);
+                return;
+            }
+            p.y -= PROJECTILE_SPEED;
+            if (p.y < -20) projectiles.Release(shot);
+        });
+    }
+
+public:
+    void Init() {
+        if (mode == SPACE_OPEN_FIELD) field.Init((uint32_t)rand());
+        if (mode == SPACE_SWARM) asteroidSwarm.Init(SWARM_PLAY_COUNT, (uint32_t)rand());
+        swarmCount = (mode == SPACE_SWARM) ? asteroidSwarm.Count() : 0;
+        swarmVisible.clear();
+        tweens.Clear();
+        playerX = SCREEN_WIDTH / 2;
+        playerY = SCREEN_HEIGHT - 80;
+        score = 0;
+        gameOver = false;
+        animTime = 0;
+        asteroids.Clear();
+        director.Reset();
+        broadphase.Clear();
+        broadphase.Reserve(ROCK_POOL_SIZE);
+        projectiles.Clear();
+        debris.Clear();
+        fireCooldown = 0;
+
+        // Create initial asteroids; the other modes bring their own
+        for (int i = 0; mode == SPACE_CLASSIC && i < 8; i++) {
+            FallingRock a;
+            a.x = rand() % SCREEN_WIDTH;
+            a.y = -(rand() % 300);
+            a.speed = 3 + (rand() % 4);
+            a.size = 15 + (rand() % 20);
+            AddAsteroid(a, 0, 0);
+        }
+
+        stars.Reset();
+    }
+
+    void StartOpenField() {
+        mode = SPACE_OPEN_FIELD;
+        Init();
+    }
+
+    void StartSwarm() {
+        mode = SPACE_SWARM;
+        Init();
+    }
+
+    void StartWeapons() {
+        mode = SPACE_CLASSIC;
+        weapons = true;
+        Init();
+    }
+
+    const Pool<Asteroid, ROCK_POOL_SIZE>& Asteroids() const { return asteroids; }
+    const Pool<Projectile, PROJECTILE_POOL_SIZE>& Projectiles() const { return projectiles; }
+    const Pool<Debris, DEBRIS_POOL_SIZE>& DebrisPool() const { return debris; }
+
+    bool Update() {
+        if (gameInput.KeyPressed(KEY_ESCAPE) || gameInput.KeyPressed(KEY_M)) return true;
+        if (gameInput.KeyPressed(KEY_TAB)) {
+            mode = (SpaceMode)((mode + 1) % 3);
+            Init();
+        }
+        if (gameInput.KeyPressed(KEY_F) && mode == SPACE_CLASSIC) weapons = !weapons;
+
+        animTime += FrameDelta();
+        tweens.Update(FrameDelta(), this);
+        if (mode != SPACE_OPEN_FIELD) stars.Advance(FrameDelta());
+
+        if (gameOver) {
+            if (gameInput.KeyPressed(KEY_SPACE)) Init();
+            return false;
+        }
+
+        if (mode == SPACE_OPEN_FIELD) {
+            Vector2 cameraFrom = field.camera.target;
+            if (field.Update(FrameDelta())) EndRun();
+            stars.Pan(field.camera.target.x - cameraFrom.x, field.camera.target.y - cameraFrom.y);
+            Vector2 ship = field.ToScreen(field.shipX, field.shipY);
+            EmitExhaust(ship.x, ship.y);
+            score = field.Score();
+            return false;
+        }
+
+        // Player movement
+        Vector2 shipFrom = {playerX, playerY};
+        float speed = 8.0f;
+        if (gameInput.KeyDown(KEY_LEFT) || gameInput.KeyDown(KEY_A)) playerX -= speed;
+        if (gameInput.KeyDown(KEY_RIGHT) || gameInput.KeyDown(KEY_D)) playerX += speed;
+
+        if (playerX < 30) playerX = 30;
+        if (playerX > SCREEN_WIDTH - 30) playerX = SCREEN_WIDTH - 30;
+        EmitExhaust(playerX, playerY);
+
+        if (mode == SPACE_SWARM) {
+            SwarmStep step = asteroidSwarm.Step(shipFrom, {playerX, playerY}, swarmVisible);
+            swarmCount = asteroidSwarm.Count();
+            score += step.passed * 10;
+            if (step.hitRock >= 0) EndRun();
+            return false;
+        }
+
+        // Sweep ship and asteroids over the whole tick so fast rocks cannot
+        // skip past the ship between frames
+        if (ShipHit(shipFrom, {playerX, playerY})) EndRun();
+
+        // Fire and move shots against the rocks' positions before they fall
+        if (weapons) {
+            if (fireCooldown > 0) fireCooldown--;
+            if (fireCooldown == 0 && gameInput.KeyDown(KEY_SPACE)) {
+                if (Projectile* p = projectiles.Get(projectiles.Acquire())) *p = {playerX, playerY + SHIP_HULL[0].y};
+                fireCooldown = FIRE_INTERVAL;
+            }
+        }
+        UpdateProjectiles();
+
+        // Update asteroids
+        asteroids.ForEach([this](PoolHandle handle, Asteroid& a) {
+            a.y += a.speed;
+            a.x += a.shape.drift;
+            a.shape.angle = fmodf(a.shape.angle + a.shape.spin, 2 * PI);
+
+            // Respawn asteroid if off screen; wave rocks and fragments just go
+            if (a.y > SCREEN_HEIGHT + 50 || a.x < -50 || a.x > SCREEN_WIDTH + 50) {
+                if (a.splits > 0) {
+                    if (a.y > SCREEN_HEIGHT + 50) score += 10;
+                    RemoveAsteroid(handle);
+                    return;
+                }
+                Respawn(a);
+                score += 10;
+            }
+            broadphase.Move(a.shape.proxy, RockSweepBounds(a, a.shape), {a.shape.drift, a.speed});
+        });
+
+        debris.ForEach([this](PoolHandle handle, Debris& d) {
+            d.x += d.vx;
+            d.y += d.vy;
+            if (--d.ticks <= 0) debris.Release(handle);
+        });
+
+        // New rocks come from the wave schedule
+        WaveSpawn spawns[WAVE_MAX_SPAWNS];
+        int spawnCount = director.Update(FrameDelta(), playerX, spawns, WAVE_MAX_SPAWNS);
+        for (int i = 0; i < spawnCount; i++) AddAsteroid({spawns[i].x, -50, spawns[i].speed, spawns[i].size}, 1, 0);
+
+        return false;
+    }
+
+    void Draw() {
+        Gfx::Clear({5, 5, 20, 255});
+
+        // Draw parallax star layers
+        starfield.Draw(stars.offsets, (mode == SPACE_OPEN_FIELD) ? stars.offsetsX : nullptr);
+
+        DrawList& list = drawQueue.Begin();
+
+        // Title and score
+        list.layer = LAYER_HUD;
+        list.TextCentered("SPACE SURVIVOR", 20, 36, Colors::ACCENT);
+
+        char scoreText[32];
+        sprintf(scoreText, "SCORE: %d", score);
+        list.TextCentered(scoreText, 65, 28, Colors::TEXT_LIGHT);
+
+        // Draw asteroids, on several threads once the field is large
+        list.layer = LAYER_WORLD;
+        float shipX = playerX, shipY = playerY;
+        if (mode == SPACE_OPEN_FIELD) {
+            field.Record();
+            Vector2 ship = field.ToScreen(field.shipX, field.shipY);
+            shipX = ship.x;
+            shipY = ship.y;
+
+            char fieldText[96];
+            snprintf(fieldText, sizeof(fieldText), "Open field  chunks %d resident / %d active  rocks drawn %d",
+                     field.ResidentChunks(), field.ActiveChunks(), field.DrawnAsteroids());
+            list.layer = LAYER_HUD;
+            list.Text(fieldText, 20, 100, 16, Colors::TEXT_DIM);
+            list.layer = LAYER_WORLD;
+        } else if (mode == SPACE_SWARM) {
+            const vector<FallingRock>& rocks = swarmVisible;
+            drawQueue.ParallelRecord((int)rocks.size(), 512, [&rocks](DrawList& out, int begin, int end) {
+                for (int i = begin; i < end; i++) {
+                    out.Sprite(SPRITE_ASTEROID, rocks[i].x, rocks[i].y, rocks[i].size / ASTEROID_SPRITE_RADIUS);
+                }
+            });
+
+            char swarmText[96];
+            snprintf(swarmText, sizeof(swarmText), "Swarm  %d asteroids  %d in view  %d threads",
+                     swarmCount, (int)swarmVisible.size(), jobs.Threads());
+            list.layer = LAYER_HUD;
+            list.Text(swarmText, 20, 100, 16, Colors::TEXT_DIM);
+            list.layer = LAYER_WORLD;
+        } else {
+            // The outline drawn is the one the collision test uses
+            const Pool<Asteroid, ROCK_POOL_SIZE>& rocks = asteroids;
+            drawQueue.ParallelRecord(ROCK_POOL_SIZE, 512, [&rocks](DrawList& out, int begin, int end) {
+                Vector2 points[ROCK_MAX_VERTICES];
+                for (int slot = begin; slot < end; slot++) {
+                    const Asteroid* rock = rocks.AtSlot(slot);
+                    if (!rock) continue;
+                    const Asteroid& a = *rock;
+                    int count = RockOutline(a, a.shape, 0, points);
+                    out.Polygon(points, count, (Color){139, 69, 19, 255});
+
+                    float c = cosf(a.shape.angle), s = sinf(a.shape.angle), d = -a.size / 5;
+                    out.Circle(a.x + d * (c - s), a.y + d * (s + c), a.size / 5, (Color){100, 50, 10, 255});
+                    for (int k = 0; k < count; k++) {
+                        out.Line(points[k], points[(k + 1) % count], 2, (Color){80, 40, 10, 255});
+                    }
+                }
+            });
+
+            list.layer = LAYER_ACTORS;
+            debris.ForEach([&list](PoolHandle, const Debris& d) {
+                list.Rect(d.x - d.size / 2, d.y - d.size / 2, d.size, d.size,
+                          Faded((Color){160, 90, 40, 255}, (float)d.ticks / DEBRIS_TICKS));
+            });
+            projectiles.ForEach([&list](PoolHandle, const Projectile& p) {
+                list.Rect(p.x - 1.5f, p.y - 12, 3, 12, Colors::ACCENT);
+            });
+
+            if (weapons) {
+                char poolText[96];
+                snprintf(poolText, sizeof(poolText), "Weapons  shots %d/%d  rocks %d/%d  debris %d/%d",
+                         projectiles.Count(), PROJECTILE_POOL_SIZE, asteroids.Count(), ROCK_POOL_SIZE,
+                         debris.Count(), DEBRIS_POOL_SIZE);
+                list.layer = LAYER_HUD;
+                list.Text(poolText, 20, 100, 16, Colors::TEXT_DIM);
+            }
+            char waveText[32];
+            snprintf(waveText, sizeof(waveText), "WAVE %d", director.WaveNumber());
+            list.layer = LAYER_HUD;
+            list.Text(waveText, SCREEN_WIDTH - 100, 100, 16, Colors::TEXT_DIM);
+            list.layer = LAYER_WORLD;
+        }
+
+        // Draw player ship
+        if (!gameOver) {
+            list.layer = LAYER_ACTORS;
+
+            // Ship body (triangle from shipY - 25 to shipY + 20)
+            list.Sprite(SPRITE_SHIP, shipX, shipY - 2.5f);
+
+            // Engine flame; Update() emits the exhaust trail behind it
+            float flameSize = 10 + sin(animTime * 20) * 5;
+            list.Triangle({shipX, shipY + 20},
+                          {shipX + 8, shipY + 20 + flameSize},
+                          {shipX - 8, shipY + 20 + flameSize}, ORANGE);
+        }
+
+        // Game over screen
+        list.layer = LAYER_OVERLAY;
+        if (gameOver) {
+            float fade = tweens.Value(0);
+            float rise = (1 - fade) * 30;
+            list.Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, (unsigned char)(180 * fade)});
+            list.TextCentered("GAME OVER", SCREEN_HEIGHT/2 - 60 + rise, 60, Faded(Colors::DANGER, fade));
+
+            sprintf(scoreText, "Final Score: %d", score);
+            list.TextCentered(scoreText, SCREEN_HEIGHT/2 + 10 + rise, 30, Faded(Colors::ACCENT, fade));
+            list.TextCentered("Press SPACE to play again", SCREEN_HEIGHT/2 + 60 + rise, 20, Faded(Colors::TEXT_DIM, fade));
+        }
+
+        // Controls hint
+        list.Text(mode == SPACE_OPEN_FIELD ? "Controls: WASD or Arrow Keys | TAB: swarm | Press M to return to menu"
+                  : mode == SPACE_SWARM ? "Controls: A/D or Arrow Keys | TAB: classic mode | Press M to return to menu"
+                  : weapons ? "Controls: A/D or Arrow Keys | SPACE: fire | F: weapons off | TAB: open field | M: menu"
+                            : "Controls: A/D or Arrow Keys | F: weapons | TAB: open field | Press M to return to menu",
+                  20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+
+        drawQueue.Submit();
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// VERSUS SIMULATION
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Head-to-head Space Survivor for two cabinets: both ships dodge the same
+// rocks and the last one flying takes the round. Everything the simulation
+// reads is inside VersusState, a plain struct with its own random generator,
+// so saving or restoring a tick is one copy, and two machines that run the same
+// build on the same inputs reach the same bits. The step is fixed (one 60 Hz
+// tick) and never looks at the clock, rand() or gameInput.
+
+const int VERSUS_PLAYERS = 2;
+const int VERSUS_MAX_ROCKS = 64;
+const float VERSUS_SHIP_SPEED = 8.0f;
+const float VERSUS_SHIP_RADIUS = 16.0f;
+const float VERSUS_SHIP_Y = SCREEN_HEIGHT - 80;
+const float VERSUS_SPAWN_START = 0.04f;          // Rocks per tick at the start of a round
+const float VERSUS_SPAWN_RAMP = 0.00002f;        // Added per tick
+const float VERSUS_SPAWN_MAX = 0.15f;
+const int VERSUS_ROUND_PAUSE = 180;              // Ticks between rounds
+const uint32_t VERSUS_SEED = 0x5EED2026U;
+
+enum VersusButtons : uint8_t {
+    VERSUS_LEFT = 1,
+    VERSUS_RIGHT = 2
+};
+
+struct VersusShip {
+    float x;
+    int alive;
+    int score;              // Rocks dodged this round
+    int wins;
+};
+
+struct VersusState {
+    uint32_t tick;
+    uint32_t rng;
+    int round;
+    int roundTicks;
+    int winner;             // -1 while the round runs, else 0, 1, or 2 for a draw
+    int pause;              // Ticks left before the next round
+    float spawnCarry;
+    int rockCount;
+    VersusShip ships[VERSUS_PLAYERS];
+    FallingRock rocks[VERSUS_MAX_ROCKS];
+};
+static_assert(is_trivially_copyable<VersusState>::value, "VersusState is saved and restored by copying");
+
+inline uint32_t VersusRandom(VersusState& s) {
+    s.rng ^= s.rng << 13;
+    s.rng ^= s.rng >> 17;
+    s.rng ^= s.rng << 5;
+    return s.rng;
+}
+
+void VersusNewRound(VersusState& s) {
+    s.round++;
+    s.roundTicks = 0;
+    s.winner = -1;
+    s.pause = 0;
+    s.spawnCarry = 0;
+    s.rockCount = 0;
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        s.ships[p].x = SCREEN_WIDTH * (p + 1) / 3.0f;
+        s.ships[p].alive = 1;
+        s.ships[p].score = 0;
+    }
+}
+
+void VersusInit(VersusState& s, uint32_t seed) {
+    memset(&s, 0, sizeof(s));
+    s.rng = seed | 1;
+    VersusNewRound(s);
+}
+
+// One tick with both players' buttons
+void VersusStep(VersusState& s, const uint8_t* buttons) {
+    s.tick++;
+    if (s.winner >= 0) {
+        if (--s.pause <= 0) VersusNewRound(s);
+        return;
+    }
+    s.roundTicks++;
+
+    // Ships sweep against the rocks where they start the tick, as in the
+    // single-player game
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        VersusShip& ship = s.ships[p];
+        if (!ship.alive) continue;
+        Vector2 from = {ship.x, VERSUS_SHIP_Y};
+        if (buttons[p] & VERSUS_LEFT) ship.x -= VERSUS_SHIP_SPEED;
+        if (buttons[p] & VERSUS_RIGHT) ship.x += VERSUS_SHIP_SPEED;
+        ship.x = min(max(ship.x, 30.0f), SCREEN_WIDTH - 30.0f);
+        if (FirstRockImpact(s.rocks, s.rockCount, from, {ship.x, VERSUS_SHIP_Y}, VERSUS_SHIP_RADIUS) >= 0) {
+            ship.alive = 0;
+        }
+    }
+
+    for (int i = 0; i < s.rockCount; ) {
+        FallingRock& r = s.rocks[i];
+        r.y += r.speed;
+        if (r.y <= SCREEN_HEIGHT + 50) {
+            i++;
+            continue;
+        }
+        for (VersusShip& ship : s.ships) ship.score += ship.alive;
+        r = s.rocks[--s.rockCount];
+    }
+
+    s.spawnCarry += min(VERSUS_SPAWN_MAX, VERSUS_SPAWN_START + s.roundTicks * VERSUS_SPAWN_RAMP);
+    while (s.spawnCarry >= 1) {
+        s.spawnCarry -= 1;
+        if (s.rockCount >= VERSUS_MAX_ROCKS) continue;
+        FallingRock& r = s.rocks[s.rockCount++];
+        r.x = (float)(VersusRandom(s) % SCREEN_WIDTH);
+        r.y = -50;
+        r.speed = 3 + (float)(VersusRandom(s) % 4) + s.roundTicks / 1800;
+        r.size = 15 + (float)(VersusRandom(s) % 20);
+    }
+
+    int alive = s.ships[0].alive + s.ships[1].alive;
+    if (alive < VERSUS_PLAYERS) {
+        s.winner = (alive == 0) ? 2 : (s.ships[0].alive ? 0 : 1);
+        if (s.winner < 2) s.ships[s.winner].wins++;
+        s.pause = VERSUS_ROUND_PAUSE;
+    }
+}
+
+// FNV-1a over the whole state; the struct has no padding
+uint64_t VersusChecksum(const VersusState& s) {
+    uint64_t h = 1469598103934665603ULL;
+    const unsigned char* bytes = (const unsigned char*)&s;
+    for (size_t i = 0; i < sizeof(s); i++) h = (h ^ bytes[i]) * 1099511628211ULL;
+    return h;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ROLLBACK NETPLAY
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Each side runs the versus simulation at once with its own input and a
+// prediction of the other's (the last input that arrived, repeated). Every
+// tick's state is saved before it is stepped. When a real input arrives that
+// differs from the prediction, the state before that tick is restored and
+// everything since is simulated again; no side may run more than
+// ROLLBACK_MAX_FRAMES ahead of the last input it has from its peer, so that is
+// also the deepest rollback. Every packet carries all inputs the peer has not
+// acknowledged yet, so a lost packet costs nothing but latency and there are
+// no resend timers.
+//
+// Packet: "GHRB" | ack (u32) | first tick (u32) | count (u8) | count inputs
+
+const int ROLLBACK_MAX_FRAMES = 8;
+const int ROLLBACK_RING = 64;                    // Saved ticks; power of two
+const uint32_t ROLLBACK_NONE = 0xFFFFFFFFU;
+const int NET_PACKET_MAX = 13 + ROLLBACK_RING;
+
+struct RollbackStats {
+    int rollbacks;
+    int resimulated;        // Ticks run again in total
+    int deepest;            // Most ticks run again at once
+    double slowestMs;       // Longest restore plus resimulation
+    int stalls;             // Ticks held back waiting for the peer
+};
+
+inline void PutU32(unsigned char* out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out[i] = (unsigned char)(v >> (8 * i));
+}
+
+inline uint32_t GetU32(const unsigned char* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+class RollbackSession {
+private:
+    VersusState state;
+    VersusState saved[ROLLBACK_RING];            // saved[t % ring]: the state before tick t
+    uint8_t inputs[VERSUS_PLAYERS][ROLLBACK_RING];
+    int local = 0, remote = 1;
+    uint32_t confirmed = 0;                      // Peer inputs known for every tick below this
+    uint32_t acked = 0;                          // Peer has our inputs for every tick below this
+    uint8_t lastRemote = 0;
+    uint32_t rollbackFrom = ROLLBACK_NONE;       // Earliest tick simulated with a wrong prediction
+    RollbackStats stats = {};
+
+    void Simulate() {
+        uint32_t slot = state.tick % ROLLBACK_RING;
+        saved[slot] = state;
+        if (state.tick >= confirmed) inputs[remote][slot] = lastRemote;
+        uint8_t buttons[VERSUS_PLAYERS] = {inputs[0][slot], inputs[1][slot]};
+        VersusStep(state, buttons);
+    }
+
+public:
+    void Start(uint32_t seed, int localPlayer) {
+        VersusInit(state, seed);
+        local = localPlayer;
+        remote = 1 - localPlayer;
+        confirmed = acked = 0;
+        lastRemote = 0;
+        rollbackFrom = ROLLBACK_NONE;
+        stats = {};
+        memset(inputs, 0, sizeof(inputs));
+    }
+
+    // Fixes up any misprediction found since the last tick
+    void Resolve() {
+        if (rollbackFrom == ROLLBACK_NONE) return;
+        auto start = chrono::steady_clock::now();
+        uint32_t target = state.tick;
+        state = saved[rollbackFrom % ROLLBACK_RING];
+        while (state.tick < target) Simulate();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        int depth = (int)(target - rollbackFrom);
+        stats.rollbacks++;
+        stats.resimulated += depth;
+        stats.deepest = max(stats.deepest, depth);
+        stats.slowestMs = max(stats.slowestMs, ms);
+        rollbackFrom = ROLLBACK_NONE;
+    }
+
+    // Runs the next tick with this side's buttons. False, with nothing run,
+    // while the peer is too far behind.
+    bool Advance(uint8_t buttons) {
+        Resolve();
+        if (state.tick >= confirmed + ROLLBACK_MAX_FRAMES || state.tick - acked >= ROLLBACK_RING - 1) {
+            stats.stalls++;
+            return false;
+        }
+        inputs[local][state.tick % ROLLBACK_RING] = buttons;
+        Simulate();
+        return true;
+    }
+
+    int BuildPacket(unsigned char* out) const {
+        int count = (int)(state.tick - acked);
+        memcpy(out, "GHRB", 4);
+        PutU32(out + 4, confirmed);
+        PutU32(out + 8, acked);
+        out[12] = (unsigned char)count;
+        for (int i = 0; i < count; i++) out[13 + i] = inputs[local][(acked + i) % ROLLBACK_RING];
+        return 13 + count;
+    }
+
+    void ReceivePacket(const unsigned char* data, int size) {
+        if (size < 13 || memcmp(data, "GHRB", 4) != 0 || size < 13 + data[12]) return;
+        uint32_t ack = GetU32(data + 4), first = GetU32(data + 8);
+        if (ack > acked && ack <= state.tick) acked = ack;
+        for (int i = 0; i < data[12]; i++) {
+            uint32_t t = first + i;
+            if (t < confirmed) continue;
+            if (t > confirmed) break;            // A gap: a later packet will fill it
+            uint8_t buttons = data[13 + i];
+            uint8_t& used = inputs[remote][t % ROLLBACK_RING];
+            if (t < state.tick && used != buttons) rollbackFrom = min(rollbackFrom, t);
+            used = buttons;
+            lastRemote = buttons;
+            confirmed++;
+        }
+    }
+
+    const VersusState& State() const { return state; }
+    uint32_t Tick() const { return state.tick; }
+    uint32_t Confirmed() const { return confirmed; }
+    uint32_t Acked() const { return acked; }
+    int LocalPlayer() const { return local; }
+    const RollbackStats& Stats() const { return stats; }
+};
+
+// Non-blocking UDP socket with one fixed peer
+class UdpLink {
+private:
+#if defined(_WIN32)
+    SOCKET sock = INVALID_SOCKET;
+#else
+    int sock = -1;
+#endif
+    sockaddr_in peer = {};
+
+public:
+    ~UdpLink() { Close(); }
+
+    bool Open(uint16_t localPort, const char* remoteHost, uint16_t remotePort) {
+#if defined(_WIN32)
+        WSADATA wsa;
+        if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+        sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (sock == INVALID_SOCKET) {
+            WSACleanup();
+            return false;
+        }
+        u_long nonBlocking = 1;
+        ioctlsocket(sock, FIONBIO, &nonBlocking);
+#else
+        sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (sock < 0) return false;
+        fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(localPort);
+        peer.sin_family = AF_INET;
+        peer.sin_addr.s_addr = inet_addr(remoteHost);
+        peer.sin_port = htons(remotePort);
+        if (bind(sock, (sockaddr*)&address, sizeof(address)) != 0 || peer.sin_addr.s_addr == INADDR_NONE) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Send(const unsigned char* data, int size) {
+        sendto(sock, (const char*)data, size, 0, (const sockaddr*)&peer, sizeof(peer));
+    }
+
+    // Bytes of the next waiting datagram, 0 when there is none
+    int Receive(unsigned char* buffer, int capacity) {
+        int n = (int)recvfrom(sock, (char*)buffer, capacity, 0, nullptr, nullptr);
+        return n > 0 ? n : 0;
+    }
+
+    void Close() {
+#if defined(_WIN32)
+        if (sock == INVALID_SOCKET) return;
+        closesocket(sock);
+        sock = INVALID_SOCKET;
+        WSACleanup();
+#else
+        if (sock < 0) return;
+        close(sock);
+        sock = -1;
+#endif
+    }
+};
+
+// Holds back and drops outgoing packets to imitate a poor network. Uses its
+// own generator so a test run can be repeated exactly.
+class NetConditioner {
+private:
+    struct HeldPacket {
+        double due;
+        int size;
+        unsigned char bytes[NET_PACKET_MAX];
+    };
+    vector<HeldPacket> held;
+    uint32_t rng = 1;
+
+    float Random() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return (rng & 0xFFFFFF) / 16777216.0f;
+    }
+
+public:
+    double latencyMs = 0;
+    double jitterMs = 0;
+    float loss = 0;         // 0..1
+
+    void Seed(uint32_t seed) { rng = seed | 1; }
+
+    template <typename Fn>
+    void Send(double nowMs, const unsigned char* data, int size, Fn deliver) {
+        if (Random() < loss) return;
+        if (latencyMs <= 0 && jitterMs <= 0) {
+            deliver(data, size);
+            return;
+        }
+        HeldPacket packet;
+        packet.due = nowMs + latencyMs + jitterMs * Random();
+        packet.size = min(size, NET_PACKET_MAX);
+        memcpy(packet.bytes, data, packet.size);
+        held.push_back(packet);
+    }
+
+    // Delivers every held packet that is due, oldest deadline first
+    template <typename Fn>
+    void Flush(double nowMs, Fn deliver) {
+        sort(held.begin(), held.end(), [](const HeldPacket& a, const HeldPacket& b) { return a.due < b.due; });
+        size_t sent = 0;
+        while (sent < held.size() && held[sent].due <= nowMs) {
+            deliver(held[sent].bytes, held[sent].size);
+            sent++;
+        }
+        held.erase(held.begin(), held.begin() + sent);
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BREAK THE CODE GAME CLASS
+// ═══════════════════════════════════════════════════════════════════════════
+
+class BreakTheCodeGame {
+private:
+    int secretCode[4];
+    int guesses[10][4];
+    int feedback[10][2];  // [correctPos, correctDigit]
+    int currentGuess;
+    int inputDigits[4];
+    int inputIndex;
+    bool gameOver;
+    bool won;
+    float animTime;
+
+public:
+    void Init() {
+        // Generate secret code with unique digits
+        vector<int> digits = {0,1,2,3,4,5,6,7,8,9};
+        for (int i = 9; i > 0; i--) {
+            int j = rand() % (i + 1);
+            swap(digits[i], digits[j]);
+        }
+        for (int i = 0; i < 4; i++) secretCode[i] = digits[i];
+
+        for (int i = 0; i < 10; i++) {
+            for (int j = 0; j < 4; j++) guesses[i][j] = -1;
+            feedback[i][0] = feedback[i][1] = 0;
+        }
+
+        currentGuess = 0;
+        inputIndex = 0;
+        for (int i = 0; i < 4; i++) inputDigits[i] = -1;
+        gameOver = false;
+        won = false;
+        animTime = 0;
+    }
+
+    void CheckGuess() {
+        int correctPos = 0, correctDigit = 0;
+        bool secretUsed[4] = {false}, guessUsed[4] = {false};
+
+        for (int i = 0; i < 4; i++) {
+            if (inputDigits[i] == secretCode[i]) {
+                correctPos++;
+                secretUsed[i] = guessUsed[i] = true;
+            }
+        }
+
+        for (int i = 0; i < 4; i++) {
+            if (!guessUsed[i]) {
+                for (int j = 0; j < 4; j++) {
+                    if (!secretUsed[j] && inputDigits[i] == secretCode[j]) {
+                        correctDigit++;
+                        secretUsed[j] = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < 4; i++) guesses[currentGuess][i] = inputDigits[i];
+        feedback[currentGuess][0] = correctPos;
+        feedback[currentGuess][1] = correctDigit;
+
+        if (correctPos == 4) {
+            won = gameOver = true;
+            EmitResultEffect(true);
+            // Save score
+            ofstream file("codebreaker_leaderboard.txt", ios::app);
+            if (file.is_open()) {
+                file << "Cracked in " << (currentGuess + 1) << " attempts\n";
+                file.close();
+            }
+        } else {
+            currentGuess++;
+            if (currentGuess >= 10) {
+                gameOver = true;
+                EmitResultEffect(false);
+            }
+        }
+
+        inputIndex = 0;
+        for (int i = 0; i < 4; i++) inputDigits[i] = -1;
+    }
+
+    bool Update() {
+        if (gameInput.KeyPressed(KEY_ESCAPE) || gameInput.KeyPressed(KEY_M)) return true;
+
+        animTime += FrameDelta();
+
+        if (gameOver) {
+            if (gameInput.KeyPressed(KEY_SPACE)) Init();
+            return false;
+        }
+
+        // Number input
+        for (int key = KEY_ZERO; key <= KEY_NINE; key++) {
+            if (gameInput.KeyPressed(key) && inputIndex < 4) {
+                inputDigits[inputIndex++] = key - KEY_ZERO;
+            }
+        }
+
+        // Backspace
+        if (gameInput.KeyPressed(KEY_BACKSPACE) && inputIndex > 0) {
+            inputDigits[--inputIndex] = -1;
+        }
+
+        // Submit guess
+        if (gameInput.KeyPressed(KEY_ENTER) && inputIndex == 4) {
+            CheckGuess();
+        }
+
+        return false;
+    }
+
+    void Draw() {
+        DrawAnimatedBackground();
+
+        DrawTextCentered("BREAK THE CODE", 30, 40, Colors::ACCENT);
+        DrawTextCentered("Guess the 4-digit code (unique digits 0-9)", 80, 20, Colors::TEXT_DIM);
+
+        // Draw previous guesses
+        float startY = 120;
+        for (int g = 0; g < 10; g++) {
+            float y = startY + g * 45;
+
+            // Attempt number
+            char numText[8];
+            sprintf(numText, "%2d.", g + 1);
+            DrawUIText(numText, 250, y + 8, 20, g < currentGuess ? Colors::TEXT_DIM : Colors::TEXT_LIGHT);
+
+            // Digit boxes
+            for (int d = 0; d < 4; d++) {
+                Rectangle box = {300 + d * 60.0f, y, 50, 40};
+                Color boxColor = (g == currentGuess) ? Colors::CARD_HOVER : Colors::CARD_BG;
+                Gfx::FillRoundedRect(box, 0.2f, 4, boxColor);
+                Gfx::StrokeRoundedRect(box, 0.2f, 4, 2, Colors::PRIMARY);
+
+                if (guesses[g][d] >= 0) {
+                    char digit[2] = {(char)('0' + guesses[g][d]), 0};
+                    DrawUIText(digit, box.x + 18, box.y + 8, 24, Colors::TEXT_LIGHT);
+                } else if (g == currentGuess && d < inputIndex) {
+                    char digit[2] = {(char)('0' + inputDigits[d]), 0};
+                    DrawUIText(digit, box.x + 18, box.y + 8, 24, Colors::ACCENT);
+                }
+            }
+
+            // Feedback
+            if (g < currentGuess) {
+                char fb[32];
+                sprintf(fb, "%d correct, %d misplaced", feedback[g][0], feedback[g][1]);
+                DrawUIText(fb, 560, y + 10, 18,
+                         feedback[g][0] == 4 ? Colors::SUCCESS : Colors::TEXT_DIM);
+            }
+        }
+
+        // Current input instruction
+        if (!gameOver) {
+            DrawTextCentered("Type 4 digits and press ENTER to guess",
+                           SCREEN_HEIGHT - 80, 20, Colors::TEXT_LIGHT);
+        } else {
+            if (won) {
+                char winText[64];
+                sprintf(winText, "YOU WON in %d attempts!", currentGuess);
+                DrawTextCentered(winText, SCREEN_HEIGHT - 100, 30, Colors::SUCCESS);
+            } else {
+                char loseText[64];
+                sprintf(loseText, "Game Over! Code was: %d%d%d%d",
+                        secretCode[0], secretCode[1], secretCode[2], secretCode[3]);
+                DrawTextCentered(loseText, SCREEN_HEIGHT - 100, 26, Colors::DANGER);
+            }
+            DrawTextCentered("Press SPACE to play again", SCREEN_HEIGHT - 60, 18, Colors::TEXT_DIM);
+        }
+
+        DrawUIText("Press M or ESC to return to menu", 20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ESCAPE ZOMBIE LAND GAME CLASS
+// ═══════════════════════════════════════════════════════════════════════════
+
+class ZombieLandGame {
+private:
+    static const int GRID_SIZE = 10;
+    int playerX, playerY;
+    int zombieX, zombieY;
+    int safeX, safeY;
+    bool gameOver;
+    bool won;
+    float animTime;
+    float cellSize;
+    float offsetX, offsetY;
+    TweenPool<2, 1> tweens;      // Channel 0: game-over fade
+
+public:
+    void Init() {
+        playerX = playerY = 0;
+        zombieX = zombieY = GRID_SIZE / 2;
+        safeX = safeY = GRID_SIZE - 1;
+        gameOver = false;
+        won = false;
+        animTime = 0;
+        tweens.Clear();
+        cellSize = 50;
+        offsetX = (SCREEN_WIDTH - GRID_SIZE * cellSize) / 2;
+        offsetY = 150;
+    }
+
+    void MoveZombie() {
+        int dir = rand() % 4;
+        int newX = zombieX, newY = zombieY;
+        if (dir == 0) newY--;
+        else if (dir == 1) newY++;
+        else if (dir == 2) newX--;
+        else newX++;
+
+        if (newX >= 0 && newX < GRID_SIZE) zombieX = newX;
+        if (newY >= 0 && newY < GRID_SIZE) zombieY = newY;
+    }
+
+    bool Update() {
+        if (gameInput.KeyPressed(KEY_ESCAPE) || gameInput.KeyPressed(KEY_M)) return true;
+
+        animTime += FrameDelta();
+        tweens.Update(FrameDelta(), this);
+
+        if (gameOver) {
+            if (gameInput.KeyPressed(KEY_SPACE)) Init();
+            return false;
+        }
+
+        bool moved = false;
+        if (gameInput.KeyPressed(KEY_W) || gameInput.KeyPressed(KEY_UP)) { if (playerY > 0) playerY--; moved = true; }
+        if (gameInput.KeyPressed(KEY_S) || gameInput.KeyPressed(KEY_DOWN)) { if (playerY < GRID_SIZE-1) playerY++; moved = true; }
+        if (gameInput.KeyPressed(KEY_A) || gameInput.KeyPressed(KEY_LEFT)) { if (playerX > 0) playerX--; moved = true; }
+        if (gameInput.KeyPressed(KEY_D) || gameInput.KeyPressed(KEY_RIGHT)) { if (playerX < GRID_SIZE-1) playerX++; moved = true; }
+
+        if (moved) {
+            MoveZombie();
+
+            // Check win
+            if (playerX == safeX && playerY == safeY) {
+                won = gameOver = true;
+                ofstream file("zombie_escape_results.txt", ios::app);
+                if (file.is_open()) { file << "Survived!\n"; file.close(); }
+            }
+            // Check lose
+            else if (playerX == zombieX && playerY == zombieY) {
+                gameOver = true;
+                ofstream file("zombie_escape_results.txt", ios::app);
+                if (file.is_open()) { file << "Caught by zombie!\n"; file.close(); }
+            }
+            if (gameOver) {
+                tweens.To(0, 1, 0.4f, EASE_OUT_CUBIC);
+                EmitResultEffect(won);
+            }
+        }
+
+        return false;
+    }
+
+    void Draw() {
+        DrawAnimatedBackground();
+
+        DrawList& list = drawQueue.Begin();
+        list.layer = LAYER_HUD;
+        list.TextCentered("ESCAPE ZOMBIE LAND", 30, 40, Colors::ACCENT);
+        list.TextCentered("Reach the Safe Zone! Avoid the Zombie!", 80, 20, Colors::TEXT_DIM);
+
+        // Legend
+        list.Text("You", 100, 120, 18, Colors::SUCCESS);
+        list.Text("Zombie", 200, 120, 18, Colors::DANGER);
+        list.Text("Safe Zone", 320, 120, 18, Colors::ACCENT);
+
+        // Draw grid; cells are 2px apart so fills and outlines never overlap
+        // and sort into one run each
+        list.layer = LAYER_WORLD;
+        drawQueue.ParallelRecord(GRID_SIZE * GRID_SIZE, 1024, [this](DrawList& out, int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                int x = i % GRID_SIZE, y = i / GRID_SIZE;
+                Rectangle cell = {offsetX + x * cellSize, offsetY + y * cellSize, cellSize - 2, cellSize - 2};
+
+                Color cellColor = Colors::CARD_BG;
+                if (x == safeX && y == safeY) cellColor = (Color){255, 215, 0, 100};
+
+                out.RoundedRect(cell, 0.1f, 4, cellColor);
+                out.RoundedOutline(cell, 0.1f, 4, 1, Colors::PRIMARY);
+            }
+        });
+
+        // Draw zombie
+        list.layer = LAYER_ACTORS;
+        float zx = offsetX + zombieX * cellSize + cellSize/2;
+        float zy = offsetY + zombieY * cellSize + cellSize/2;
+        float pulse = sin(animTime * 5) * 3;
+        list.Sprite(SPRITE_TOKEN_ZOMBIE, zx, zy, (TOKEN_RADIUS + pulse) / TOKEN_RADIUS);
+
+        // Draw safe zone marker
+        float sx = offsetX + safeX * cellSize + cellSize/2;
+        float sy = offsetY + safeY * cellSize + cellSize/2;
+        list.Sprite(SPRITE_TOKEN_SAFE, sx, sy);
+
+        // Draw player
+        float px = offsetX + playerX * cellSize + cellSize/2;
+        float py = offsetY + playerY * cellSize + cellSize/2;
+        list.Sprite(SPRITE_TOKEN_PLAYER, px, py);
+
+        // Result
+        list.layer = LAYER_OVERLAY;
+        if (gameOver) {
+            float fade = tweens.Value(0);
+            float rise = (1 - fade) * 30;
+            list.Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, (unsigned char)(180 * fade)});
+            if (won) {
+                list.TextCentered("YOU ESCAPED!", SCREEN_HEIGHT/2 - 40 + rise, 50, Faded(Colors::SUCCESS, fade));
+            } else {
+                list.TextCentered("CAUGHT BY ZOMBIE!", SCREEN_HEIGHT/2 - 40 + rise, 50, Faded(Colors::DANGER, fade));
+            }
+            list.TextCentered("Press SPACE to play again", SCREEN_HEIGHT/2 + 30 + rise, 20, Faded(Colors::TEXT_DIM, fade));
+        }
+
+        list.Text("Move: WASD or Arrow Keys | Press M to return to menu",
+                  20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+
+        drawQueue.Submit();
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SWAP CARDS GAME CLASS
+// ═══════════════════════════════════════════════════════════════════════════
+
+class SwapCardsGame {
+private:
+    static const int FLIP_CHANNELS = 16;         // One flip angle per card
+    static const int OVERLAY = 16;               // Game-over fade
+    static constexpr float FLIP_TIME = 0.25f;
+
+    char cards[16];
+    bool revealed[16];
+    bool matched[16];
+    int firstCard, secondCard;
+    int matches, moves;
+    bool gameOver;
+    bool resolving;              // Two cards are up and waiting to be checked
+    float animTime;
+    float cardWidth, cardHeight;
+    float offsetX, offsetY;
+    TweenPool<32, FLIP_CHANNELS + 1> tweens;
+
+    static void OnPairShown(void* owner, int) {
+        static_cast<SwapCardsGame*>(owner)->ResolvePair();
+    }
+
+    void ResolvePair() {
+        if (cards[firstCard] == cards[secondCard]) {
+            matched[firstCard] = matched[secondCard] = true;
+            matches++;
+            if (matches == 8) {
+                gameOver = true;
+                tweens.To(OVERLAY, 1, 0.4f, EASE_OUT_CUBIC);
+                EmitResultEffect(true);
+                ofstream file("swapcards_best_score.txt", ios::app);
+                if (file.is_open()) {
+                    file << "Completed in " << moves << " moves\n";
+                    file.close();
+                }
+            }
+        } else {
+            tweens.To(firstCard, 0, FLIP_TIME);
+            tweens.To(secondCard, 0, FLIP_TIME);
+        }
+        revealed[firstCard] = revealed[secondCard] = false;
+        firstCard = secondCard = -1;
+        resolving = false;
+    }
+
+public:
+    void Init() {
+        char symbols[8] = {'A','B','C','D','E','F','G','H'};
+        int idx = 0;
         for (int i = 0; i < 8; i++) {
             cards[idx++] = symbols[i];
             cards[idx++] = symbols[i];
         }
 
-        // Shuffle
-        for (int i = 0; i < 16; i++) {
-            int j = rand() % 16;
-            swap(cards[i], cards[j]);
+        // Shuffle
+        for (int i = 0; i < 16; i++) {
+            int j = rand() % 16;
+            swap(cards[i], cards[j]);
+        }
+
+        for (int i = 0; i < 16; i++) {
+            revealed[i] = matched[i] = false;
+        }
+
+        firstCard = secondCard = -1;
+        matches = moves = 0;
+        gameOver = false;
+        resolving = false;
+        animTime = 0;
+        cardWidth = 120;
+        cardHeight = 150;
+        offsetX = (SCREEN_WIDTH - 4 * cardWidth - 30) / 2;
+        offsetY = 150;
+        tweens.Clear();
+    }
+
+    bool Update() {
+        if (gameInput.KeyPressed(KEY_ESCAPE) || gameInput.KeyPressed(KEY_M)) return true;
+
+        animTime += FrameDelta();
+        tweens.Update(FrameDelta(), this);
+
+        if (gameOver) {
+            if (gameInput.KeyPressed(KEY_SPACE)) Init();
+            return false;
+        }
+
+        // Wait until the shown pair has been checked
+        if (resolving) return false;
+
+        // Card selection
+        if (gameInput.MousePressed(MOUSE_LEFT_BUTTON)) {
+            Vector2 mouse = gameInput.MousePosition();
+
+            for (int i = 0; i < 16; i++) {
+                if (matched[i] || revealed[i]) continue;
+
+                int row = i / 4, col = i % 4;
+                Rectangle card = {offsetX + col * (cardWidth + 10), offsetY + row * (cardHeight + 10),
+                                  cardWidth, cardHeight};
+
+                if (CheckCollisionPointRec(mouse, card)) {
+                    revealed[i] = true;
+                    tweens.To(i, 1, FLIP_TIME);
+
+                    if (firstCard < 0) {
+                        firstCard = i;
+                    } else {
+                        secondCard = i;
+                        moves++;
+                        resolving = true;
+                        // Show the pair for a second, flip included, then check it
+                        tweens.Begin().Wait(1.0f).Call(OnPairShown);
+                    }
+                    break;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void Draw() {
+        DrawAnimatedBackground();
+
+        DrawTextCentered("SWAP CARDS", 30, 40, Colors::ACCENT);
+
+        char statsText[64];
+        sprintf(statsText, "Moves: %d  |  Matches: %d/8", moves, matches);
+        DrawTextCentered(statsText, 80, 24, Colors::TEXT_LIGHT);
+
+        // Draw cards; a flip squashes the card to nothing and swaps the face
+        // at the halfway point
+        for (int i = 0; i < 16; i++) {
+            int row = i / 4, col = i % 4;
+            Rectangle card = {offsetX + col * (cardWidth + 10), offsetY + row * (cardHeight + 10),
+                              cardWidth, cardHeight};
+
+            Vector2 mouse = GetMousePosition();
+            bool hover = CheckCollisionPointRec(mouse, card) && !matched[i] && !revealed[i];
+
+            float flip = tweens.Value(i);
+            float squash = fabsf(cosf(flip * PI));
+            if (squash * cardWidth < 1) continue;
+            Rectangle face = {card.x + card.width * (1 - squash) / 2, card.y, card.width * squash, card.height};
+
+            int symbol = cards[i] - 'A';
+            if (flip < 0.5f) spriteAtlas.DrawRect(hover ? SPRITE_CARD_HIDDEN_HOVER : SPRITE_CARD_HIDDEN, face);
+            else if (matched[i]) spriteAtlas.DrawRect(SPRITE_CARD_MATCHED + symbol, face);
+            else spriteAtlas.DrawRect(SPRITE_CARD_REVEALED + symbol, face);
+        }
+
+        // Game over
+        if (gameOver) {
+            float fade = tweens.Value(OVERLAY);
+            float rise = (1 - fade) * 30;
+            Gfx::FillRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, (unsigned char)(180 * fade)});
+            DrawTextCentered("CONGRATULATIONS!", SCREEN_HEIGHT/2 - 60 + rise, 50, Faded(Colors::SUCCESS, fade));
+            sprintf(statsText, "Completed in %d moves!", moves);
+            DrawTextCentered(statsText, SCREEN_HEIGHT/2 + rise, 30, Faded(Colors::ACCENT, fade));
+            DrawTextCentered("Press SPACE to play again", SCREEN_HEIGHT/2 + 50 + rise, 20, Faded(Colors::TEXT_DIM, fade));
+        }
+
+        DrawUIText("Click cards to flip | Press M to return to menu",
+                 20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MAIN MENU AND GAME LOOP
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Menu button structure
+struct MenuButton {
+    const char* title;
+    const char* description;
+    Color color;
+};
+
+const MenuButton MENU_BUTTONS[5] = {
+    {"Tic-Tac-Toe", "Classic 2-Player Strategy Game", Colors::SUCCESS},
+    {"Space Survivor", "Dodge Asteroids in Space", Colors::PRIMARY},
+    {"Break The Code", "Mastermind Puzzle Challenge", Colors::ACCENT},
+    {"Escape Zombie Land", "Survive the Zombie Apocalypse", Colors::DANGER},
+    {"Swap Cards", "Test Your Memory Skills", Colors::SECONDARY}
+};
+
+Rectangle MenuButtonRect(int i) {
+    float buttonWidth = 350;
+    float buttonHeight = 70;
+    float buttonX = (SCREEN_WIDTH - buttonWidth) / 2;
+    return {buttonX, 250 + i * 80.0f, buttonWidth, buttonHeight};
+}
+
+// Menu animations, stepped by the simulation with the rest of the World
+struct MenuUI {
+    static const int TITLE_BOB = 0;
+    static const int HOVER = 1;                  // One growth channel per button
+    TweenPool<8, HOVER + 5> tweens;
+    bool hovered[5] = {};
+
+    void Update(float dt, Vector2 mouse) {
+        // Title bobs +-5 px; starting halfway through a swing matches sin()
+        if (!tweens.Animating(TITLE_BOB)) tweens.PingPong(TITLE_BOB, -5, 5, PI / 2, EASE_IN_OUT_SINE, -PI / 4);
+        for (int i = 0; i < 5; i++) {
+            bool hover = CheckCollisionPointRec(mouse, MenuButtonRect(i));
+            if (hover != hovered[i]) tweens.To(HOVER + i, hover ? 1.0f : 0.0f, 0.15f, EASE_OUT_QUAD);
+            hovered[i] = hover;
+        }
+        tweens.Update(dt, this);
+    }
+};
+
+// Draw animated title
+void DrawTitle(float bob) {
+    const char* title = "GAMING HUB";
+    int fontSize = 70;
+    int width = MeasureUIText(title, fontSize);
+    float x = (SCREEN_WIDTH - width) / 2.0f;
+    float y = 80 + bob;
+
+    // Shadow
+    DrawUIText(title, x + 4, y + 4, fontSize, (Color){0, 0, 0, 100});
+    // Main text with gradient effect
+    DrawUIText(title, x, y, fontSize, Colors::ACCENT);
+
+    // Subtitle
+    DrawTextCentered("Professional C++ Arcade", 160, 24, Colors::TEXT_DIM);
+    DrawTextCentered("First Semester Project", 190, 18, Colors::TEXT_DIM);
+}
+
+// Draw the F3 statistics panel (not counted in the statistics themselves).
+// simTickMs is negative when the simulation runs inside the render loop.
+void DrawStatsOverlay(GameState state, float simTickMs) {
+    renderStats.Pause();
+    const FrameStats& f = renderStats.Last();
+    FrameStats avg = renderStats.Average(state);
+    char lines[12][96];
+    snprintf(lines[0], 96, "Render stats: %s", GAME_STATE_NAMES[state]);
+    snprintf(lines[1], 96, "Primitives   %5d  avg %5d", f.primitives, avg.primitives);
+    snprintf(lines[2], 96, "Vertices     %5d  avg %5d", f.vertices, avg.vertices);
+    snprintf(lines[3], 96, "Draw calls   %5d  avg %5d", f.drawCalls, avg.drawCalls);
+    snprintf(lines[4], 96, "Flushes      %5d  avg %5d", f.batchFlushes, avg.batchFlushes);
+    snprintf(lines[5], 96, "Text/glyphs  %3d/%-4d", f.textCalls, f.glyphs);
+    snprintf(lines[6], 96, "Sprites      %5d  avg %5d", f.sprites, avg.sprites);
+    snprintf(lines[7], 96, "Buttons/texts/bg  %d/%d/%d", f.buttons, f.centeredTexts, f.backgrounds);
+    snprintf(lines[8], 96, "Draw CPU  %6.2f ms  avg %5.2f", f.drawMs, avg.drawMs);
+    snprintf(lines[9], 96, "Render scale %4.0f%%%s", dynamicResolution.Scale() * 100,
+             dynamicResolution.enabled ? "" : " (F4: off)");
+    snprintf(lines[10], 96, "Frame p50 %5.2f  p99 %5.2f ms%s", framePacer.PercentileMs(0.5f),
+             framePacer.PercentileMs(0.99f), framePacer.lowLatency ? " LL" : "");
+    if (simTickMs >= 0) snprintf(lines[11], 96, "Sim tick  %6.2f ms (thread)", simTickMs);
+    else snprintf(lines[11], 96, "Sim tick  in render loop");
+
+    Gfx::FillRoundedRect({SCREEN_WIDTH - 290, 10, 280, 260}, 0.1f, 4, (Color){0, 0, 0, 200});
+    for (int i = 0; i < 12; i++) {
+        DrawUIText(lines[i], SCREEN_WIDTH - 280, 20 + i * 20, 16, i == 0 ? Colors::ACCENT : Colors::TEXT_LIGHT);
+    }
+    renderStats.Resume();
+}
+
+// Draw the main menu screen
+void DrawMenu(const MenuUI& ui) {
+    DrawAnimatedBackground();
+    DrawTitle(ui.tweens.Value(MenuUI::TITLE_BOB));
+
+    // Draw menu buttons, grown slightly while hovered
+    for (int i = 0; i < 5; i++) {
+        Rectangle btn = MenuButtonRect(i);
+        Vector2 mouse = GetMousePosition();
+        bool hover = CheckCollisionPointRec(mouse, btn);
+        float grow = ui.tweens.Value(MenuUI::HOVER + i);
+        btn = {btn.x - 10 * grow, btn.y - 3 * grow, btn.width + 20 * grow, btn.height + 6 * grow};
+
+        Color bgColor = hover ? MENU_BUTTONS[i].color : Colors::CARD_BG;
+        Gfx::FillRoundedRect(btn, 0.2f, 8, bgColor);
+        Gfx::StrokeRoundedRect(btn, 0.2f, 8, 2, MENU_BUTTONS[i].color);
+
+        int textWidth = MeasureUIText(MENU_BUTTONS[i].title, 28);
+        DrawUIText(MENU_BUTTONS[i].title, btn.x + (btn.width - textWidth)/2, btn.y + 12, 28, WHITE);
+
+        int descWidth = MeasureUIText(MENU_BUTTONS[i].description, 14);
+        DrawUIText(MENU_BUTTONS[i].description, btn.x + (btn.width - descWidth)/2, btn.y + 45, 14,
+                   hover ? WHITE : Colors::TEXT_DIM);
+    }
+
+    // Footer
+    DrawTextCentered("Click a game to start | Press ESC to exit", SCREEN_HEIGHT - 40, 16, Colors::TEXT_DIM);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SIMULATION THREAD
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Everything the simulation owns. GPU resources live in globals, so a World is
+// a plain value that can be copied into a snapshot for the renderer.
+struct World {
+    GameState state = MENU;
+    MenuUI menu;
+    TicTacToeGame ticTacToe{};
+    SpaceSurvivorGame spaceSurvivor{};
+    BreakTheCodeGame breakTheCode{};
+    ZombieLandGame zombieLand{};
+    SwapCardsGame swapCards{};
+
+    void Update() {
+        switch (state) {
+            case MENU: {
+                menu.Update(FrameDelta(), gameInput.MousePosition());
+
+                // Check button clicks
+                for (int i = 0; i < 5; i++) {
+                    Vector2 mouse = gameInput.MousePosition();
+
+                    if (CheckCollisionPointRec(mouse, MenuButtonRect(i)) && gameInput.MousePressed(MOUSE_LEFT_BUTTON)) {
+                        switch (i) {
+                            case 0: state = TICTACTOE; ticTacToe.Init(); break;
+                            case 1: state = SPACE_SURVIVOR; spaceSurvivor.Init(); break;
+                            case 2: state = BREAK_CODE; breakTheCode.Init(); break;
+                            case 3: state = ZOMBIE_LAND; zombieLand.Init(); break;
+                            case 4: state = SWAP_CARDS; swapCards.Init(); break;
+                        }
+                    }
+                }
+                break;
+            }
+            case TICTACTOE:
+                if (ticTacToe.Update()) state = MENU;
+                break;
+            case SPACE_SURVIVOR:
+                if (spaceSurvivor.Update()) state = MENU;
+                break;
+            case BREAK_CODE:
+                if (breakTheCode.Update()) state = MENU;
+                break;
+            case ZOMBIE_LAND:
+                if (zombieLand.Update()) state = MENU;
+                break;
+            case SWAP_CARDS:
+                if (swapCards.Update()) state = MENU;
+                break;
+        }
+    }
+
+    void Draw() {
+        switch (state) {
+            case MENU: DrawMenu(menu); break;
+            case TICTACTOE: ticTacToe.Draw(); break;
+            case SPACE_SURVIVOR: spaceSurvivor.Draw(); break;
+            case BREAK_CODE: breakTheCode.Draw(); break;
+            case ZOMBIE_LAND: zombieLand.Draw(); break;
+            case SWAP_CARDS: swapCards.Draw(); break;
+        }
+        particles.Draw();
+    }
+};
+
+// Lock-free triple buffer: the writer fills Back() and publishes it, the reader
+// takes the newest published slot. Neither side ever waits, and the reader's
+// slot is never written while it is being drawn.
+template <typename T>
+class TripleBuffer {
+private:
+    static const int FRESH = 4;                 // Set while the middle slot is unread
+    T slots[3];
+    alignas(64) int back = 0;                   // Writer only
+    alignas(64) atomic<int> middle{1};
+    alignas(64) int front = 2;                  // Reader only
+
+public:
+    T& Back() { return slots[back]; }
+
+    void Publish() {
+        back = middle.exchange(back | FRESH, memory_order_acq_rel) & 3;
+    }
+
+    // Returns true if a newer snapshot was picked up
+    bool Acquire() {
+        if (!(middle.load(memory_order_acquire) & FRESH)) return false;
+        front = middle.exchange(front, memory_order_acq_rel) & 3;
+        return true;
+    }
+
+    T& Front() { return slots[front]; }
+};
+
+// Steps the World at a fixed 60 Hz on its own thread, independent of the
+// render rate. The game updates move things by fixed amounts per call, so a
+// fixed step also keeps gameplay speed the same at --fps 144.
+const int SIMULATION_HZ = 60;
+
+class SimulationThread {
+private:
+    World world;
+    TripleBuffer<World> snapshots;
+    thread worker;
+    atomic<bool> running{false};
+    atomic<float> tickMs{0};
+
+    void Run() {
+        simulationStep = 1.0f / SIMULATION_HZ;
+        FramePacer pacer;
+        pacer.SetTarget(SIMULATION_HZ);
+        while (running.load(memory_order_acquire)) {
+            auto tickStart = chrono::steady_clock::now();
+            input.Drain(gameInput);
+            world.Update();
+
+            // Copy-assignment reuses the slot's vector storage after warm-up
+            snapshots.Back() = world;
+            snapshots.Publish();
+            tickMs.store(chrono::duration<float, milli>(chrono::steady_clock::now() - tickStart).count(),
+                         memory_order_relaxed);
+            pacer.Wait();
+        }
+    }
+
+public:
+    InputBridge input;
+
+    void Start() {
+        running = true;
+        worker = thread(&SimulationThread::Run, this);
+    }
+
+    void Stop() {
+        running = false;
+        if (worker.joinable()) worker.join();
+    }
+
+    // Render thread: newest complete snapshot (the previous one if nothing new)
+    World& Latest() {
+        snapshots.Acquire();
+        return snapshots.Front();
+    }
+
+    float TickMs() const { return tickMs.load(memory_order_relaxed); }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// HEADLESS SCREENSHOTS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// GamingHub --screenshot <screen> <file> [frames] [seed]
+//   screen: menu, tictactoe, space, space-open, space-swarm, code, zombie or cards
+//   file:   .png or .ppm; with frames > 1 it is a printf pattern (shot_%04d.ppm)
+// Renders with the software rasterizer at a fixed 60 Hz step and no window, so
+// the same arguments always produce the same pixels.
+int RunHeadless(int argc, char** argv) {
+    if (argc < 4) {
+        printf("Usage: %s --screenshot <menu|tictactoe|tictactoe-gomoku|tictactoe-ultimate|tictactoe-qubic|space|space-open|"
+               "space-swarm|code|zombie|cards> <file> [frames] [seed]\n", argv[0]);
+        return 1;
+    }
+    string screen = argv[2];
+    const char* output = argv[3];
+    int frames = (argc > 4) ? max(1, atoi(argv[4])) : 1;
+    unsigned int seed = (argc > 5) ? (unsigned int)atoi(argv[5]) : 1;
+
+    headless = true;
+    srand(seed);
+    jobs.Start();
+    searchJobs.Start();
+    waveSchedule.Load();
+    uiFont.Load();
+    if (!uiFont.Loaded()) {
+        fprintf(stderr, "warning: no font loaded (it needs %s or a system TTF), "
+                        "so the screenshots will have no text\n", FONT_TTF_CANDIDATES[0]);
+    }
+    starfield.Load();
+    spriteAtlas.Bake();
+    backgroundParticles.Init(BACKGROUND_PARTICLES);
+
+    World world;
+    if (screen == "tictactoe") { world.state = TICTACTOE; world.ticTacToe.Init(); }
+    else if (screen == "tictactoe-gomoku") { world.state = TICTACTOE; world.ticTacToe.StartDemo(MNK_PRESET_COUNT - 1); }
+    else if (screen == "tictactoe-ultimate") { world.state = TICTACTOE; world.ticTacToe.StartDemo(ULTIMATE_VARIANT); }
+    else if (screen == "tictactoe-qubic") { world.state = TICTACTOE; world.ticTacToe.StartDemo(QUBIC_VARIANT); }
+    else if (screen == "space") { world.state = SPACE_SURVIVOR; world.spaceSurvivor.Init(); }
+    else if (screen == "space-open") { world.state = SPACE_SURVIVOR; world.spaceSurvivor.StartOpenField(); }
+    else if (screen == "space-swarm") { world.state = SPACE_SURVIVOR; world.spaceSurvivor.StartSwarm(); }
+    else if (screen == "code") { world.state = BREAK_CODE; world.breakTheCode.Init(); }
+    else if (screen == "zombie") { world.state = ZOMBIE_LAND; world.zombieLand.Init(); }
+    else if (screen == "cards") { world.state = SWAP_CARDS; world.swapCards.Init(); }
+    else if (screen != "menu") { printf("Unknown screen: %s\n", screen.c_str()); return 1; }
+
+    SoftRasterizer canvas;
+    softTarget = &canvas;
+    int failures = 0;
+
+    for (int frame = 0; frame < frames; frame++) {
+        backgroundParticles.Update(FrameDelta());
+        particles.Update(FrameDelta());
+        world.Update();
+
+        canvas.Begin(SCREEN_WIDTH, SCREEN_HEIGHT);
+        world.Draw();
+        canvas.Finish();
+
+        char fileName[512];
+        if (frames > 1) snprintf(fileName, sizeof(fileName), output, frame);
+        else snprintf(fileName, sizeof(fileName), "%s", output);
+        if (!canvas.Write(fileName)) failures++;
+    }
+
+    softTarget = nullptr;
+    chunkStreamer.Stop();
+    mnkAi.Cancel();
+    searchJobs.Stop();
+    jobs.Stop();
+    uiFont.Unload();
+    starfield.Unload();
+    printf("Rendered %d frame(s) of '%s'%s\n", frames, screen.c_str(), failures ? " (some writes failed)" : "");
+    return failures ? 1 : 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NETPLAY
+// ═══════════════════════════════════════════════════════════════════════════
+
+// GamingHub --versus <player 1|2> <local port> <peer ip> <peer port>
+//   Head-to-head Space Survivor against another cabinet, e.g.
+//   "--versus 1 7777 192.168.1.20 7777" on one and "--versus 2 7777 <ip> 7777"
+//   on the other. Two copies on one machine work over 127.0.0.1 with two ports.
+// GamingHub --netplay-test [latency ms] [loss %] [ticks]
+//   Starts two headless peers on this machine that play scripted inputs over
+//   UDP loopback with the given one-way latency (plus up to 20% jitter) and
+//   packet loss, then checks both reached the same state.
+
+const uint16_t NETPLAY_TEST_PORT = 47810;        // And the next port up
+const double NETPLAY_LINGER_MS = 500;            // Keep acknowledging after the end
+const double NETPLAY_TIMEOUT_MS = 60000;
+
+// Scripted buttons for tests: holds a direction (or nothing) for a stretch of
+// ticks that depends on the player and tick, so predictions keep failing
+uint8_t NetplayBotButtons(int player, uint32_t tick) {
+    uint32_t h = FieldHash((uint32_t)player * 0x9E3779B9U ^ FieldHash(tick / (12 + player * 7)));
+    return (uint8_t)(h % 3);
+}
+
+void DrawVersus(const RollbackSession& session, const StarScroll& stars) {
+    const VersusState& s = session.State();
+    const RollbackStats& stats = session.Stats();
+    const Color shipColors[VERSUS_PLAYERS] = {Colors::PRIMARY, Colors::SUCCESS};
+
+    Gfx::Clear({5, 5, 20, 255});
+    starfield.Draw(stars.offsets);
+    DrawList& list = drawQueue.Begin();
+
+    list.layer = LAYER_WORLD;
+    for (int i = 0; i < s.rockCount; i++) {
+        const FallingRock& r = s.rocks[i];
+        list.Sprite(SPRITE_ASTEROID, r.x, r.y, r.size / ASTEROID_SPRITE_RADIUS);
+    }
+    list.layer = LAYER_ACTORS;
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        if (s.ships[p].alive) list.Sprite(SPRITE_SHIP, s.ships[p].x, VERSUS_SHIP_Y - 2.5f, 1.0f, shipColors[p]);
+    }
+
+    list.layer = LAYER_HUD;
+    list.TextCentered("SPACE SURVIVOR VERSUS", 20, 36, Colors::ACCENT);
+    char text[128];
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        snprintf(text, sizeof(text), "P%d%s  wins %d  dodged %d", p + 1, p == session.LocalPlayer() ? " (you)" : "",
+                 s.ships[p].wins, s.ships[p].score);
+        float x = p == 0 ? 20 : SCREEN_WIDTH - 20 - MeasureUIText(text, 20);
+        list.Text(text, x, 65, 20, shipColors[p]);
+    }
+    if (session.Confirmed() == 0) {
+        list.TextCentered("Waiting for the other cabinet...", SCREEN_HEIGHT / 2 - 20, 28, Colors::TEXT_LIGHT);
+    }
+    snprintf(text, sizeof(text), "Round %d  tick %u  ahead %d  rollbacks %d (deepest %d, %.2f ms)  stalls %d",
+             s.round, s.tick, (int)(s.tick - session.Confirmed()), stats.rollbacks, stats.deepest, stats.slowestMs,
+             stats.stalls);
+    list.Text(text, 20, SCREEN_HEIGHT - 55, 14, Colors::TEXT_DIM);
+    list.Text("Controls: A/D or Arrow Keys | ESC: quit", 20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
+
+    list.layer = LAYER_OVERLAY;
+    if (s.winner >= 0) {
+        list.Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, 140});
+        if (s.winner == 2) snprintf(text, sizeof(text), "DRAW");
+        else snprintf(text, sizeof(text), "PLAYER %d TAKES THE ROUND", s.winner + 1);
+        list.TextCentered(text, SCREEN_HEIGHT / 2 - 30, 44, s.winner == 2 ? Colors::TEXT_LIGHT : shipColors[s.winner]);
+    }
+    drawQueue.Submit();
+}
+
+int RunVersus(int argc, char** argv) {
+    int player = (argc > 2) ? atoi(argv[2]) - 1 : -1;
+    if (argc < 6 || (player != 0 && player != 1)) {
+        printf("Usage: %s --versus <1|2> <local port> <peer ip> <peer port>\n", argv[0]);
+        return 1;
+    }
+    UdpLink link;
+    if (!link.Open((uint16_t)atoi(argv[3]), argv[4], (uint16_t)atoi(argv[5]))) {
+        printf("NETPLAY: Could not open UDP port %s for peer %s:%s\n", argv[3], argv[4], argv[5]);
+        return 1;
+    }
+
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "GAMING HUB - Space Survivor Versus");
+    SetTargetFPS(0);
+    framePacer.SetTarget(60);
+    jobs.Start();
+    uiFont.Load();
+    starfield.Load();
+    spriteAtlas.Bake();
+
+    RollbackSession session;
+    session.Start(VERSUS_SEED, player);
+    StarScroll stars;
+    stars.Reset();
+    unsigned char packet[NET_PACKET_MAX + 64];
+
+    // One simulation tick per 60 Hz frame; a stalled tick is simply skipped
+    while (!WindowShouldClose()) {
+        for (int n; (n = link.Receive(packet, sizeof(packet))) > 0; ) session.ReceivePacket(packet, n);
+        uint8_t buttons = 0;
+        if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) buttons |= VERSUS_LEFT;
+        if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) buttons |= VERSUS_RIGHT;
+        session.Advance(buttons);
+        link.Send(packet, session.BuildPacket(packet));
+
+        stars.Advance(1.0f / 60);
+        BeginDrawing();
+        DrawVersus(session, stars);
+        uiFont.EndBatch();
+        EndDrawing();
+        framePacer.Wait();
+    }
+
+    link.Close();
+    jobs.Stop();
+    uiFont.Unload();
+    spriteAtlas.Unload();
+    starfield.Unload();
+    CloseWindow();
+    return 0;
+}
+
+// One side of --netplay-test: plays `ticks` ticks with scripted buttons, waits
+// until both sides hold every input up to there, and prints the final state
+int RunNetplayPeer(int argc, char** argv) {
+    if (argc < 8) return 1;
+    int player = atoi(argv[2]);
+    uint16_t localPort = (uint16_t)atoi(argv[3]), remotePort = (uint16_t)atoi(argv[4]);
+    uint32_t ticks = (uint32_t)max(1, atoi(argv[7]));
+    UdpLink link;
+    if (!link.Open(localPort, "127.0.0.1", remotePort)) {
+        printf("peer %d: could not open UDP port %d\n", player + 1, localPort);
+        return 1;
+    }
+
+    NetConditioner conditioner;
+    conditioner.Seed(1234 + player);
+    conditioner.latencyMs = atof(argv[5]);
+    conditioner.jitterMs = conditioner.latencyMs * 0.2;
+    conditioner.loss = (float)atof(argv[6]) / 100;
+
+    RollbackSession session;
+    session.Start(VERSUS_SEED, player);
+    FramePacer pacer;
+    pacer.SetTarget(60);
+    auto start = chrono::steady_clock::now();
+    unsigned char packet[NET_PACKET_MAX + 64];
+    auto send = [&link](const unsigned char* data, int size) { link.Send(data, size); };
+    double doneAt = -1;
+
+    while (true) {
+        double now = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        for (int n; (n = link.Receive(packet, sizeof(packet))) > 0; ) session.ReceivePacket(packet, n);
+        if (session.Tick() < ticks) session.Advance(NetplayBotButtons(player, session.Tick()));
+        conditioner.Send(now, packet, session.BuildPacket(packet), send);
+        conditioner.Flush(now, send);
+
+        bool done = session.Tick() >= ticks && session.Confirmed() >= ticks && session.Acked() >= ticks;
+        if (done && doneAt < 0) doneAt = now;
+        if (doneAt >= 0 && now - doneAt >= NETPLAY_LINGER_MS) break;
+        if (now > NETPLAY_TIMEOUT_MS) {
+            printf("peer %d: timed out at tick %u (confirmed %u, acked %u)\n", player + 1, session.Tick(),
+                   session.Confirmed(), session.Acked());
+            return 1;
+        }
+        pacer.Wait();
+    }
+
+    session.Resolve();
+    const RollbackStats& stats = session.Stats();
+    printf("peer %d: tick %u checksum %016llx  rollbacks %d  resimulated %d  deepest %d  slowest %.3f ms  "
+           "stalls %d  wins %d-%d\n",
+           player + 1, session.Tick(), (unsigned long long)VersusChecksum(session.State()), stats.rollbacks,
+           stats.resimulated, stats.deepest, stats.slowestMs, stats.stalls, session.State().ships[0].wins,
+           session.State().ships[1].wins);
+    return 0;
+}
+
+int RunNetplayTest(int argc, char** argv) {
+    int latency = (argc > 2) ? atoi(argv[2]) : 60;
+    int loss = (argc > 3) ? atoi(argv[3]) : 10;
+    int ticks = (argc > 4) ? atoi(argv[4]) : 900;
+    printf("netplay: two processes over UDP loopback, %d ms latency, %d%% loss, %d ticks\n", latency, loss, ticks);
+
+    string output[VERSUS_PLAYERS];
+    vector<thread> peers;
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        peers.emplace_back([&, p]() {
+            char command[1024];
+            snprintf(command, sizeof(command), "\"%s\" --netplay-peer %d %d %d %d %d %d", argv[0], p,
+                     NETPLAY_TEST_PORT + p, NETPLAY_TEST_PORT + 1 - p, latency, loss, ticks);
+#if defined(_WIN32)
+            FILE* pipe = _popen(command, "r");
+#else
+            FILE* pipe = popen(command, "r");
+#endif
+            if (!pipe) return;
+            char line[512];
+            while (fgets(line, sizeof(line), pipe)) output[p] += line;
+#if defined(_WIN32)
+            _pclose(pipe);
+#else
+            pclose(pipe);
+#endif
+        });
+    }
+    for (auto& t : peers) t.join();
+
+    // What both should have reached: the same buttons without a network
+    VersusState reference;
+    VersusInit(reference, VERSUS_SEED);
+    while (reference.tick < (uint32_t)max(1, ticks)) {
+        uint8_t buttons[VERSUS_PLAYERS] = {NetplayBotButtons(0, reference.tick), NetplayBotButtons(1, reference.tick)};
+        VersusStep(reference, buttons);
+    }
+
+    unsigned long long checksum[VERSUS_PLAYERS] = {};
+    bool finished = true;
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        printf("  %s", output[p].empty() ? "(no output)\n" : output[p].c_str());
+        size_t at = output[p].find("checksum ");
+        if (at == string::npos) finished = false;
+        else checksum[p] = strtoull(output[p].c_str() + at + 9, nullptr, 16);
+    }
+    bool same = finished && checksum[0] == checksum[1] && checksum[0] == VersusChecksum(reference);
+    printf("  %-4s both peers reached the state of an offline run (%016llx)\n", same ? "ok" : "FAIL",
+           (unsigned long long)VersusChecksum(reference));
+    return same ? 0 : 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BENCHMARKS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// GamingHub --bench <name> [args]
+// Console micro-benchmarks for the engine pieces; no window is opened.
+
+// A bench build (g++ -DCOUNT_ALLOCATIONS ...) counts every heap allocation, so
+// a benchmark can check that a steady-state loop allocates nothing. The game
+// build keeps the standard allocator.
+atomic<long long> heapAllocations{0};
+
+#ifdef COUNT_ALLOCATIONS
+const bool countingAllocations = true;
+
+void* CountedAlloc(size_t size) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size) { return CountedAlloc(size); }
+void* operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+#else
+const bool countingAllocations = false;
+#endif
+
+// Update cost of a pool full of running tweens
+int BenchTweens(int count, int frames) {
+    const int CAPACITY = 10000;
+    count = min(max(count, 1), CAPACITY);
+    static TweenPool<CAPACITY, CAPACITY> pool;     // ~400 KB, kept off the stack
+    pool.Clear();
+    for (int i = 0; i < count; i++) {
+        // Mixed easings and phases so the pass is not one predictable branch
+        pool.PingPong(i, 0, 1, 0.25f + (i % 7) * 0.1f, (Easing)(i % (EASE_OUT_BACK + 1)), -(i % 13) * 0.05f);
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) pool.Update(1.0f / 60.0f, nullptr);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    float checksum = 0;
+    for (int i = 0; i < count; i++) checksum += pool.Value(i);
+    printf("tweens: %d active, %d frames\n", pool.Active(), frames);
+    printf("  %.3f ms per frame, %.2f ns per tween (checksum %.3f)\n",
+           ms / frames, ms * 1e6 / ((double)frames * count), checksum);
+    return 0;
+}
+
+// Known tunneling cases for the swept test, then its cost on a large field.
+// Returns non-zero if any case disagrees with its expected outcome.
+int BenchCollision(int count) {
+    struct Case {
+        const char* name;
+        FallingRock rock;
+        Vector2 shipFrom, shipTo;
+        bool expectHit;
+    };
+    const Vector2 ship = {500, 620};
+    const Case cases[] = {
+        {"fast rock jumps over the ship",   {500, 560, 120, 15}, ship, ship, true},
+        {"fast rock, 30 px off centre",     {530, 540, 160, 15}, ship, ship, true},
+        {"fast rock passes beside",         {540, 540, 160, 15}, ship, ship, false},
+        {"exact graze counts as a miss",    {535, 500, 240, 15}, ship, ship, false},
+        {"ship strafes through a rock",     {500, 620, 0, 15}, {420, 620}, {580, 620}, true},
+        {"rock and ship cross diagonally",  {540, 560, 90, 15}, {470, 620}, {560, 620}, true},
+        {"already overlapping",             {510, 615, 3, 15}, ship, ship, true},
+        {"rock below, falling away",        {500, 660, 20, 15}, ship, ship, false},
+        {"contact just after this tick",    {500, 500, 84, 15}, ship, ship, false},
+        {"contact at the end of this tick", {500, 500, 86, 15}, ship, ship, true},
+        {"slow rock stops short",           {500, 560, 5, 15}, ship, ship, false},
+    };
+
+    int failures = 0;
+    printf("collision: swept circle vs end-of-tick test\n");
+    for (const Case& c : cases) {
+        float toi;
+        bool hit = FirstRockImpact(&c.rock, 1, c.shipFrom, c.shipTo, 20, &toi) >= 0;
+        float ex = c.rock.x - c.shipTo.x, ey = c.rock.y + c.rock.speed - c.shipTo.y;
+        float r = c.rock.size + 20;
+        bool discrete = ex * ex + ey * ey < r * r;
+        bool ok = hit == c.expectHit;
+        if (!ok) failures++;
+        printf("  %-4s %-34s swept %-4s (t=%5.2f)  end-of-tick %s\n", ok ? "ok" : "FAIL", c.name,
+               hit ? "hit" : "miss", toi, discrete ? "hit" : "miss");
+    }
+
+    // Random field: the SIMD pass and the pure scalar solver must agree
+    count = max(count, 4);
+    vector<FallingRock> field(count);
+    srand(7);
+    for (FallingRock& r : field) {
+        r = {(float)(rand() % SCREEN_WIDTH), (float)(rand() % SCREEN_HEIGHT), 3.0f + rand() % 60, 15.0f + rand() % 25};
+    }
+    Vector2 from = {480, 620}, to = {488, 620};
+    int mismatches = 0;
+    for (int i = 0; i + 4 <= count; i += 4) {
+        int scalar = -1;
+        float scalarTime = 2;
+        for (int k = i; k < i + 4; k++) {
+            const FallingRock& r = field[k];
+            float t = SweptCircleTime(r.x - from.x, r.y - from.y, -(to.x - from.x), r.speed, r.size + 20);
+            if (t >= 0 && t < scalarTime) { scalarTime = t; scalar = k - i; }
+        }
+        if (FirstRockImpact(&field[i], 4, from, to, 20) != scalar) mismatches++;
+    }
+    if (mismatches) failures++;
+    printf("  %-4s scalar/batched agreement on %d rocks (%d mismatches)\n", mismatches ? "FAIL" : "ok", count, mismatches);
+
+    // Cost on a field of rocks that mostly miss, like a real frame
+    for (FallingRock& r : field) r.y -= SCREEN_HEIGHT;
+    const int rounds = 200;
+    int hits = 0;
+    auto start = chrono::steady_clock::now();
+    for (int k = 0; k < rounds; k++) hits += FirstRockImpact(field.data(), count, from, to, 20) >= 0;
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    printf("  sweep: %.2f ns per rock over %d rocks (%d hit rounds)\n", ns / ((double)rounds * count), count, hits);
+    return failures ? 1 : 0;
+}
+
+// Separating-axis cases against the ship hull, then how the broadphase scales:
+// update and query cost per tick on fields of growing size, with every query
+// checked against a brute-force scan. Returns non-zero on any failure.
+int BenchPolygons(int count) {
+    struct Case {
+        const char* name;
+        Vector2 rock[4];
+        bool expectHit;
+    };
+    const Vector2 ship = {500, 620};
+    const Case cases[] = {
+        {"square over the nose",           {{490, 580}, {510, 580}, {510, 600}, {490, 600}}, true},
+        {"square resting on the nose",     {{490, 575}, {510, 575}, {510, 595}, {490, 595}}, false},
+        {"square beside the nose",         {{510, 590}, {520, 590}, {520, 600}, {510, 600}}, false},
+        {"square on the left wing",        {{478, 625}, {488, 625}, {488, 635}, {478, 635}}, true},
+        {"diamond off the right flank",    {{530, 595}, {540, 605}, {530, 615}, {520, 605}}, false},
+        {"diamond into the right flank",   {{518, 615}, {528, 625}, {518, 635}, {508, 625}}, true},
+        {"square below the engines",       {{490, 641}, {510, 641}, {510, 660}, {490, 660}}, false},
+    };
+
+    int failures = 0;
+    Vector2 hull[3];
+    for (int i = 0; i < 3; i++) hull[i] = {ship.x + SHIP_HULL[i].x, ship.y + SHIP_HULL[i].y};
+    printf("polygons: separating axis test against the ship hull\n");
+    for (const Case& c : cases) {
+        bool hit = ConvexOverlap(c.rock, 4, hull, 3);
+        float minX = c.rock[0].x, maxX = minX, minY = c.rock[0].y, maxY = minY;
+        for (const Vector2& v : c.rock) {
+            minX = min(minX, v.x); maxX = max(maxX, v.x);
+            minY = min(minY, v.y); maxY = max(maxY, v.y);
         }
+        bool boxes = Aabb{minX, minY, maxX, maxY}.Overlaps(ShipBounds(ship));
+        bool ok = hit == c.expectHit;
+        if (!ok) failures++;
+        printf("  %-4s %-30s SAT %-4s  boxes %s\n", ok ? "ok" : "FAIL", c.name, hit ? "hit" : "miss",
+               boxes ? "overlap" : "apart");
+    }
 
-        for (int i = 0; i < 16; i++) {
-            revealed[i] = matched[i] = false;
+    // Fields of a quarter, a sixteenth... of count rocks at the same density
+    printf("  %8s %7s %12s %14s %10s %10s\n", "rocks", "height", "reinsert/t", "update ns/rock", "query ns",
+           "visited");
+    count = max(count, 64);
+    for (int n = max(64, count / 64); n <= count; n *= 4) {
+        float side = sqrtf((float)n) * 80;
+        vector<FallingRock> rocks(n);
+        vector<RockShape> shapes(n);
+        AabbTree tree;
+        srand(11);
+        for (int i = 0; i < n; i++) {
+            rocks[i] = {(float)(rand() % (int)side), (float)(rand() % (int)side), 1.0f + rand() % 8, 15.0f + rand() % 25};
+            GenerateRockShape(rocks[i].size, (uint32_t)i, shapes[i]);
+            shapes[i].proxy = tree.Insert(RockSweepBounds(rocks[i], shapes[i]), i, {0, rocks[i].speed});
         }
 
-        firstCard = secondCard = -1;
-        matches = moves = 0;
-        gameOver = false;
-        animTime = revealTimer = 0;
-        cardWidth = 120;
-        cardHeight = 150;
-        offsetX = (SCREEN_WIDTH - 4 * cardWidth - 30) / 2;
-        offsetY = 150;
+        const int ticks = 60, queriesPerTick = 64;
+        double updateNs = 0, queryNs = 0;
+        long long visited = 0, candidateCount = 0, overlapping = 0;
+        int reinsertsBefore = tree.Reinserts(), mismatches = 0;
+        vector<int> seen(n, -1), found[2];
+        for (int t = 0; t < ticks; t++) {
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < n; i++) {
+                FallingRock& r = rocks[i];
+                r.y += r.speed;
+                if (r.y > side) r.y -= side;
+                tree.Move(shapes[i].proxy, RockSweepBounds(r, shapes[i]), {0, r.speed});
+            }
+            updateNs += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+            // All of a tick's queries back to back, then the scan that checks them
+            Aabb reach[queriesPerTick];
+            for (Aabb& box : reach) {
+                Vector2 from = {(float)(rand() % (int)side), (float)(rand() % (int)side)};
+                box = ShipBounds(from).Union(ShipBounds({from.x + 8, from.y}));
+            }
+            vector<int>& candidates = found[t & 1];
+            candidates.clear();
+            start = chrono::steady_clock::now();
+            for (int q = 0; q < queriesPerTick; q++) {
+                candidates.push_back(-1 - q);
+                visited += tree.Query(reach[q], [&candidates](int i) {
+                    candidates.push_back(i);
+                    return true;
+                });
+            }
+            auto mid = chrono::steady_clock::now();
+            for (int q = 0, next = 0; q < queriesPerTick; q++) {
+                for (next++; next < (int)candidates.size() && candidates[next] >= 0; next++) seen[candidates[next]] = q;
+                for (int i = 0; i < n; i++) {
+                    if (!RockSweepBounds(rocks[i], shapes[i]).Overlaps(reach[q])) continue;
+                    overlapping++;
+                    if (seen[i] != q) mismatches++;
+                }
+                for (int i = 0; i < n; i++) seen[i] = -1;
+            }
+            queryNs += chrono::duration<double, nano>(mid - start).count();
+            candidateCount += (long long)candidates.size() - queriesPerTick;
+        }
+        int queries = ticks * queriesPerTick;
+        if (mismatches) failures++;
+        printf("  %8d %7d %12.1f %14.1f %10.1f %10.1f  %s (%lld candidates, %lld overlapping)\n", n,
+               tree.Height(), (double)(tree.Reinserts() - reinsertsBefore) / ticks, updateNs / ((double)ticks * n),
+               queryNs / queries, (double)visited / queries, mismatches ? "FAIL" : "ok", candidateCount, overlapping);
     }
+    return failures ? 1 : 0;
+}
 
-    bool Update() {
-        if (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_M)) return true;
+// Space Survivor with weapons at the full fire rate, steered from side to
+// side and restarted whenever the ship dies. Times the simulation tick (the
+// part that spawns and despawns; drawing runs on the render thread) and counts
+// heap allocations after a warm-up in a COUNT_ALLOCATIONS build. Returns
+// non-zero if a tick allocated.
+int BenchShooting(int frames) {
+    srand(3);
+    static SpaceSurvivorGame game{};
+    game.StartWeapons();
+    const int warmup = 600;
+    vector<double> tickMs;
+    tickMs.reserve(frames);
+    long long allocations = 0;
+    int spawnedBefore = 0;
+    auto spawned = []() {
+        return game.Asteroids().Acquired() + game.Projectiles().Acquired() + game.DebrisPool().Acquired();
+    };
 
-        animTime += GetFrameTime();
+    for (int f = 0; f < warmup + frames; f++) {
+        int steer = ((f / 90) % 2) ? KEY_LEFT : KEY_RIGHT;
+        gameInput.BeginTick();
+        gameInput.Apply({INPUT_KEY_UP, KEY_LEFT + KEY_RIGHT - steer, 0, 0});
+        gameInput.Apply({INPUT_KEY_DOWN, steer, 0, 0});
+        gameInput.Apply({INPUT_KEY_DOWN, KEY_SPACE, 0, 0});   // Fires, and restarts after a death
+        if (f == warmup) spawnedBefore = spawned();
+
+        long long before = heapAllocations.load();
+        auto start = chrono::steady_clock::now();
+        game.Update();
+        auto end = chrono::steady_clock::now();
+        if (f < warmup) continue;
+        allocations += heapAllocations.load() - before;
+        tickMs.push_back(chrono::duration<double, milli>(end - start).count());
+    }
 
-        if (gameOver) {
-            if (IsKeyPressed(KEY_SPACE)) Init();
-            return false;
+    double total = 0;
+    for (double ms : tickMs) total += ms;
+    sort(tickMs.begin(), tickMs.end());
+    printf("shooting: %d ticks after %d warm-up, fire every %d ticks\n", frames, warmup, FIRE_INTERVAL);
+    printf("  tick mean %.4f ms  p50 %.4f  p99 %.4f  max %.4f\n", total / frames, tickMs[frames / 2],
+           tickMs[(size_t)frames * 99 / 100], tickMs.back());
+    printf("  %.0f spawns per second\n", (spawned() - spawnedBefore) * 60.0 / frames);
+    printf("  %-12s %5s %5s %9s %8s\n", "pool", "cap", "peak", "spawned", "refused");
+    printf("  %-12s %5d %5d %9d %8d\n", "rocks", ROCK_POOL_SIZE, game.Asteroids().Peak(),
+           game.Asteroids().Acquired(), game.Asteroids().Refused());
+    printf("  %-12s %5d %5d %9d %8d\n", "projectiles", PROJECTILE_POOL_SIZE, game.Projectiles().Peak(),
+           game.Projectiles().Acquired(), game.Projectiles().Refused());
+    printf("  %-12s %5d %5d %9d %8d\n", "debris", DEBRIS_POOL_SIZE, game.DebrisPool().Peak(),
+           game.DebrisPool().Acquired(), game.DebrisPool().Refused());
+    if (!countingAllocations) {
+        printf("  --   heap allocations not counted (build with -DCOUNT_ALLOCATIONS)\n");
+        return 0;
+    }
+    printf("  %-4s %lld heap allocations in %d ticks\n", allocations ? "FAIL" : "ok", allocations, frames);
+    return allocations ? 1 : 0;
+}
+
+// Particle update cost with `count` live particles, topped up with
+// explosions every frame so the kernel and the swap-remove pass both run at
+// full load. Also checks the SIMD kernel against the scalar loop.
+int BenchParticles(int count, int frames) {
+    count = min(max(count, 4), MAX_PARTICLES);
+    static ParticleSystem system;
+    system.Clear();
+    const float dt = 1.0f / 60.0f;
+
+    double integrateMs = 0, spawnMs = 0;
+    long long spawned = 0, live = 0;
+    for (int f = 0; f < frames; f++) {
+        auto start = chrono::steady_clock::now();
+        while (system.Count() < count) {
+            int n = system.Spawn((EffectType)(f % EFFECT_COUNT), (float)(f * 37 % SCREEN_WIDTH), SCREEN_HEIGHT / 2.0f,
+                                 min(1000, count - system.Count()));
+            spawned += n;
         }
+        auto mid = chrono::steady_clock::now();
+        system.Integrate(dt);
+        auto end = chrono::steady_clock::now();
+        spawnMs += chrono::duration<double, milli>(mid - start).count();
+        integrateMs += chrono::duration<double, milli>(end - mid).count();
+        live += system.Count();
+    }
 
-        // Handle reveal timer (when two cards are shown)
-        if (revealTimer > 0) {
-            revealTimer -= GetFrameTime();
-            if (revealTimer <= 0) {
-                if (cards[firstCard] == cards[secondCard]) {
-                    matched[firstCard] = matched[secondCard] = true;
-                    matches++;
-                    if (matches == 8) {
-                        gameOver = true;
-                        ofstream file("swapcards_best_score.txt", ios::app);
-                        if (file.is_open()) {
-                            file << "Completed in " << moves << " moves\n";
-                            file.close();
-                        }
-                    }
+    printf("particles: %d live, %d frames\n", count, frames);
+    printf("  integrate + compact %.3f ms per frame (%.2f ns per particle)\n", integrateMs / frames,
+           integrateMs * 1e6 / (double)live);
+    printf("  spawn %.3f ms per frame (%.0f particles per frame)\n", spawnMs / frames, (double)spawned / frames);
+
+    // The same particles stepped with the SIMD kernel and with the scalar loop
+    int failures = 0;
+#if defined(__SSE2__)
+    static ParticleSystem simd, scalar;
+    simd.Clear();
+    scalar.Clear();
+    simd.Spawn(EFFECT_EXPLOSION, 500, 350, 1001);
+    scalar.Spawn(EFFECT_EXPLOSION, 500, 350, 1001);
+    for (int f = 0; f < 30; f++) {
+        simd.Integrate(dt);
+        scalar.IntegrateScalar(dt);
+    }
+    // Life only ever has dt subtracted, so both keep the same particles. Positions
+    // may differ in the last bits where the compiler fuses the scalar loop's
+    // multiply-adds, so they only have to agree to a hundredth of a pixel each.
+    bool same = simd.Count() == scalar.Count() &&
+                fabs(simd.Checksum() - scalar.Checksum()) <= 0.01 * simd.Count();
+    if (!same) failures++;
+    printf("  %-4s SIMD and scalar kernels agree (%d particles left, checksum %.3f / %.3f)\n", same ? "ok" : "FAIL",
+           simd.Count(), simd.Checksum(), scalar.Checksum());
+#endif
+    return failures ? 1 : 0;
+}
+
+// Layered task graph for BenchJobs(): every node hashes the results of two
+// nodes in the layer before it
+struct BenchNode {
+    uint32_t value;
+    const BenchNode* inputs[2];
+};
+
+void RunBenchNode(const Job& job) {
+    BenchNode& node = *(BenchNode*)job.data;
+    uint32_t v = node.inputs[0] ? node.inputs[0]->value ^ (node.inputs[1]->value << 1) : (uint32_t)job.begin;
+    for (int i = 0; i < 4000; i++) v = FieldHash(v + (uint32_t)i);
+    node.value = v;
+}
+
+// Same work on 1..maxThreads threads; every thread count must give the same
+// checksums as one thread
+int BenchJobs(int maxThreads) {
+    const int rounds = 8, layers = 24, width = 64, emptyJobs = 200000;
+    vector<FieldChunk> field(FIELD_CHUNKS * FIELD_CHUNKS);
+    vector<BenchNode> nodes(layers * width);
+    double baseField = 0, baseGraph = 0;
+    double fieldSum1 = 0;
+    uint32_t graphSum1 = 0;
+    int failures = 0;
+
+    printf("jobs: %d chunk rounds, %dx%d task graph, %d empty jobs\n", rounds, layers, width, emptyJobs);
+    printf("  threads  chunks ms  speedup   graph ms  speedup   ns/job  check\n");
+    for (int threads = 1; threads <= maxThreads; threads++) {
+        jobs.Start(threads - 1);
+
+        // parallel_for: regenerate the whole open field
+        auto start = chrono::steady_clock::now();
+        double fieldSum = 0;
+        for (int r = 0; r < rounds; r++) {
+            jobs.ParallelFor((int)field.size(), 16, [&](int begin, int end) {
+                for (int i = begin; i < end; i++) GenerateFieldChunk(i % FIELD_CHUNKS, i / FIELD_CHUNKS, r + 1, field[i]);
+            });
+            for (const FieldChunk& c : field) {
+                for (int k = 0; k < c.count; k++) fieldSum += c.rocks[k].x + c.rocks[k].y;
+            }
+        }
+        auto mid = chrono::steady_clock::now();
+
+        // Dependency graph: each layer waits for the two nodes above it
+        vector<Job*> graph(nodes.size());
+        Job* root = jobs.Create(nullptr);
+        for (int l = 0; l < layers; l++) {
+            for (int i = 0; i < width; i++) {
+                BenchNode& node = nodes[l * width + i];
+                node.inputs[0] = l ? &nodes[(l - 1) * width + i] : nullptr;
+                node.inputs[1] = l ? &nodes[(l - 1) * width + (i + 1) % width] : nullptr;
+                Job* job = jobs.Create(RunBenchNode, &node, root);
+                job->begin = i;
+                if (l) {
+                    jobs.AddDependency(job, graph[(l - 1) * width + i]);
+                    jobs.AddDependency(job, graph[(l - 1) * width + (i + 1) % width]);
                 }
-                revealed[firstCard] = revealed[secondCard] = false;
-                firstCard = secondCard = -1;
+                graph[l * width + i] = job;
             }
-            return false;
         }
+        for (Job* job : graph) jobs.Submit(job);
+        jobs.Submit(root);
+        jobs.Wait(root);
+        uint32_t graphSum = 0;
+        for (int i = 0; i < width; i++) graphSum ^= nodes[(layers - 1) * width + i].value * (uint32_t)(i + 1);
+        auto end = chrono::steady_clock::now();
+
+        // Scheduling overhead: jobs that do nothing
+        Job* group = jobs.Create(nullptr);
+        for (int i = 0; i < emptyJobs; i++) jobs.Submit(jobs.Create(nullptr, nullptr, group));
+        jobs.Submit(group);
+        jobs.Wait(group);
+        auto done = chrono::steady_clock::now();
+
+        double fieldMs = chrono::duration<double, milli>(mid - start).count();
+        double graphMs = chrono::duration<double, milli>(end - mid).count();
+        double jobNs = chrono::duration<double, nano>(done - end).count() / emptyJobs;
+        if (threads == 1) {
+            baseField = fieldMs;
+            baseGraph = graphMs;
+            fieldSum1 = fieldSum;
+            graphSum1 = graphSum;
+        }
+        bool same = fieldSum == fieldSum1 && graphSum == graphSum1;
+        if (!same) failures++;
+        printf("  %7d  %9.2f  %6.2fx  %9.2f  %6.2fx  %7.1f  %s\n", threads, fieldMs, baseField / fieldMs, graphMs,
+               baseGraph / graphMs, jobNs, same ? "ok" : "FAIL");
+    }
+    jobs.Stop();
+    return failures ? 1 : 0;
+}
 
-        // Card selection
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            Vector2 mouse = GetMousePosition();
+// The swarm on 1..maxThreads threads with the ship on a fixed path. Every
+// thread count must end in the same state, with the same hits on the way.
+int BenchSwarm(int count, int ticks, int maxThreads) {
+    vector<FallingRock> visible;
+    double baseMs = 0;
+    uint64_t baseState = 0, baseEvents = 0;
+    int failures = 0;
+
+    printf("swarm: %d asteroids, %d partitions, %d ticks\n", max(count, 1), SWARM_PARTITIONS, ticks);
+    printf("  threads  ms/tick  ns/rock  speedup  hits  state checksum      check\n");
+    for (int threads = 1; threads <= maxThreads; threads++) {
+        jobs.Start(threads - 1);
+        asteroidSwarm.Init(count, 12345);
+        uint64_t events = 0;
+        int hits = 0;
+        Vector2 ship = {SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT - 80.0f};
+
+        auto start = chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            Vector2 from = ship;
+            ship.x = SCREEN_WIDTH / 2.0f + sinf(t * 0.05f) * 400;
+            SwarmStep step = asteroidSwarm.Step(from, ship, visible);
+            events = events * 31 + (uint64_t)step.passed;
+            if (step.hitRock >= 0) {
+                events = events * 31 + (uint64_t)step.hitRock;
+                hits++;
+            }
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
 
-            for (int i = 0; i < 16; i++) {
-                if (matched[i] || revealed[i]) continue;
+        uint64_t state = asteroidSwarm.Checksum();
+        if (threads == 1) {
+            baseMs = ms;
+            baseState = state;
+            baseEvents = events;
+        }
+        bool same = state == baseState && events == baseEvents;
+        if (!same) failures++;
+        printf("  %7d  %7.3f  %7.3f  %6.2fx  %4d  %016llx  %s\n", threads, ms / ticks,
+               ms * 1e6 / ticks / asteroidSwarm.Count(), baseMs / ms, hits, (unsigned long long)state,
+               same ? "ok" : "FAIL");
+    }
+    jobs.Stop();
+    return failures ? 1 : 0;
+}
 
-                int row = i / 4, col = i % 4;
-                Rectangle card = {offsetX + col * (cardWidth + 10), offsetY + row * (cardHeight + 10),
-                                  cardWidth, cardHeight};
+// Runs the wave schedule at several tick rates. Each wave must spawn the same
+// number of rocks at every rate, give or take one spawn group, and the cost
+// per tick must not grow with the wave count.
+int BenchWaves(float seconds) {
+    const int rates[] = {30, 60, 144, 240, 0};          // 0: uneven ticks between 4 and 40 ms
+    int waveCount = waveSchedule.Count();
+    vector<int> baseline;
+    int failures = 0;
+    srand(7);
+
+    printf("waves: %d waves, %.0f s of play per rate\n", waveCount, seconds);
+    printf("  rate     ticks     ns/tick  spawns per wave\n");
+    for (int rate : rates) {
+        WaveDirector director;
+        director.Reset();
+        vector<int> spawned(waveCount, 0);
+        WaveSpawn spawns[WAVE_MAX_SPAWNS];
+        long long ticks = 0;
+        double ns = 0;
+        for (float t = 0; t < seconds; ticks++) {
+            float dt = rate ? 1.0f / rate : (4 + rand() % 37) / 1000.0f;
+            auto start = chrono::steady_clock::now();
+            int n = director.Update(dt, SCREEN_WIDTH / 2.0f, spawns, WAVE_MAX_SPAWNS);
+            ns += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+            spawned[director.WaveNumber() - 1] += n;
+            t += dt;
+        }
+        if (baseline.empty()) baseline = spawned;
+
+        bool same = true;
+        string counts;
+        for (int w = 0; w < waveCount; w++) {
+            int tolerance = WAVE_PATTERN_GROUP[waveSchedule[w].pattern];
+            if (abs(spawned[w] - baseline[w]) > tolerance) same = false;
+            counts += to_string(spawned[w]) + " ";
+        }
+        if (!same) failures++;
+        char label[16];
+        if (rate) snprintf(label, sizeof(label), "%d Hz", rate);
+        else snprintf(label, sizeof(label), "uneven");
+        printf("  %-7s  %6lld  %9.1f  %s %s\n", label, ticks, ns / ticks, counts.c_str(), same ? "ok" : "FAIL");
+    }
+    return failures ? 1 : 0;
+}
 
-                if (CheckCollisionPointRec(mouse, card)) {
-                    revealed[i] = true;
+// Random games on every preset board. Each move's incremental check is
+// compared against a full scan of the board, then the same games are
+// replayed with the clock running to get the cost of one Place, win check included.
+template <int MAX_SIDE>
+int BenchMnkRules(const MnkRules& rules, int games, const char* label) {
+    int cells = rules.rows * rules.cols;
+    vector<int> order(cells);
+    vector<vector<int>> plays(games);
+    for (int g = 0; g < games; g++) {
+        for (int i = 0; i < cells; i++) order[i] = i;
+        for (int i = cells - 1; i > 0; i--) swap(order[i], order[rand() % (i + 1)]);
+        plays[g] = order;
+    }
 
-                    if (firstCard < 0) {
-                        firstCard = i;
-                    } else {
-                        secondCard = i;
-                        moves++;
-                        revealTimer = 1.0f;  // Show for 1 second
+    // Check every move against a scan of all k-long lines on a plain grid
+    MnkBoard<MAX_SIDE> board;
+    vector<int> grid(cells);
+    const int steps[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    int mismatches = 0, wins = 0;
+    long long moves = 0;
+    for (int g = 0; g < games; g++) {
+        board.Reset(rules.rows, rules.cols, rules.k);
+        fill(grid.begin(), grid.end(), -1);
+        for (int m = 0; m < cells; m++) {
+            int player = m & 1, r = plays[g][m] / rules.cols, c = plays[g][m] % rules.cols;
+            bool won = board.Place(player, r, c);
+            grid[plays[g][m]] = player;
+            bool scanned = false;
+            for (int y = 0; y < rules.rows && !scanned; y++) {
+                for (int x = 0; x < rules.cols && !scanned; x++) {
+                    for (const auto& d : steps) {
+                        int n = 0;
+                        while (n < rules.k) {
+                            int yy = y + d[0] * n, xx = x + d[1] * n;
+                            if (yy >= rules.rows || xx < 0 || xx >= rules.cols || grid[yy * rules.cols + xx] != player) break;
+                            n++;
+                        }
+                        if (n == rules.k) scanned = true;
                     }
-                    break;
                 }
             }
+            moves++;
+            if (won != scanned) mismatches++;
+            if (won) {
+                wins++;
+                break;
+            }
         }
-
-        return false;
     }
 
-    void Draw() {
-        DrawAnimatedBackground(animTime);
-
-        DrawTextCentered("SWAP CARDS", 30, 40, Colors::ACCENT);
+    // Time the same games: one Place per move until someone wins
+    int sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int g = 0; g < games; g++) {
+        board.Reset(rules.rows, rules.cols, rules.k);
+        for (int m = 0; m < cells; m++) {
+            if (board.Place(m & 1, plays[g][m] / rules.cols, plays[g][m] % rules.cols)) {
+                sink += m;
+                break;
+            }
+        }
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    printf("  %-22s %2d x %-2d k=%d  %2d words  %6.2f ns/move  %5.1f moves/game  %3.0f%% decided  %s\n", label,
+           rules.rows, rules.cols, rules.k, MnkBoard<MAX_SIDE>::WORDS, ns / max(moves, 1LL),
+           (double)moves / games, 100.0 * wins / games, mismatches ? "FAIL" : "ok");
+    if (sink < 0) printf("%d\n", sink);
+    return mismatches;
+}
 
-        char statsText[64];
-        sprintf(statsText, "Moves: %d  |  Matches: %d/8", moves, matches);
-        DrawTextCentered(statsText, 80, 24, Colors::TEXT_LIGHT);
+int BenchMnk(int games) {
+    srand(11);
+    printf("mnk: %d random games per board, every win check compared with a full scan\n", games);
+    int failures = BenchMnkRules<3>(MNK_PRESETS[0], games, "Tic-Tac-Toe (3x3 store)");
+    for (int i = 0; i < MNK_PRESET_COUNT; i++) {
+        failures += BenchMnkRules<MNK_MAX_SIDE>(MNK_PRESETS[i], games, MNK_PRESETS[i].name);
+    }
+    return failures ? 1 : 0;
+}
 
-        // Draw cards
-        for (int i = 0; i < 16; i++) {
-            int row = i / 4, col = i % 4;
-            Rectangle card = {offsetX + col * (cardWidth + 10), offsetY + row * (cardHeight + 10),
-                              cardWidth, cardHeight};
+// Search on fixed positions with 1 to maxThreads threads. The tactical ones
+// must come out right on every thread count and every search must answer
+// within its budget; the others show nodes per second per thread.
+int BenchSearch(int budgetMs, int maxThreads) {
+    struct Position {
+        const char* name;
+        int k;
+        int player;
+        vector<string> rows;
+        int expectMove;          // -1: none; -2: the score must be a forced win; -3: a draw
+    };
+    vector<string> gomoku(15, string(15, '.'));
+    vector<string> win = gomoku, block = gomoku, opening = gomoku, middle(19, string(19, '.'));
+    win[7].replace(4, 5, "OXXXX");
+    win[8].replace(5, 3, "OOO");
+    block[7].replace(4, 5, "OXXXX");
+    block[8].replace(5, 3, "OO.");
+    block[6][6] = 'O';
+    opening[7].replace(6, 3, "XO.");
+    opening[8].replace(6, 3, ".X.");
+    opening[6][8] = 'O';
+    const char* pattern[] = {"...O...", "..XX...", "..OXO..", "...O...", "..X...."};
+    for (int r = 0; r < 5; r++) middle[7 + r].replace(6, 7, pattern[r]);
+    vector<Position> positions = {
+        {"3x3 solve", 3, 0, {"...", "...", "..."}, -3},
+        {"15x15 win in 1", 5, 0, win, -2},
+        {"15x15 must block", 5, 1, block, 7 * 15 + 9},
+        {"15x15 opening", 5, 1, opening, -1},
+        {"19x19 middle game", 5, 0, middle, -1},
+    };
 
-            Vector2 mouse = GetMousePosition();
-            bool hover = CheckCollisionPointRec(mouse, card) && !matched[i] && !revealed[i];
+    vector<MnkBoard<MNK_MAX_SIDE>> boards(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        const Position& p = positions[i];
+        int rows = (int)p.rows.size(), cols = (int)p.rows[0].size();
+        boards[i].Reset(rows, cols, p.k);
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                if (p.rows[r][c] != '.') boards[i].Place(p.rows[r][c] == 'X' ? 0 : 1, r, c);
+            }
+        }
+    }
 
-            if (matched[i]) {
-                // Matched card - green
-                DrawRectangleRounded(card, 0.1f, 8, Colors::SUCCESS);
-                char symbol[2] = {cards[i], 0};
-                DrawText(symbol, card.x + cardWidth/2 - 15, card.y + cardHeight/2 - 20, 50, WHITE);
-            } else if (revealed[i]) {
-                // Revealed card - gold
-                DrawRectangleRounded(card, 0.1f, 8, Colors::ACCENT);
-                char symbol[2] = {cards[i], 0};
-                DrawText(symbol, card.x + cardWidth/2 - 15, card.y + cardHeight/2 - 20, 50, BLACK);
+    printf("search: %d ms per move, 1 to %d threads\n", budgetMs, maxThreads);
+    printf("  %-18s %7s %5s %10s %10s %12s %5s %11s %6s\n", "position", "threads", "depth", "nodes", "knodes/s",
+           "per thread", "move", "score", "ms");
+    int failures = 0;
+    atomic<bool> stop;
+    for (int threads = 1; threads <= maxThreads; threads = (threads < maxThreads) ? min(threads * 2, maxThreads) : threads + 1) {
+        searchJobs.Start(threads - 1);
+        for (size_t i = 0; i < positions.size(); i++) {
+            const Position& p = positions[i];
+            const MnkBoard<MNK_MAX_SIDE>& board = boards[i];
+            int rows = board.Rows(), cols = board.Cols();
+            stop = false;
+            MnkSearchResult result = MnkSearch(board, p.player, budgetMs, threads, stop);
+            bool ok = result.move >= 0 && result.ms <= budgetMs * 1.1 + 5;
+            if (p.expectMove >= 0) ok = ok && result.move == p.expectMove;
+            if (p.expectMove == -2) ok = ok && result.score > MNK_WIN_BOUND;
+            if (p.expectMove == -3) ok = ok && result.score == 0 && result.depth == rows * cols;
+            if (!ok) failures++;
+            char score[24];
+            if (abs(result.score) > MNK_WIN_BOUND) {
+                snprintf(score, sizeof(score), "%s in %d", result.score > 0 ? "win" : "loss", MNK_WIN - abs(result.score));
             } else {
-                // Hidden card
-                Color cardColor = hover ? Colors::CARD_HOVER : Colors::CARD_BG;
-                DrawRectangleRounded(card, 0.1f, 8, cardColor);
-                DrawRectangleRoundedLines(card, 0.1f, 8, 2, Colors::PRIMARY);
-                DrawText("?", card.x + cardWidth/2 - 12, card.y + cardHeight/2 - 20, 50, Colors::PRIMARY);
+                snprintf(score, sizeof(score), "%d", result.score);
             }
+            double knps = result.nodes / max(result.ms, 0.001);
+            printf("  %-18s %7d %5d %10lld %10.0f %12.0f %2d,%-2d %11s %6.1f %s\n", p.name, threads, result.depth,
+                   result.nodes, knps, knps / threads, result.move / cols, result.move % cols, score, result.ms,
+                   ok ? "ok" : "FAIL");
         }
+        searchJobs.Stop();
+    }
+    return failures ? 1 : 0;
+}
 
-        // Game over
-        if (gameOver) {
-            DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, 180});
-            DrawTextCentered("CONGRATULATIONS!", SCREEN_HEIGHT/2 - 60, 50, Colors::SUCCESS);
-            sprintf(statsText, "Completed in %d moves!", moves);
-            DrawTextCentered(statsText, SCREEN_HEIGHT/2, 30, Colors::ACCENT);
-            DrawTextCentered("Press SPACE to play again", SCREEN_HEIGHT/2 + 50, 20, Colors::TEXT_DIM);
+// MCTS against itself and against alpha-beta. Playouts per second on an
+// empty 15x15 board and on a win in 1 it must find, for 1 to maxThreads
+// threads; then games against alpha-beta with the same budget and threads,
+// each side taking X in half of them.
+int BenchMcts(int games, int budgetMs, int maxThreads) {
+    MnkBoard<MNK_MAX_SIDE> empty, win;
+    empty.Reset(15, 15, 5);
+    win.Reset(15, 15, 5);
+    const char* winRows[] = {"OXXXX", ".OOO."};
+    for (int r = 0; r < 2; r++) {
+        for (int c = 0; c < 5; c++) {
+            if (winRows[r][c] != '.') win.Place(winRows[r][c] == 'X' ? 0 : 1, 7 + r, 4 + c);
         }
-
-        DrawText("Click cards to flip | Press M to return to menu",
-                 20, SCREEN_HEIGHT - 30, 16, Colors::TEXT_DIM);
     }
-};
 
-// ═══════════════════════════════════════════════════════════════════════════
-// MAIN MENU AND GAME LOOP
-// ═══════════════════════════════════════════════════════════════════════════
+    printf("mcts: %d ms per move, 1 to %d threads\n", budgetMs, maxThreads);
+    printf("  %-16s %7s %10s %12s %12s %5s %6s %6s\n", "position", "threads", "playouts", "playouts/s", "per thread",
+           "move", "depth", "ms");
+    int failures = 0;
+    atomic<bool> stop{false};
+    for (int threads = 1; threads <= maxThreads; threads = (threads < maxThreads) ? min(threads * 2, maxThreads) : threads + 1) {
+        searchJobs.Start(threads - 1);
+        for (int p = 0; p < 2; p++) {
+            MnkSearchResult result = MctsSearch(p ? win : empty, 0, budgetMs, threads, stop);
+            bool ok = result.move >= 0 && result.ms <= budgetMs * 1.1 + 5 && (p == 0 || result.move == 7 * 15 + 9);
+            if (!ok) failures++;
+            double rate = result.nodes * 1000.0 / max(result.ms, 0.001);
+            printf("  %-16s %7d %10lld %12.0f %12.0f %2d,%-2d %6d %6.1f %s\n", p ? "15x15 win in 1" : "15x15 empty",
+                   threads, result.nodes, rate, rate / threads, result.move / 15, result.move % 15, result.depth,
+                   result.ms, ok ? "ok" : "FAIL");
+        }
+        searchJobs.Stop();
+    }
 
-// Menu button structure
-struct MenuButton {
-    const char* title;
-    const char* description;
-    Color color;
-};
+    searchJobs.Start(maxThreads - 1);
+    const int sizes[] = {2, 4, 5};                       // 5x5 k4, 9x9 k5, Gomoku 15x15
+    printf("  versus alpha-beta, %d games per board (wins / draws / losses for MCTS)\n", games);
+    for (int preset : sizes) {
+        const MnkRules& rules = MNK_PRESETS[preset];
+        int wins = 0, draws = 0, losses = 0;
+        long long playouts = 0;
+        double mctsMs = 0;
+        for (int g = 0; g < games; g++) {
+            int mctsPlayer = g & 1;
+            MnkBoard<MNK_MAX_SIDE> board;
+            board.Reset(rules.rows, rules.cols, rules.k);
+            int winner = -1;
+            for (int player = 0; !board.Full(); player = 1 - player) {
+                stop = false;
+                MnkSearchResult result = (player == mctsPlayer) ? MctsSearch(board, player, budgetMs, maxThreads, stop)
+                                                                : MnkSearch(board, player, budgetMs, maxThreads, stop);
+                if (player == mctsPlayer) {
+                    playouts += result.nodes;
+                    mctsMs += result.ms;
+                }
+                if (result.move < 0) break;
+                if (board.Place(player, result.move / rules.cols, result.move % rules.cols)) {
+                    winner = player;
+                    break;
+                }
+            }
+            if (winner < 0) draws++;
+            else if (winner == mctsPlayer) wins++;
+            else losses++;
+        }
+        printf("  %-18s %2d / %2d / %2d   %.0f playouts/s\n", rules.name, wins, draws, losses,
+               playouts * 1000.0 / max(mctsMs, 0.001));
+    }
+    searchJobs.Stop();
+    return failures ? 1 : 0;
+}
 
-// Draw animated title
-void DrawTitle(float time) {
-    const char* title = "GAMING HUB";
-    int fontSize = 70;
-    int width = MeasureText(title, fontSize);
-    float x = (SCREEN_WIDTH - width) / 2.0f;
-    float y = 80 + sin(time * 2) * 5;
+// Ultimate Tic-Tac-Toe. Random games are checked move by move against a
+// plain 81-cell grid that rescans every board (legal moves and results),
+// then replayed with the clock running for the cost of Generate plus Play;
+// last, the search on the opening and a middle game within budgetMs.
+int BenchUltimate(int games, int budgetMs) {
+    srand(17);
+    printf("ultimate: %d random games checked against a full scan\n", games);
+    auto boardOwner = [](const int* grid, int board) {
+        static const int lines[8][3] = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}, {0, 3, 6}, {1, 4, 7}, {2, 5, 8}, {0, 4, 8}, {2, 4, 6}};
+        for (const auto& l : lines) {
+            int a = grid[board * 9 + l[0]];
+            if (a >= 0 && a == grid[board * 9 + l[1]] && a == grid[board * 9 + l[2]]) return a;
+        }
+        return -1;
+    };
 
-    // Shadow
-    DrawText(title, x + 4, y + 4, fontSize, (Color){0, 0, 0, 100});
-    // Main text with gradient effect
-    DrawText(title, x, y, fontSize, Colors::ACCENT);
+    vector<vector<uint8_t>> plays(games);
+    int mismatches = 0, decided[3] = {0, 0, 0};
+    long long moves = 0;
+    for (int g = 0; g < games; g++) {
+        UltimateBoard board;
+        board.Reset();
+        int grid[81];
+        fill(grid, grid + 81, -1);
+        int next = -1;
+        while (board.result < 0) {
+            // Reference: a board is closed once won or full; the last cell picks the next board
+            int owner[9], meta[9];
+            bool closed[9], any = false;
+            for (int b = 0; b < 9; b++) {
+                owner[b] = boardOwner(grid, b);
+                bool full = true;
+                for (int c = 0; c < 9; c++) full = full && grid[b * 9 + c] >= 0;
+                closed[b] = owner[b] >= 0 || full;
+                meta[b] = owner[b];
+            }
+            int winner = boardOwner(meta, 0);
+            for (int b = 0; b < 9; b++) any = any || !closed[b];
+            vector<uint8_t> expected;
+            for (int b = 0; b < 9 && winner < 0; b++) {
+                if (closed[b] || (next >= 0 && !closed[next] && b != next)) continue;
+                for (int c = 0; c < 9; c++) {
+                    if (grid[b * 9 + c] < 0) expected.push_back((uint8_t)(b * 9 + c));
+                }
+            }
+            uint8_t list[81];
+            int count = board.Generate(list);
+            sort(list, list + count);
+            if (count != (int)expected.size() || !equal(list, list + count, expected.begin()) || !any) {
+                mismatches++;
+                break;
+            }
+            int move = list[rand() % count];
+            grid[move] = board.toMove;
+            next = move % 9;
+            board.Play(move);
+            plays[g].push_back((uint8_t)move);
+            moves++;
+        }
+        // The final result must match the scan too
+        int meta[9];
+        bool allClosed = true;
+        for (int b = 0; b < 9; b++) {
+            meta[b] = boardOwner(grid, b);
+            bool full = true;
+            for (int c = 0; c < 9; c++) full = full && grid[b * 9 + c] >= 0;
+            allClosed = allClosed && (meta[b] >= 0 || full);
+        }
+        int winner = boardOwner(meta, 0);
+        if (winner != (board.result == 2 ? -1 : board.result) || (winner < 0 && !allClosed)) mismatches++;
+        decided[board.result == 2 ? 2 : board.result]++;
+    }
 
-    // Subtitle
-    DrawTextCentered("Professional C++ Arcade", 160, 24, Colors::TEXT_DIM);
-    DrawTextCentered("First Semester Project", 190, 18, Colors::TEXT_DIM);
+    // Time the same games: list the moves, then play the recorded one
+    int sink = 0;
+    uint8_t list[81];
+    auto start = chrono::steady_clock::now();
+    for (int g = 0; g < games; g++) {
+        UltimateBoard board;
+        board.Reset();
+        for (uint8_t move : plays[g]) {
+            sink += board.Generate(list);
+            board.Play(move);
+        }
+        sink += board.result;
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    printf("  %6.2f ns/move (Generate + Play)  %4.1f moves/game  X %d / O %d / draw %d  %s\n", ns / max(moves, 1LL),
+           (double)moves / max(games, 1), decided[0], decided[1], decided[2], mismatches ? "FAIL" : "ok");
+    if (sink < 0) printf("%d\n", sink);
+
+    // Search within its budget from the opening and after 20 random moves
+    int failures = mismatches;
+    atomic<bool> stop{false};
+    UltimateBoard positions[2];
+    positions[0].Reset();
+    positions[1].Reset();
+    while (positions[1].played < 20 && positions[1].result < 0) positions[1].Play(list[rand() % positions[1].Generate(list)]);
+    for (int p = 0; p < 2; p++) {
+        stop = false;
+        MnkSearchResult result = UltimateSearch(positions[p], budgetMs, stop);
+        bool ok = positions[p].result >= 0 || (positions[p].Legal(result.move) && result.ms <= budgetMs * 1.1 + 5);
+        if (!ok) failures++;
+        printf("  search %-11s depth %2d  %9lld nodes  %9.0f nodes/s  move %2d  %6.1f ms  %s\n",
+               p ? "middle game" : "opening", result.depth, result.nodes, result.nodes * 1000.0 / max(result.ms, 0.001),
+               result.move, result.ms, ok ? "ok" : "FAIL");
+    }
+    return failures ? 1 : 0;
 }
 
-// Main function
-int main() {
-    // Initialize
-    srand(time(0));
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "GAMING HUB - Professional C++ Arcade");
-    SetTargetFPS(60);
-
-    GameState currentState = MENU;
-    float animTime = 0;
-
-    // Game instances
-    TicTacToeGame ticTacToe;
-    SpaceSurvivorGame spaceSurvivor;
-    BreakTheCodeGame breakTheCode;
-    ZombieLandGame zombieLand;
-    SwapCardsGame swapCards;
-
-    // Menu buttons
-    MenuButton buttons[5] = {
-        {"Tic-Tac-Toe", "Classic 2-Player Strategy Game", Colors::SUCCESS},
-        {"Space Survivor", "Dodge Asteroids in Space", Colors::PRIMARY},
-        {"Break The Code", "Mastermind Puzzle Challenge", Colors::ACCENT},
-        {"Escape Zombie Land", "Survive the Zombie Apocalypse", Colors::DANGER},
-        {"Swap Cards", "Test Your Memory Skills", Colors::SECONDARY}
+// Qubic. The line tables are checked for 76 distinct 4-cell lines, then
+// random games are checked move by move against a scan of a plain 4x4x4
+// grid (legal moves and results) and replayed with the clock running, for
+// Generate plus Play and for one win check. Last, the threat search on fixed
+// positions within budgetMs, and games against a random player and itself in
+// which every forced win it announces has to come true.
+const double QUBIC_BUDGET_NS = 100;         // Per Generate + Play, and per win check
+
+int BenchQubic(int games, int budgetMs) {
+    srand(19);
+    int failures = 0, sevens = 0, cellLines = 0;
+    for (int i = 0; i < qubicTables.lineCount; i++) {
+        int bits = 0;
+        for (int cell = 0; cell < 64; cell++) bits += (int)(qubicTables.lines[i] >> cell & 1);
+        for (int j = 0; j < i; j++) failures += (qubicTables.lines[j] == qubicTables.lines[i]);
+        failures += (bits != 4);
+    }
+    for (int cell = 0; cell < 64; cell++) {
+        cellLines += qubicTables.cellLineCount[cell];
+        sevens += (qubicTables.cellLineCount[cell] == 7);
+    }
+    failures += (qubicTables.lineCount != QUBIC_LINE_COUNT) + (cellLines != 4 * QUBIC_LINE_COUNT) + (sevens != 16);
+    printf("qubic: %d lines, %d cells on 7 of them  %s\n", qubicTables.lineCount, sevens, failures ? "FAIL" : "ok");
+
+    // Reference: every direction from every cell of a plain grid
+    auto scanWin = [](const int* grid, int player) {
+        for (int start = 0; start < 64; start++) {
+            for (int d = 1; d < 27; d++) {
+                int dz = d / 9 - 1, dy = d / 3 % 3 - 1, dx = d % 3 - 1, n = 0;
+                if (!dz && !dy && !dx) continue;
+                int z = start / 16, y = start / 4 % 4, x = start % 4;
+                while (n < 4 && z >= 0 && z < 4 && y >= 0 && y < 4 && x >= 0 && x < 4 && grid[z * 16 + y * 4 + x] == player) {
+                    n++;
+                    z += dz;
+                    y += dy;
+                    x += dx;
+                }
+                if (n == 4) return true;
+            }
+        }
+        return false;
     };
+    vector<vector<uint8_t>> plays(games);
+    int mismatches = 0, decided[3] = {0, 0, 0};
+    long long moves = 0;
+    for (int g = 0; g < games; g++) {
+        QubicBoard board;
+        board.Reset();
+        int grid[64];
+        fill(grid, grid + 64, -1);
+        while (board.result < 0) {
+            uint8_t list[64];
+            int count = board.Generate(list), expected = 0;
+            for (int cell = 0; cell < 64; cell++) {
+                if (grid[cell] < 0 && (expected >= count || list[expected++] != cell)) mismatches++;
+            }
+            if (count != expected) mismatches++;
+            int move = list[rand() % count], player = board.toMove;
+            grid[move] = player;
+            board.Play(move);
+            plays[g].push_back((uint8_t)move);
+            moves++;
+            bool won = scanWin(grid, player);
+            if (won != (board.result == player) || (!won && (board.result >= 0) != (board.played == 64))) mismatches++;
+            if (won && (qubicTables.lines[board.winLine] & ~board.marks[player])) mismatches++;
+        }
+        decided[board.result]++;
+    }
 
-    // Main game loop
-    while (!WindowShouldClose()) {
-        animTime += GetFrameTime();
-
-        // Update based on state
-        switch (currentState) {
-            case MENU: {
-                // Check button clicks
-                float buttonY = 250;
-                float buttonWidth = 350;
-                float buttonHeight = 70;
-                float buttonX = (SCREEN_WIDTH - buttonWidth) / 2;
-
-                for (int i = 0; i < 5; i++) {
-                    Rectangle btn = {buttonX, buttonY + i * 80, buttonWidth, buttonHeight};
-                    Vector2 mouse = GetMousePosition();
+    // Time the same games: list the moves, then play the recorded one
+    int sink = 0;
+    uint8_t list[64];
+    auto start = chrono::steady_clock::now();
+    for (int g = 0; g < games; g++) {
+        QubicBoard board;
+        board.Reset();
+        for (uint8_t move : plays[g]) {
+            sink += board.Generate(list);
+            board.Play(move);
+        }
+        sink += board.result;
+    }
+    double moveNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / max(moves, 1LL);
+    // And the win check alone, for both players on every empty cell along the way
+    long long checks = 0;
+    start = chrono::steady_clock::now();
+    for (int g = 0; g < games; g++) {
+        QubicBoard board;
+        board.Reset();
+        for (uint8_t move : plays[g]) {
+            for (uint64_t open = board.Empty(); open; open &= open - 1) {
+                int cell = qubicTables.Lowest(open);
+                sink += board.Completes(0, cell) + board.Completes(1, cell);
+                checks += 2;
+            }
+            board.Play(move);
+        }
+    }
+    double checkNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / max(checks, 1LL);
+    printf("  %6.2f ns/move (Generate + Play)  %5.2f ns/win check  %4.1f moves/game  X %d / O %d / draw %d  %s\n",
+           moveNs, checkNs, (double)moves / max(games, 1), decided[0], decided[1], decided[2], mismatches ? "FAIL" : "ok");
+    if (sink == -1) printf("%d\n", sink);
+    failures += mismatches;
+    bool fast = moveNs < QUBIC_BUDGET_NS && checkNs < QUBIC_BUDGET_NS;
+    if (!fast) failures++;
+    printf("  %-4s under %.0f ns per move and per win check\n", fast ? "ok" : "FAIL", QUBIC_BUDGET_NS);
+
+    // Fixed positions on the bottom layer, rows top to bottom
+    struct Position {
+        const char* name;
+        const char* rows[4];
+        int expectMove;          // -1: any move
+    };
+    const Position positions[] = {
+        {"win in 1", {"XXX.", "O...", "O...", "...O"}, 3},
+        {"must block", {"OOO.", "X...", "..X.", "...X"}, 3},
+        {"two threes", {"XX..", "O..X", "O..X", "OO.."}, 3},
+        {"opening", {"....", "....", "....", "...."}, -1},
+    };
+    atomic<bool> stop{false};
+    for (const Position& position : positions) {
+        QubicBoard board;
+        board.Reset();
+        for (int cell = 0; cell < 16; cell++) {
+            char mark = position.rows[cell / 4][cell % 4];
+            if (mark != '.') board.marks[mark == 'O'] |= 1ULL << cell;
+        }
+        for (int cell = 0; cell < 64; cell++) board.played += (uint8_t)(board.At(cell) >= 0);
+        board.toMove = (int8_t)(board.played & 1);
+        stop = false;
+        MnkSearchResult result = QubicSearch(board, budgetMs, stop);
+        bool ok = board.Legal(result.move) && result.ms <= budgetMs * 1.1 + 5 &&
+                  (position.expectMove < 0 || (result.move == position.expectMove && result.score > 0));
+        if (!ok) failures++;
+        printf("  search %-12s move %2d  score %11d  depth %2d  %8lld nodes  %6.1f ms  %s\n", position.name,
+               result.move, result.score, result.depth, result.nodes, result.ms, ok ? "ok" : "FAIL");
+    }
 
-                    if (CheckCollisionPointRec(mouse, btn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                        switch (i) {
-                            case 0: currentState = TICTACTOE; ticTacToe.Init(); break;
-                            case 1: currentState = SPACE_SURVIVOR; spaceSurvivor.Init(); break;
-                            case 2: currentState = BREAK_CODE; breakTheCode.Init(); break;
-                            case 3: currentState = ZOMBIE_LAND; zombieLand.Init(); break;
-                            case 4: currentState = SWAP_CARDS; swapCards.Init(); break;
-                        }
-                    }
+    // Games with a tenth of the budget per move: against a random player,
+    // taking X in half of them, then against itself after four random moves.
+    // A forced win it announces must be the way the game ends.
+    int gameMs = max(budgetMs / 10, 1);
+    for (int opponent = 0; opponent < 2; opponent++) {
+        int wins = 0, draws = 0, losses = 0, broken = 0;
+        for (int g = 0; g < games && g < 10; g++) {
+            QubicBoard board;
+            board.Reset();
+            int searcher = opponent ? 0 : g & 1, promised = -1;
+            while (board.result < 0) {
+                int move;
+                if (opponent == 0 ? board.toMove != searcher : board.played < 4) {
+                    move = list[rand() % board.Generate(list)];
+                } else {
+                    stop = false;
+                    MnkSearchResult result = QubicSearch(board, gameMs, stop);
+                    if (result.score > MNK_WIN_BOUND && promised < 0) promised = board.toMove;
+                    move = result.move;
                 }
-                break;
+                board.Play(move);
             }
-            case TICTACTOE:
-                if (ticTacToe.Update()) currentState = MENU;
-                break;
-            case SPACE_SURVIVOR:
-                if (spaceSurvivor.Update()) currentState = MENU;
-                break;
-            case BREAK_CODE:
-                if (breakTheCode.Update()) currentState = MENU;
-                break;
-            case ZOMBIE_LAND:
-                if (zombieLand.Update()) currentState = MENU;
-                break;
-            case SWAP_CARDS:
-                if (swapCards.Update()) currentState = MENU;
-                break;
+            if (promised >= 0 && board.result != promised) broken++;
+            if (board.result == 2) draws++;
+            else if (board.result == searcher) wins++;
+            else losses++;
         }
+        // Against itself the search plays both sides, so these are X's wins, draws and losses
+        bool ok = !broken && (opponent == 1 || losses == 0);
+        if (!ok) failures++;
+        printf("  %-14s %2d / %2d / %2d  %s  %d ms per move  %s\n", opponent ? "versus itself" : "versus random",
+               wins, draws, losses, opponent ? "(for X)" : "(wins / draws / losses)", gameMs, ok ? "ok" : "FAIL");
+    }
+    return failures ? 1 : 0;
+}
 
-        // Draw
-        BeginDrawing();
+// Rollback cost. First the worst case the session allows, restoring a busy
+// state and running ROLLBACK_MAX_FRAMES ticks, against the 16.7 ms frame;
+// then two sessions joined in-process through conditioned links on a virtual
+// 60 Hz clock, which must end in the state of an offline run.
+int BenchRollback(int ticks, int latencyMs, int lossPercent) {
+    VersusState busy;
+    VersusInit(busy, VERSUS_SEED);
+    while (busy.roundTicks < 5400 && busy.winner < 0) {
+        uint8_t idle[VERSUS_PLAYERS] = {0, 0};
+        busy.ships[0].alive = busy.ships[1].alive = 1;       // Keep the round going
+        VersusStep(busy, idle);
+    }
+    const int repeats = 20000;
+    double total = 0, slowest = 0;
+    VersusState work;
+    for (int i = 0; i < repeats; i++) {
+        auto start = chrono::steady_clock::now();
+        work = busy;
+        for (int t = 0; t < ROLLBACK_MAX_FRAMES; t++) {
+            uint8_t buttons[VERSUS_PLAYERS] = {NetplayBotButtons(0, t + i), NetplayBotButtons(1, t + i)};
+            VersusStep(work, buttons);
+        }
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        total += us;
+        slowest = max(slowest, us);
+    }
+    printf("rollback: restore + %d ticks with %d rocks: %.2f us mean, %.2f us max (frame is 16667 us)\n",
+           ROLLBACK_MAX_FRAMES, busy.rockCount, total / repeats, slowest);
+
+    RollbackSession sessions[VERSUS_PLAYERS];
+    NetConditioner links[VERSUS_PLAYERS];
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        sessions[p].Start(VERSUS_SEED, p);
+        links[p].Seed(99 + p);
+        links[p].latencyMs = latencyMs;
+        links[p].jitterMs = latencyMs * 0.2;
+        links[p].loss = lossPercent / 100.0f;
+    }
+    unsigned char packet[NET_PACKET_MAX];
+    double now = 0;
+    int frames = 0;
+    auto done = [&]() {
+        for (const RollbackSession& s : sessions) {
+            if (s.Tick() < (uint32_t)ticks || s.Confirmed() < (uint32_t)ticks || s.Acked() < (uint32_t)ticks) return false;
+        }
+        return true;
+    };
+    for (; !done() && frames < ticks * 20; frames++, now += 1000.0 / 60) {
+        for (int p = 0; p < VERSUS_PLAYERS; p++) {
+            RollbackSession& peer = sessions[1 - p];
+            auto deliver = [&peer](const unsigned char* data, int size) { peer.ReceivePacket(data, size); };
+            links[p].Flush(now, deliver);
+            if (sessions[p].Tick() < (uint32_t)ticks) {
+                sessions[p].Advance(NetplayBotButtons(p, sessions[p].Tick()));
+            }
+            links[p].Send(now, packet, sessions[p].BuildPacket(packet), deliver);
+        }
+    }
 
-        switch (currentState) {
-            case MENU: {
-                DrawAnimatedBackground(animTime);
-                DrawTitle(animTime);
+    VersusState reference;
+    VersusInit(reference, VERSUS_SEED);
+    while (reference.tick < (uint32_t)ticks) {
+        uint8_t buttons[VERSUS_PLAYERS] = {NetplayBotButtons(0, reference.tick), NetplayBotButtons(1, reference.tick)};
+        VersusStep(reference, buttons);
+    }
+    int failures = 0;
+    printf("  %d ticks, %d ms latency, %d%% loss, %d frames\n", ticks, latencyMs, lossPercent, frames);
+    for (int p = 0; p < VERSUS_PLAYERS; p++) {
+        sessions[p].Resolve();
+        const RollbackStats& stats = sessions[p].Stats();
+        bool same = VersusChecksum(sessions[p].State()) == VersusChecksum(reference);
+        if (!same) failures++;
+        printf("  %-4s peer %d: rollbacks %d, resimulated %d, deepest %d, slowest %.3f ms, stalls %d\n",
+               same ? "ok" : "FAIL", p + 1, stats.rollbacks, stats.resimulated, stats.deepest, stats.slowestMs,
+               stats.stalls);
+    }
+    return failures ? 1 : 0;
+}
 
-                // Draw menu buttons
-                float buttonY = 250;
-                float buttonWidth = 350;
-                float buttonHeight = 70;
-                float buttonX = (SCREEN_WIDTH - buttonWidth) / 2;
+int RunBenchmark(int argc, char** argv) {
+    string name = (argc > 2) ? argv[2] : "";
+    if (name == "tweens") {
+        int count = (argc > 3) ? atoi(argv[3]) : 10000;
+        int frames = (argc > 4) ? atoi(argv[4]) : 1000;
+        return BenchTweens(count, max(frames, 1));
+    }
+    if (name == "collision") return BenchCollision((argc > 3) ? atoi(argv[3]) : 100000);
+    if (name == "polygons") return BenchPolygons((argc > 3) ? atoi(argv[3]) : 65536);
+    if (name == "shooting") return BenchShooting(max((argc > 3) ? atoi(argv[3]) : 36000, 1));
+    if (name == "particles") {
+        int count = (argc > 3) ? atoi(argv[3]) : 50000;
+        int frames = (argc > 4) ? atoi(argv[4]) : 600;
+        return BenchParticles(count, max(frames, 1));
+    }
+    if (name == "waves") {
+        waveSchedule.Load();
+        return BenchWaves(max((argc > 3) ? (float)atof(argv[3]) : 180.0f, 1.0f));
+    }
+    if (name == "search") {
+        int budget = (argc > 3) ? atoi(argv[3]) : 1000;
+        int threads = (argc > 4) ? atoi(argv[4]) : (int)thread::hardware_concurrency();
+        return BenchSearch(max(budget, 1), min(max(threads, 1), JOB_MAX_QUEUES / 2 + 1));
+    }
+    if (name == "mcts") {
+        int games = (argc > 3) ? atoi(argv[3]) : 4;
+        int budget = (argc > 4) ? atoi(argv[4]) : 100;
+        int threads = (argc > 5) ? atoi(argv[5]) : (int)thread::hardware_concurrency();
+        return BenchMcts(max(games, 0), max(budget, 1), min(max(threads, 1), JOB_MAX_QUEUES / 2 + 1));
+    }
+    if (name == "ultimate") {
+        int games = (argc > 3) ? atoi(argv[3]) : 20000;
+        int budget = (argc > 4) ? atoi(argv[4]) : MNK_THINK_MS;
+        return BenchUltimate(max(games, 1), max(budget, 1));
+    }
+    if (name == "qubic") {
+        int games = (argc > 3) ? atoi(argv[3]) : 20000;
+        int budget = (argc > 4) ? atoi(argv[4]) : MNK_THINK_MS;
+        return BenchQubic(max(games, 1), max(budget, 1));
+    }
+    if (name == "mnk") {
+        return BenchMnk(max((argc > 3) ? atoi(argv[3]) : 2000, 1));
+    }
+    if (name == "rollback") {
+        int ticks = (argc > 3) ? atoi(argv[3]) : 3600;
+        int latency = (argc > 4) ? atoi(argv[4]) : 100;
+        int loss = (argc > 5) ? atoi(argv[5]) : 10;
+        return BenchRollback(max(ticks, 1), max(latency, 0), min(max(loss, 0), 90));
+    }
+    if (name == "jobs") {
+        int threads = (argc > 3) ? atoi(argv[3]) : (int)thread::hardware_concurrency();
+        return BenchJobs(min(max(threads, 1), JOB_MAX_QUEUES / 2 + 1));
+    }
+    if (name == "swarm") {
+        int count = (argc > 3) ? atoi(argv[3]) : SWARM_BENCH_COUNT;
+        int ticks = (argc > 4) ? atoi(argv[4]) : 120;
+        int threads = (argc > 5) ? atoi(argv[5]) : (int)thread::hardware_concurrency();
+        return BenchSwarm(count, max(ticks, 1), min(max(threads, 1), JOB_MAX_QUEUES / 2 + 1));
+    }
+    printf("Usage: %s --bench <tweens [count] [frames] | collision [rocks] | polygons [rocks] | shooting [ticks] | "
+           "particles [count] [frames] | waves [seconds] | mnk [games] | search [ms] [threads] | mcts [games] [ms] [threads] | ultimate [games] [ms] | qubic [games] [ms] | rollback [ticks] [latency ms] [loss %%] | jobs [threads] | swarm [rocks] [ticks] [threads]>\n", argv[0]);
+    return 1;
+}
 
-                for (int i = 0; i < 5; i++) {
-                    Rectangle btn = {buttonX, buttonY + i * 80, buttonWidth, buttonHeight};
-                    Vector2 mouse = GetMousePosition();
-                    bool hover = CheckCollisionPointRec(mouse, btn);
+// Main function
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--screenshot") == 0) return RunHeadless(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) return RunBenchmark(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--versus") == 0) return RunVersus(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--netplay-test") == 0) return RunNetplayTest(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--netplay-peer") == 0) return RunNetplayPeer(argc, argv);
+    int targetHz = 60;
+    int backgroundCount = BACKGROUND_PARTICLES;
+    bool threaded = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--low-latency") == 0) framePacer.lowLatency = true;
+        if (strcmp(argv[i], "--single-thread") == 0) threaded = false;
+        if (i + 1 >= argc) continue;
+        if (strcmp(argv[i], "--fps") == 0) targetHz = max(1, atoi(argv[i + 1]));
+        if (strcmp(argv[i], "--bg-particles") == 0) {
+            backgroundCount = min(max(atoi(argv[i + 1]), 0), MAX_BACKGROUND_PARTICLES);
+        }
+        if (strcmp(argv[i], "--ai-ms") == 0) mnkThinkMs = max(1, atoi(argv[i + 1]));
+        if (strcmp(argv[i], "--frame-stats") == 0 && !renderStats.OpenStream(argv[i + 1])) {
+            printf("Could not open %s for frame statistics\n", argv[i + 1]);
+        }
+    }
 
-                    Color bgColor = hover ? buttons[i].color : Colors::CARD_BG;
-                    DrawRectangleRounded(btn, 0.2f, 8, bgColor);
-                    DrawRectangleRoundedLines(btn, 0.2f, 8, 2, buttons[i].color);
+    // Initialize
+    srand(time(0));
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "GAMING HUB - Professional C++ Arcade");
+    SetTargetFPS(0);                 // Pacing is done by framePacer
+    rlRenderBatch statsBatch = rlLoadRenderBatch(RL_DEFAULT_BATCH_BUFFERS, RL_DEFAULT_BATCH_BUFFER_ELEMENTS);
+    renderStats.Attach(&statsBatch);
+    framePacer.SetTarget(targetHz);
+    jobs.Start();
+    searchJobs.Start();
+    waveSchedule.Load();
+    uiFont.Load();
+    starfield.Load();
+    spriteAtlas.Bake();
+    backgroundParticles.Init(backgroundCount);
+    backgroundParticles.Load();
+    particles.Load();
+    dynamicResolution.Load();
+
+    // The simulation runs on its own thread unless --single-thread is given;
+    // the main thread owns the window, polls input and renders snapshots
+    SimulationThread simulation;
+    World localWorld;
+    float simulationLag = 0;
+    if (threaded) simulation.Start();
 
-                    int textWidth = MeasureText(buttons[i].title, 28);
-                    DrawText(buttons[i].title, btn.x + (btn.width - textWidth)/2, btn.y + 12, 28, WHITE);
+    // Main game loop
+    while (!WindowShouldClose()) {
+        float frameTime = framePacer.lowLatency ? framePacer.FrameTime() : GetFrameTime();
+        backgroundParticles.Update(frameTime);
+        particles.Update(frameTime);
+
+        // Without the thread the World still steps at SIMULATION_HZ, so --fps
+        // changes how often it is drawn but not how fast the game runs
+        if (!threaded) {
+            simulationLag = min(simulationLag + frameTime, 4.0f / SIMULATION_HZ);
+            simulationStep = 1.0f / SIMULATION_HZ;
+            while (simulationLag >= simulationStep) {
+                simulation.input.Drain(gameInput);
+                localWorld.Update();
+                simulationLag -= simulationStep;
+            }
+            simulationStep = 0;
+        }
+        World& view = threaded ? simulation.Latest() : localWorld;
+        GameState currentState = view.state;
 
-                    int descWidth = MeasureText(buttons[i].description, 14);
-                    DrawText(buttons[i].description, btn.x + (btn.width - descWidth)/2, btn.y + 45, 14,
-                            hover ? WHITE : Colors::TEXT_DIM);
-                }
+        if (IsKeyPressed(KEY_F3)) renderStats.overlayVisible = !renderStats.overlayVisible;
+        if (IsKeyPressed(KEY_F4)) dynamicResolution.enabled = !dynamicResolution.enabled;
+        if (IsKeyPressed(KEY_F5)) framePacer.lowLatency = !framePacer.lowLatency;
 
-                // Footer
-                DrawTextCentered("Click a game to start | Press ESC to exit", SCREEN_HEIGHT - 40, 16, Colors::TEXT_DIM);
-                break;
-            }
-            case TICTACTOE: ticTacToe.Draw(); break;
-            case SPACE_SURVIVOR: spaceSurvivor.Draw(); break;
-            case BREAK_CODE: breakTheCode.Draw(); break;
-            case ZOMBIE_LAND: zombieLand.Draw(); break;
-            case SWAP_CARDS: swapCards.Draw(); break;
+        // Draw
+        BeginDrawing();
+        auto drawStart = chrono::steady_clock::now();
+        if (currentState != MENU) renderStats.GameDraw();
+        dynamicResolution.BeginScene();
+
+        view.Draw();
+
+        dynamicResolution.EndScene();
+        if (renderStats.overlayVisible) DrawStatsOverlay(currentState, threaded ? simulation.TickMs() : -1);
+        uiFont.EndBatch();
+        auto drawEnd = chrono::steady_clock::now();
+        renderStats.EndFrame(currentState, chrono::duration<float, milli>(drawEnd - drawStart).count());
+
+        if (framePacer.lowLatency) {
+            // EndDrawing() would poll input right after the swap, a whole
+            // frame before the next Update(). Present, wait for the deadline,
+            // then poll, so the next step reads the freshest input. raylib's
+            // F12 screenshot and frame counter are skipped in this mode.
+            rlDrawRenderBatchActive();
+            SwapScreenBuffer();
+            framePacer.Wait();
+            PollInputEvents();
+            simulation.input.Collect();
+        } else {
+            EndDrawing();
+            simulation.input.Collect();
+            framePacer.Wait();
         }
 
-        EndDrawing();
+        dynamicResolution.Update(framePacer.Budget());
     }
 
+    simulation.Stop();
+    chunkStreamer.Stop();
+    mnkAi.Cancel();
+    searchJobs.Stop();
+    jobs.Stop();
+    uiFont.Unload();
+    spriteAtlas.Unload();
+    starfield.Unload();
+    backgroundParticles.Unload();
+    particles.Unload();
+    dynamicResolution.Unload();
+    renderStats.Attach(nullptr);
+    rlUnloadRenderBatch(statsBatch);
     CloseWindow();
     return 0;
 }
\ No newline at end of file
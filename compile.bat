@@ -31,7 +31,7 @@ echo.
 echo Compiling GamingHub.cpp...
 echo.
 
-g++ -o GamingHub.exe GamingHub.cpp -I "%RAYLIB_PATH%\include" -L "%RAYLIB_PATH%\lib" -lraylib -lopengl32 -lgdi32 -lwinmm -mwindows
+g++ -o GamingHub.exe GamingHub.cpp -I "%RAYLIB_PATH%\include" -L "%RAYLIB_PATH%\lib" -lraylib -lopengl32 -lgdi32 -lwinmm -lws2_32 -mwindows
 
 if %errorlevel%==0 (
     echo.